@@ -0,0 +1,58 @@
+/**
+ * \file  microstructure/lib/solver/include/solver/banded.hpp
+ * \brief Batched Tridiagonal and Pentadiagonal Solvers on Interleaved Storage
+ */
+
+#ifndef __MICROSTRUCTURE_LIBRARIES_SOLVER_BANDED_HPP__
+#define __MICROSTRUCTURE_LIBRARIES_SOLVER_BANDED_HPP__
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+    /**
+     * \brief Interleaved Batches: Row i of System s is Entry [i * systems + s]
+     * \note  Each elimination step is then one unit-stride loop over the
+     *        systems, which the compiler vectorises, so SIMD lanes solve
+     *        different systems. Lines along the first axis of a row-major
+     *        lattice are already in this layout (systems = the product of
+     *        the other extents); other lines go through interleave
+     * \note  Systems are split among threads in contiguous ranges and
+     *        swept in cache-sized blocks. No pivoting: the matrices must
+     *        be diagonally dominant or otherwise safe for elimination, as
+     *        the implicit diffusion operators of ADI schemes are
+     * \note  Band entries outside the matrix (lower [0], upper [n - 1], ...)
+     *        are ignored; io_rhs is overwritten with the solutions
+     */
+
+    /** \brief Thomas Algorithm, 8n Flops per System */
+    void tridiagonal_thomas ( std::span<double const> i_lower, std::span<double const> i_diagonal, std::span<double const> i_upper, std::span<double> io_rhs, std::size_t i_rows, std::size_t i_systems, std::size_t i_threads = 0 );
+
+    /**
+     * \brief Cyclic Reduction: log2 n Levels of Independent Row Updates
+     * \note  About twice the flops of Thomas, but the dependency chain is
+     *        2 log2 n levels instead of 2n rows, and it needs no scratch
+     *        beyond a copy of the bands
+     */
+
+    void tridiagonal_cyclic_reduction ( std::span<double const> i_lower, std::span<double const> i_diagonal, std::span<double const> i_upper, std::span<double> io_rhs, std::size_t i_rows, std::size_t i_systems, std::size_t i_threads = 0 );
+
+    /** \brief Band Elimination to Unit Upper Form, Bands at Offsets -2 to +2 */
+    void pentadiagonal_thomas ( std::span<double const> i_lower2, std::span<double const> i_lower, std::span<double const> i_diagonal, std::span<double const> i_upper, std::span<double const> i_upper2, std::span<double> io_rhs, std::size_t i_rows, std::size_t i_systems, std::size_t i_threads = 0 );
+
+    /** \brief System-Major (Row i of System s at [s * rows + i]) to Interleaved */
+    void interleave ( std::span<double const> i_lines, std::span<double> o_batch, std::size_t i_rows, std::size_t i_systems );
+
+    /** \brief Interleaved to System-Major */
+    void deinterleave ( std::span<double const> i_batch, std::span<double> o_lines, std::size_t i_rows, std::size_t i_systems );
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
+
+#endif // !__MICROSTRUCTURE_LIBRARIES_SOLVER_BANDED_HPP__
@@ -0,0 +1,125 @@
+/**
+ * \file  microstructure/lib/solver/include/solver/fourier.hpp
+ * \brief Mixed-Radix Fast Fourier Transforms with a Plan Cache
+ */
+
+#ifndef __MICROSTRUCTURE_LIBRARIES_SOLVER_FOURIER_HPP__
+#define __MICROSTRUCTURE_LIBRARIES_SOLVER_FOURIER_HPP__
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+    using complex = std::complex<double>;
+
+    /**
+     * \brief Sign of the Exponent: forward e^(-2 pi i jk / n), backward e^(+...)
+     * \note  Neither direction normalises; backward ( forward ( x ) ) = n x
+     */
+
+    enum class direction : int { forward = -1, backward = 1 };
+
+    /**
+     * \class fourier_plan
+     * \brief One-Dimensional Complex Transform of a Fixed Length and Stride
+     * \note  Self-sorting (Stockham) mixed radix: radix 4, 2, 3 and 5
+     *        butterflies, a direct butterfly for any other prime factor
+     * \note  Twiddles and the roots of the direct butterflies are computed
+     *        with the plan; a transform allocates nothing once the scratch of
+     *        the calling thread has grown to the plan
+     * \note  lanes lines are transformed at once in split real/imaginary
+     *        buffers, element-major, so every butterfly is a unit-stride loop
+     *        over lanes that the compiler vectorises; gathering lanes that are
+     *        rows of a matrix is a tile transpose
+     */
+
+    class fourier_plan {
+
+    public:
+
+        static constexpr std::size_t lanes = 8;
+
+        fourier_plan ( std::size_t i_length, std::size_t i_stride, direction i_direction );
+
+        /**
+         * \brief Transform i_lines Lines in Place; Line l Starts at
+         *        io_data + l * i_distance, its Elements i_stride apart
+         */
+
+        void execute ( complex* io_data, std::size_t i_lines, std::size_t i_distance ) const;
+
+        std::size_t length () const { return m_length; }
+        std::size_t stride () const { return m_stride; }
+        direction sense () const { return m_direction; }
+
+    private:
+
+        /**
+         * \brief Stages on lanes Lines; returns true if the Result is in o_re, o_im
+         * \param o_scratch 2 widest lanes values for the direct butterflies
+         */
+
+        bool transform ( double* io_re, double* io_im, double* o_re, double* o_im, double* o_scratch ) const;
+
+        std::size_t m_length;
+        std::size_t m_stride;
+        direction m_direction;
+        std::vector<std::size_t> m_radix;
+        std::vector<std::size_t> m_offset;
+        std::vector<double> m_cos;
+        std::vector<double> m_sin;
+        std::vector<std::size_t> m_root;
+        std::vector<double> m_unit_cos;
+        std::vector<double> m_unit_sin;
+        std::size_t m_widest = 0;
+    };
+
+    /**
+     * \brief Shared Plan for (Length, Stride, Direction), Built on First Use
+     * \note  The cache is guarded by a mutex and holds plans until cleared;
+     *        callers keep their plan alive through the shared pointer
+     */
+
+    std::shared_ptr<fourier_plan const> plan ( std::size_t i_length, std::size_t i_stride, direction i_direction );
+
+    std::size_t cached_plans ();
+
+    void clear_plans ();
+
+    /**
+     * \brief In-Place Complex Transform of a Row-Major (Last Axis Contiguous)
+     *        Array of 1, 2 or 3 Dimensions
+     * \param i_threads threads to share the lines of each axis, 0 for all;
+     *        they come from a worker_pool per thread count, kept for the
+     *        process, so repeated transforms start no threads
+     */
+
+    void fft ( std::span<complex> io_data, std::span<std::size_t const> i_shape, direction i_direction, std::size_t i_threads = 0 );
+
+    /**
+     * \brief Real-to-Complex Forward Transform: o_data holds the half spectrum
+     *        of shape (..., n_last / 2 + 1)
+     */
+
+    void rfft ( std::span<double const> i_data, std::span<complex> o_data, std::span<std::size_t const> i_shape, std::size_t i_threads = 0 );
+
+    /**
+     * \brief Complex-to-Real Backward Transform of a Half Spectrum (Overwritten)
+     * \note  Unnormalised: irfft ( rfft ( x ) ) = N x
+     */
+
+    void irfft ( std::span<complex> io_data, std::span<double> o_data, std::span<std::size_t const> i_shape, std::size_t i_threads = 0 );
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
+
+#endif // !__MICROSTRUCTURE_LIBRARIES_SOLVER_FOURIER_HPP__
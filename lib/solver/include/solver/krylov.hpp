@@ -0,0 +1,157 @@
+/**
+ * \file  microstructure/lib/solver/include/solver/krylov.hpp
+ * \brief Preconditioned Krylov Solvers on Assembled or Matrix-Free Operators
+ */
+
+#ifndef __MICROSTRUCTURE_LIBRARIES_SOLVER_KRYLOV_HPP__
+#define __MICROSTRUCTURE_LIBRARIES_SOLVER_KRYLOV_HPP__
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "multigrid.hpp"
+#include "sparse.hpp"
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+    /**
+     * \brief o_y = A i_x for a Matrix-Free Operator, or z = M^-1 r for a
+     *        Preconditioner; an empty function is the identity
+     */
+
+    using linear_operator = std::function<void ( std::span<double const> i_x, std::span<double> o_y )>;
+
+    /** \brief Anything with multiply ( x, y ): csr_matrix, sell_matrix, bcsr_matrix */
+    template <class MatrixT>
+    concept assembled_matrix = requires ( MatrixT const& a, std::span<double const> x, std::span<double> y ) {
+        a.multiply ( x, y );
+    };
+
+    struct krylov_report {
+        std::size_t iterations = 0;
+        double residual        = 0.;
+        bool converged         = false;
+    };
+
+    /**
+     * \brief Stopping Rule and Threads of the Vector Kernels
+     * \note  Convergence is |b - A x| <= tolerance |b|. The vector kernels
+     *        run on a worker_pool kept for the whole solve; vectors shorter
+     *        than parallel_length are updated on the calling thread, where
+     *        waking the workers would cost more than the pass itself
+     */
+
+    struct krylov_settings {
+        double tolerance            = 1e-10;
+        std::size_t iterations      = 1000;
+        std::size_t restart         = 30;
+        std::size_t threads         = 0;
+        std::size_t parallel_length = 1 << 13;
+    };
+
+    // ================================================================
+
+    /** \brief Diagonal Scaling z = D^-1 r */
+    class jacobi_preconditioner {
+
+    public:
+
+        explicit jacobi_preconditioner ( csr_matrix const& i_a );
+        explicit jacobi_preconditioner ( std::span<double const> i_diagonal );
+
+        void operator() ( std::span<double const> i_r, std::span<double> o_z ) const;
+
+    private:
+
+        std::vector<double> m_inverse;
+    };
+
+    /**
+     * \brief Incomplete LU without Fill: L U = A on the Pattern of A
+     * \note  The triangular solves are sequential; the preconditioner pays
+     *        off where it saves iterations, not per application
+     */
+
+    class ilu0_preconditioner {
+
+    public:
+
+        explicit ilu0_preconditioner ( csr_matrix const& i_a );
+
+        void operator() ( std::span<double const> i_r, std::span<double> o_z ) const;
+
+    private:
+
+        std::vector<std::size_t> m_offset;
+        std::vector<std::size_t> m_index;
+        std::vector<std::size_t> m_diagonal;
+        std::vector<double> m_value;
+    };
+
+    /**
+     * \brief i_cycles Multigrid Cycles on A z = r from z = 0
+     * \note  Boundary entries of z stay zero, so pose the Krylov problem for
+     *        a correction with homogeneous Dirichlet values (identity rows
+     *        on the boundary). The multigrid is shared, not copied
+     */
+
+    class multigrid_preconditioner {
+
+    public:
+
+        explicit multigrid_preconditioner ( multigrid& i_multigrid, std::size_t i_cycles = 1 );
+
+        void operator() ( std::span<double const> i_r, std::span<double> o_z ) const;
+
+    private:
+
+        multigrid* m_multigrid;
+        std::size_t m_cycles;
+    };
+
+    // ================================================================
+
+    /**
+     * \brief Preconditioned Conjugate Gradients for Symmetric Positive
+     *        Definite A (and M)
+     * \note  The x and r updates and |r|^2 share one pass over memory
+     */
+
+    krylov_report conjugate_gradient ( linear_operator const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner = {}, krylov_settings const& i_settings = {} );
+
+    /** \brief Right-Preconditioned BiCGStab for General Nonsingular A */
+    krylov_report bicgstab ( linear_operator const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner = {}, krylov_settings const& i_settings = {} );
+
+    /**
+     * \brief Right-Preconditioned GMRES ( restart ) with Modified Gram-Schmidt
+     *        and Givens Rotations
+     */
+
+    krylov_report gmres ( linear_operator const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner = {}, krylov_settings const& i_settings = {} );
+
+    template <assembled_matrix MatrixT>
+    krylov_report conjugate_gradient ( MatrixT const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner = {}, krylov_settings const& i_settings = {} ) {
+        return conjugate_gradient ( linear_operator { [ &i_a ] ( std::span<double const> x, std::span<double> y ) { i_a.multiply ( x, y ); } }, i_b, io_x, i_preconditioner, i_settings );
+    }
+
+    template <assembled_matrix MatrixT>
+    krylov_report bicgstab ( MatrixT const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner = {}, krylov_settings const& i_settings = {} ) {
+        return bicgstab ( linear_operator { [ &i_a ] ( std::span<double const> x, std::span<double> y ) { i_a.multiply ( x, y ); } }, i_b, io_x, i_preconditioner, i_settings );
+    }
+
+    template <assembled_matrix MatrixT>
+    krylov_report gmres ( MatrixT const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner = {}, krylov_settings const& i_settings = {} ) {
+        return gmres ( linear_operator { [ &i_a ] ( std::span<double const> x, std::span<double> y ) { i_a.multiply ( x, y ); } }, i_b, io_x, i_preconditioner, i_settings );
+    }
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
+
+#endif // !__MICROSTRUCTURE_LIBRARIES_SOLVER_KRYLOV_HPP__
@@ -0,0 +1,138 @@
+/**
+ * \file  microstructure/lib/solver/include/solver/multigrid.hpp
+ * \brief Geometric Multigrid for Poisson and Helmholtz Problems on Lattices
+ */
+
+#ifndef __MICROSTRUCTURE_LIBRARIES_SOLVER_MULTIGRID_HPP__
+#define __MICROSTRUCTURE_LIBRARIES_SOLVER_MULTIGRID_HPP__
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+    /** \brief Recursive Calls per Level: V (1) or W (2) */
+    enum class cycle_shape : std::size_t { v = 1, w = 2 };
+
+    struct multigrid_report {
+        std::size_t cycles = 0;
+        double residual    = 0.;
+        bool converged     = false;
+    };
+
+    /**
+     * \class multigrid
+     * \brief Solves -lap u + alpha u = f on a Vertex-Centred Lattice
+     * \note  Row-major arrays of 1, 2 or 3 dimensions (last axis contiguous),
+     *        spacing h on every axis. Boundary nodes hold Dirichlet values and
+     *        are never modified; interior nodes are the unknowns
+     * \note  Red-black Gauss-Seidel smoothing, (bi/tri)linear prolongation and
+     *        its scaled transpose as restriction (full weighting where the
+     *        spacing doubles). Every axis of n >= 5 nodes is coarsened to
+     *        ceil((n - 1) / 2) cells over the same length: extents 2^k c + 1
+     *        nest exactly, any other extent gets coarse nodes between the fine
+     *        ones and a spacing of its own, so every extent has a full
+     *        hierarchy. The coarsest level, at most 3 unknowns per axis, is
+     *        solved exactly with a Cholesky factor computed once
+     * \note  Lines of one colour are shared among the threads of a
+     *        worker_pool kept with the hierarchy; levels with few points run
+     *        on the calling thread. The result does not depend on the thread
+     *        count
+     */
+
+    class multigrid {
+
+    public:
+
+        multigrid ( std::span<std::size_t const> i_shape, double i_spacing, double i_shift = 0., std::size_t i_threads = 0 );
+
+        /** \brief Cycles until |f - A u| <= i_tolerance |f| (interior L2 norms) */
+        multigrid_report solve ( std::span<double> io_u, std::span<double const> i_f, double i_tolerance = 1e-10, std::size_t i_cycles = 100 );
+
+        void cycle ( std::span<double> io_u, std::span<double const> i_f );
+
+        /** \brief Interior L2 Norm of f - A u */
+        double residual ( std::span<double const> i_u, std::span<double const> i_f ) const;
+
+        void shape ( cycle_shape i_shape ) { m_shape = i_shape; }
+        void smoothing ( std::size_t i_pre, std::size_t i_post );
+
+        std::size_t levels () const { return m_level.size (); }
+        std::size_t size () const { return m_level.front ().size; }
+
+    private:
+
+        /**
+         * \brief Linear Interpolation along one Axis to the next Coarser Level
+         * \note  Fine node i lies between coarse nodes below [i] and
+         *        below [i] + 1, the latter with weight above [i]. Coarse node
+         *        j gathers the fine nodes fine [k], k in [start [j],
+         *        start [j + 1]), with the restriction weights share [k]
+         */
+
+        struct axis_map {
+            std::vector<std::size_t> below;
+            std::vector<double> above;
+            std::vector<std::size_t> start;
+            std::vector<std::size_t> fine;
+            std::vector<double> share;
+        };
+
+        /** \brief Axes padded to three at the front; extent 1 marks an unused axis */
+        struct level {
+            std::array<std::size_t, 3> extent;
+            std::array<std::size_t, 3> stride;
+            std::size_t size;
+            std::array<double, 3> spacing;
+            std::array<axis_map, 3> map;
+            std::vector<double> u;
+            std::vector<double> f;
+            std::vector<double> r;
+        };
+
+        /** \brief Interpolation from n Fine to m Coarse Nodes; the Identity if m == n */
+        static axis_map couple ( std::size_t i_fine, std::size_t i_coarse );
+
+        void recurse ( std::size_t i_level, double* io_u, double const* i_f );
+        void smooth ( level const& i_level, double* io_u, double const* i_f, std::size_t i_sweeps ) const;
+        void defect ( level const& i_level, double const* i_u, double const* i_f, double* o_r ) const;
+
+        /** \brief Sum of Squares of f - A u per Interior Line of the Finest Level, then in Line Order */
+        double defect_norm ( double const* i_u, double const* i_f ) const;
+        void restriction ( level const& i_fine, double const* i_r, level& o_coarse ) const;
+        void prolongation ( level const& i_coarse, level const& i_fine, double* io_u ) const;
+
+        /** \brief Cholesky Factor of the Coarsest Interior Operator */
+        void factorise ();
+
+        /** \brief Exact Solve on the Coarsest Level: u += A^-1 (f - A u) */
+        void direct ( level& io_level, double* io_u, double const* i_f );
+
+        std::vector<level> m_level;
+        std::size_t m_dimension;
+        double m_shift;
+        std::size_t m_threads;
+        cycle_shape m_shape = cycle_shape::v;
+        std::size_t m_pre   = 2;
+        std::size_t m_post  = 2;
+        std::vector<std::size_t> m_unknown;
+        std::vector<double> m_factor;
+        std::vector<double> m_rhs;
+        std::unique_ptr<worker_pool> m_pool;
+        mutable std::vector<double> m_line;
+    };
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
+
+#endif // !__MICROSTRUCTURE_LIBRARIES_SOLVER_MULTIGRID_HPP__
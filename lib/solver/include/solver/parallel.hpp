@@ -0,0 +1,119 @@
+/**
+ * \file  microstructure/lib/solver/include/solver/parallel.hpp
+ * \brief Static Work Partitioning over Threads and a Pinned Worker Pool
+ */
+
+#ifndef __MICROSTRUCTURE_LIBRARIES_SOLVER_PARALLEL_HPP__
+#define __MICROSTRUCTURE_LIBRARIES_SOLVER_PARALLEL_HPP__
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+    /**
+     * \brief Threads to use: i_threads, or the hardware count when 0
+     */
+
+    inline std::size_t concurrency ( std::size_t i_threads ) {
+        if ( i_threads > 0 )
+            return i_threads;
+        return std::max<std::size_t> ( 1, std::thread::hardware_concurrency () );
+    }
+
+    /**
+     * \brief Invoke i_function ( thread, begin, end ) on Contiguous Chunks of
+     *        [0, i_count); the calling thread runs chunk 0
+     * \note  Chunks are fixed by (i_count, i_threads), but every call starts
+     *        fresh, unpinned threads; data that must stay on one NUMA node
+     *        across calls belongs to a worker_pool
+     */
+
+    template <class FunctionT>
+    void parallel_for ( std::size_t i_count, std::size_t i_threads, FunctionT&& i_function ) {
+        std::size_t const threads = std::max<std::size_t> ( 1, std::min ( concurrency ( i_threads ), i_count ) );
+        if ( threads == 1 ) {
+            i_function ( std::size_t { 0 }, std::size_t { 0 }, i_count );
+            return;
+        }
+
+        std::size_t const chunk = ( i_count + threads - 1 ) / threads;
+
+        std::vector<std::jthread> worker;
+        worker.reserve ( threads - 1 );
+        for ( std::size_t t = 1; t < threads; ++t ) {
+            std::size_t const begin = std::min ( t * chunk, i_count );
+            std::size_t const end   = std::min ( begin + chunk, i_count );
+            worker.emplace_back ( [ &i_function, t, begin, end ] { i_function ( t, begin, end ); } );
+        }
+        i_function ( std::size_t { 0 }, std::size_t { 0 }, std::min ( chunk, i_count ) );
+    }
+
+    /**
+     * \class worker_pool
+     * \brief Persistent Threads, each Pinned to one CPU, that Run One Task at
+     *        a Time
+     * \note  Worker t is bound to the (t mod count)-th CPU the process may
+     *        run on, and run ( f ) calls f ( t ) on worker t, so a range
+     *        written (first touched) by worker t from one call is read from
+     *        the same CPU, and thus the same NUMA node, on every later call.
+     *        A pool of one runs f ( 0 ) on the caller
+     * \note  Calls from several threads are serialised; f must not call run
+     *        on the same pool
+     */
+
+    class worker_pool {
+
+    public:
+
+        explicit worker_pool ( std::size_t i_threads = 0 );
+        ~worker_pool ();
+
+        worker_pool ( worker_pool const& ) = delete;
+        worker_pool& operator= ( worker_pool const& ) = delete;
+
+        template <class FunctionT>
+        void run ( FunctionT&& i_function ) const {
+            if ( m_size == 1 ) {
+                i_function ( std::size_t { 0 } );
+                return;
+            }
+            dispatch ( [] ( void const* i_context, std::size_t i_worker ) { ( *static_cast<std::remove_reference_t<FunctionT> const*> ( i_context ) ) ( i_worker ); }, &i_function );
+        }
+
+        std::size_t size () const { return m_size; }
+
+    private:
+
+        using task_type = void ( * ) ( void const*, std::size_t );
+
+        void dispatch ( task_type i_task, void const* i_context ) const;
+        void work ( std::size_t i_worker );
+
+        std::size_t m_size;
+        mutable std::mutex m_call;
+        mutable std::mutex m_mutex;
+        mutable std::condition_variable m_wake;
+        mutable std::condition_variable m_done;
+        mutable task_type m_task         = nullptr;
+        mutable void const* m_context    = nullptr;
+        mutable std::size_t m_pending    = 0;
+        mutable std::size_t m_generation = 0;
+        bool m_stop                      = false;
+        std::vector<std::jthread> m_worker; // last, so it joins before the rest goes
+    };
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
+
+#endif // !__MICROSTRUCTURE_LIBRARIES_SOLVER_PARALLEL_HPP__
@@ -11,6 +11,12 @@
 
 // local headers
 #include "version.hpp"
+#include "parallel.hpp"
+#include "fourier.hpp"
+#include "multigrid.hpp"
+#include "sparse.hpp"
+#include "krylov.hpp"
+#include "banded.hpp"
 
 namespace microstructure {
 namespace libraries {
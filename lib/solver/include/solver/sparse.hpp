@@ -0,0 +1,207 @@
+/**
+ * \file  microstructure/lib/solver/include/solver/sparse.hpp
+ * \brief Sparse Matrix Storage (CSR, SELL-C-sigma, BCSR) and Multithreaded SpMV
+ */
+
+#ifndef __MICROSTRUCTURE_LIBRARIES_SOLVER_SPARSE_HPP__
+#define __MICROSTRUCTURE_LIBRARIES_SOLVER_SPARSE_HPP__
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+    /**
+     * \class coordinate_matrix
+     * \brief Assembly Buffer of (Row, Column, Value) Entries in any Order
+     * \note  Repeated positions are summed when converted, so element
+     *        contributions can be added without lookup
+     */
+
+    class coordinate_matrix {
+
+    public:
+
+        coordinate_matrix ( std::size_t i_rows, std::size_t i_columns );
+
+        void reserve ( std::size_t i_entries );
+        void add ( std::size_t i_row, std::size_t i_column, double i_value );
+        void clear ();
+
+        std::size_t rows () const { return m_rows; }
+        std::size_t columns () const { return m_columns; }
+        std::size_t entries () const { return m_value.size (); }
+
+        std::span<std::size_t const> row_indices () const { return m_row; }
+        std::span<std::size_t const> column_indices () const { return m_column; }
+        std::span<double const> values () const { return m_value; }
+
+    private:
+
+        std::size_t m_rows;
+        std::size_t m_columns;
+        std::vector<std::size_t> m_row;
+        std::vector<std::size_t> m_column;
+        std::vector<double> m_value;
+    };
+
+    /**
+     * \class numa_array
+     * \brief Fixed-Size Array Left Uninitialised on Allocation
+     * \note  The matrices below write each share from the pinned worker that
+     *        multiplies it (first touch), so its pages land on that worker's
+     *        NUMA node and SpMV streams local memory
+     */
+
+    template <class T>
+    class numa_array {
+
+    public:
+
+        numa_array () = default;
+        explicit numa_array ( std::size_t i_size ) : m_data { std::make_unique_for_overwrite<T[]> ( i_size ) }, m_size { i_size } {}
+
+        T* data () { return m_data.get (); }
+        T const* data () const { return m_data.get (); }
+        std::size_t size () const { return m_size; }
+
+        T& operator[] ( std::size_t i ) { return m_data [ i ]; }
+        T const& operator[] ( std::size_t i ) const { return m_data [ i ]; }
+
+        operator std::span<T const> () const { return { m_data.get (), m_size }; }
+
+    private:
+
+        std::unique_ptr<T[]> m_data;
+        std::size_t m_size = 0;
+    };
+
+    /**
+     * \class csr_matrix
+     * \brief Compressed Sparse Rows with Sorted, Unique Columns per Row
+     * \note  Rows are split among threads into ranges of equal nonzero count;
+     *        the split and a worker_pool are fixed at construction, and range t
+     *        is written and multiplied by worker t only
+     */
+
+    class csr_matrix {
+
+    public:
+
+        explicit csr_matrix ( coordinate_matrix const& i_assembly, std::size_t i_threads = 0 );
+
+        /** \brief o_y = A i_x */
+        void multiply ( std::span<double const> i_x, std::span<double> o_y ) const;
+
+        void diagonal ( std::span<double> o_diagonal ) const;
+
+        std::size_t rows () const { return m_rows; }
+        std::size_t columns () const { return m_columns; }
+        std::size_t nonzeros () const { return m_value.size (); }
+        std::size_t threads () const { return m_partition.size () - 1; }
+
+        std::span<std::size_t const> offsets () const { return m_offset; }
+        std::span<std::size_t const> indices () const { return m_index; }
+        std::span<double const> values () const { return m_value; }
+
+    private:
+
+        std::size_t m_rows;
+        std::size_t m_columns;
+        std::vector<std::size_t> m_partition;
+        std::unique_ptr<worker_pool> m_pool;
+        numa_array<std::size_t> m_offset;
+        numa_array<std::size_t> m_index;
+        numa_array<double> m_value;
+    };
+
+    /**
+     * \class sell_matrix
+     * \brief SELL-C-sigma: Rows Sorted by Length within Windows of sigma,
+     *        Packed in Chunks of C Rows Stored Column by Column
+     * \note  Lane q of a chunk is one row, so the inner loop runs over C
+     *        independent rows at unit stride and vectorises; sorting keeps the
+     *        zero padding of each chunk small (see fill)
+     */
+
+    class sell_matrix {
+
+    public:
+
+        static constexpr std::size_t chunk = 8;
+
+        /** \param i_sigma sorting window in rows, rounded up to a multiple of chunk */
+        explicit sell_matrix ( coordinate_matrix const& i_assembly, std::size_t i_sigma = 256, std::size_t i_threads = 0 );
+
+        void multiply ( std::span<double const> i_x, std::span<double> o_y ) const;
+
+        std::size_t rows () const { return m_rows; }
+        std::size_t columns () const { return m_columns; }
+        std::size_t nonzeros () const { return m_nonzeros; }
+        std::size_t threads () const { return m_partition.size () - 1; }
+
+        /** \brief Nonzeros over Stored Entries, 1 without Padding */
+        double fill () const;
+
+    private:
+
+        std::size_t m_rows;
+        std::size_t m_columns;
+        std::size_t m_nonzeros;
+        std::vector<std::size_t> m_partition;
+        std::unique_ptr<worker_pool> m_pool;
+        numa_array<std::size_t> m_permutation;
+        numa_array<std::size_t> m_offset;
+        numa_array<std::size_t> m_length;
+        numa_array<std::size_t> m_index;
+        numa_array<double> m_value;
+    };
+
+    /**
+     * \class bcsr_matrix
+     * \brief Block CSR of Dense b x b Blocks (Row-Major), for Systems with b
+     *        Coupled Unknowns per Node
+     * \note  One column index per block instead of b^2; block sizes 1 to 4
+     *        use unrolled kernels
+     */
+
+    class bcsr_matrix {
+
+    public:
+
+        /** \param i_block b; rows and columns must be multiples of it */
+        bcsr_matrix ( coordinate_matrix const& i_assembly, std::size_t i_block, std::size_t i_threads = 0 );
+
+        void multiply ( std::span<double const> i_x, std::span<double> o_y ) const;
+
+        std::size_t rows () const { return m_rows; }
+        std::size_t columns () const { return m_columns; }
+        std::size_t block () const { return m_block; }
+        std::size_t blocks () const { return m_index.size (); }
+        std::size_t threads () const { return m_partition.size () - 1; }
+
+    private:
+
+        std::size_t m_rows;
+        std::size_t m_columns;
+        std::size_t m_block;
+        std::vector<std::size_t> m_partition;
+        std::unique_ptr<worker_pool> m_pool;
+        numa_array<std::size_t> m_offset;
+        numa_array<std::size_t> m_index;
+        numa_array<double> m_value;
+    };
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
+
+#endif // !__MICROSTRUCTURE_LIBRARIES_SOLVER_SPARSE_HPP__
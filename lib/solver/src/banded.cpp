@@ -0,0 +1,205 @@
+/**
+ * \file  microstructure/lib/solver/src/banded.cpp
+ * \brief Batched Tridiagonal and Pentadiagonal Solvers on Interleaved Storage
+ */
+
+#include "banded.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+namespace {
+
+    /** \brief Systems per Sweep: one Row of a Band Fills a Few Cache Lines */
+    constexpr std::size_t block = 64;
+
+    /**
+     * \brief i_function ( first, width, scratch ) on Blocks of at most block
+     *        Systems; scratch is per thread and reused across blocks
+     */
+
+    template <class FunctionT>
+    void sweep ( std::size_t i_systems, std::size_t i_threads, std::size_t i_scratch, FunctionT&& i_function ) {
+        parallel_for ( ( i_systems + block - 1 ) / block, i_threads, [ & ] ( std::size_t, std::size_t begin, std::size_t end ) {
+            std::vector<double> scratch ( i_scratch * block );
+            for ( std::size_t k = begin; k < end; ++k ) {
+                std::size_t const first = k * block;
+                i_function ( first, std::min ( block, i_systems - first ), scratch.data () );
+            }
+        } );
+    }
+
+} // namespace
+
+// ================================================================
+
+void tridiagonal_thomas ( std::span<double const> i_lower, std::span<double const> i_diagonal, std::span<double const> i_upper, std::span<double> io_rhs, std::size_t i_rows, std::size_t i_systems, std::size_t i_threads ) {
+    std::size_t const n = i_rows, m = i_systems;
+    assert ( i_lower.size () == n * m && i_diagonal.size () == n * m && i_upper.size () == n * m && io_rhs.size () == n * m );
+    if ( n == 0 )
+        return;
+
+    sweep ( m, i_threads, n, [ & ] ( std::size_t first, std::size_t width, double* gamma ) {
+        double const* a = i_lower.data () + first;
+        double const* b = i_diagonal.data () + first;
+        double const* c = i_upper.data () + first;
+        double* d       = io_rhs.data () + first;
+
+        // forward: x_i + gamma_i x_i+1 = d_i
+        for ( std::size_t s = 0; s < width; ++s ) {
+            gamma [ s ] = c [ s ] / b [ s ];
+            d [ s ]     = d [ s ] / b [ s ];
+        }
+        for ( std::size_t i = 1; i < n; ++i ) {
+            std::size_t const r = i * m, p = ( i - 1 ) * m;
+            double* g           = gamma + i * width;
+            double const* h     = gamma + ( i - 1 ) * width;
+            for ( std::size_t s = 0; s < width; ++s ) {
+                double const pivot = 1. / ( b [ r + s ] - a [ r + s ] * h [ s ] );
+                g [ s ]            = c [ r + s ] * pivot;
+                d [ r + s ]        = ( d [ r + s ] - a [ r + s ] * d [ p + s ] ) * pivot;
+            }
+        }
+
+        for ( std::size_t i = n - 1; i-- > 0; ) {
+            std::size_t const r = i * m, q = ( i + 1 ) * m;
+            double const* g     = gamma + i * width;
+            for ( std::size_t s = 0; s < width; ++s )
+                d [ r + s ] -= g [ s ] * d [ q + s ];
+        }
+    } );
+}
+
+/**
+ * \brief Level h Eliminates Rows i - h and i + h from Rows i = 2h - 1 (mod 2h);
+ *        Back Substitution Solves Rows h - 1 (mod 2h) from the Level Above
+ */
+
+void tridiagonal_cyclic_reduction ( std::span<double const> i_lower, std::span<double const> i_diagonal, std::span<double const> i_upper, std::span<double> io_rhs, std::size_t i_rows, std::size_t i_systems, std::size_t i_threads ) {
+    std::size_t const n = i_rows, m = i_systems;
+    assert ( i_lower.size () == n * m && i_diagonal.size () == n * m && i_upper.size () == n * m && io_rhs.size () == n * m );
+    if ( n == 0 )
+        return;
+
+    std::size_t top = 1;
+    while ( 2 * top <= n )
+        top *= 2;
+
+    sweep ( m, i_threads, 3 * n, [ & ] ( std::size_t first, std::size_t width, double* scratch ) {
+        double* a = scratch;
+        double* b = scratch + n * width;
+        double* c = scratch + 2 * n * width;
+        double* d = io_rhs.data () + first;
+        for ( std::size_t i = 0; i < n; ++i )
+            for ( std::size_t s = 0; s < width; ++s ) {
+                a [ i * width + s ] = i > 0 ? i_lower [ i * m + first + s ] : 0.;
+                b [ i * width + s ] = i_diagonal [ i * m + first + s ];
+                c [ i * width + s ] = i + 1 < n ? i_upper [ i * m + first + s ] : 0.;
+            }
+
+        for ( std::size_t h = 1; h < top; h *= 2 )
+            for ( std::size_t i = 2 * h - 1; i < n; i += 2 * h ) {
+                std::size_t const l = i - h, u = i + h;
+                bool const right    = u < n;
+                for ( std::size_t s = 0; s < width; ++s ) {
+                    std::size_t const I = i * width + s, L = l * width + s, U = u * width + s;
+                    double const alpha  = -a [ I ] / b [ L ];
+                    double const gamma  = right ? -c [ I ] / b [ U ] : 0.;
+                    b [ I ] += alpha * c [ L ] + ( right ? gamma * a [ U ] : 0. );
+                    d [ i * m + s ] += alpha * d [ l * m + s ] + ( right ? gamma * d [ u * m + s ] : 0. );
+                    a [ I ] = alpha * a [ L ];
+                    c [ I ] = right ? gamma * c [ U ] : 0.;
+                }
+            }
+
+        for ( std::size_t h = top; h >= 1; h /= 2 )
+            for ( std::size_t i = h - 1; i < n; i += 2 * h ) {
+                bool const left = i >= h, right = i + h < n;
+                for ( std::size_t s = 0; s < width; ++s ) {
+                    std::size_t const I = i * width + s;
+                    double t            = d [ i * m + s ];
+                    if ( left )
+                        t -= a [ I ] * d [ ( i - h ) * m + s ];
+                    if ( right )
+                        t -= c [ I ] * d [ ( i + h ) * m + s ];
+                    d [ i * m + s ] = t / b [ I ];
+                }
+            }
+    } );
+}
+
+/**
+ * \brief Row i Becomes x_i + gamma_i x_i+1 + delta_i x_i+2 = z_i after
+ *        Substituting the Two Rows Above
+ */
+
+void pentadiagonal_thomas ( std::span<double const> i_lower2, std::span<double const> i_lower, std::span<double const> i_diagonal, std::span<double const> i_upper, std::span<double const> i_upper2, std::span<double> io_rhs, std::size_t i_rows, std::size_t i_systems, std::size_t i_threads ) {
+    std::size_t const n = i_rows, m = i_systems;
+    assert ( i_lower2.size () == n * m && i_lower.size () == n * m && i_diagonal.size () == n * m && i_upper.size () == n * m && i_upper2.size () == n * m && io_rhs.size () == n * m );
+    if ( n == 0 )
+        return;
+
+    sweep ( m, i_threads, 2 * n, [ & ] ( std::size_t first, std::size_t width, double* scratch ) {
+        double* gamma = scratch;
+        double* delta = scratch + n * width;
+        double* z     = io_rhs.data () + first;
+
+        for ( std::size_t i = 0; i < n; ++i ) {
+            std::size_t const r = i * m + first;
+            for ( std::size_t s = 0; s < width; ++s ) {
+                double a = i > 0 ? i_lower [ r + s ] : 0., b = i_diagonal [ r + s ], c = i + 1 < n ? i_upper [ r + s ] : 0., d = z [ i * m + s ];
+                if ( i > 1 ) {
+                    std::size_t const P = ( i - 2 ) * width + s;
+                    double const e      = i_lower2 [ r + s ];
+                    a -= e * gamma [ P ];
+                    b -= e * delta [ P ];
+                    d -= e * z [ ( i - 2 ) * m + s ];
+                }
+                if ( i > 0 ) {
+                    std::size_t const P = ( i - 1 ) * width + s;
+                    b -= a * gamma [ P ];
+                    c -= a * delta [ P ];
+                    d -= a * z [ ( i - 1 ) * m + s ];
+                }
+                double const pivot      = 1. / b;
+                gamma [ i * width + s ] = c * pivot;
+                delta [ i * width + s ] = ( i + 2 < n ? i_upper2 [ r + s ] : 0. ) * pivot;
+                z [ i * m + s ]         = d * pivot;
+            }
+        }
+
+        for ( std::size_t i = n - 1; i-- > 0; )
+            for ( std::size_t s = 0; s < width; ++s ) {
+                double t = z [ i * m + s ] - gamma [ i * width + s ] * z [ ( i + 1 ) * m + s ];
+                if ( i + 2 < n )
+                    t -= delta [ i * width + s ] * z [ ( i + 2 ) * m + s ];
+                z [ i * m + s ] = t;
+            }
+    } );
+}
+
+// ================================================================
+
+void interleave ( std::span<double const> i_lines, std::span<double> o_batch, std::size_t i_rows, std::size_t i_systems ) {
+    assert ( i_lines.size () == i_rows * i_systems && o_batch.size () == i_rows * i_systems );
+    for ( std::size_t s = 0; s < i_systems; ++s )
+        for ( std::size_t i = 0; i < i_rows; ++i )
+            o_batch [ i * i_systems + s ] = i_lines [ s * i_rows + i ];
+}
+
+void deinterleave ( std::span<double const> i_batch, std::span<double> o_lines, std::size_t i_rows, std::size_t i_systems ) {
+    assert ( i_batch.size () == i_rows * i_systems && o_lines.size () == i_rows * i_systems );
+    for ( std::size_t s = 0; s < i_systems; ++s )
+        for ( std::size_t i = 0; i < i_rows; ++i )
+            o_lines [ s * i_rows + i ] = i_batch [ i * i_systems + s ];
+}
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
@@ -0,0 +1,569 @@
+/**
+ * \file  microstructure/lib/solver/src/fourier.cpp
+ * \brief Mixed-Radix Fast Fourier Transforms with a Plan Cache
+ */
+
+#include "fourier.hpp"
+#include "parallel.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <numeric>
+#include <tuple>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+namespace {
+
+    constexpr std::size_t B = fourier_plan::lanes;
+
+    /**
+     * \brief Butterfly Stages: p transforms of length l, r apart, combine
+     *        into one of length l p; element e of lane b lives at [e B + b]
+     * \note  y[s L + j + l u] = sum_q w_p^(q u) w_L^(q j) x[(s + q r) l + j]
+     */
+
+    struct stage {
+        double const* xr;
+        double const* xi;
+        double* yr;
+        double* yi;
+        std::size_t l;
+        std::size_t r;
+        double const* c;
+        double const* s;
+        double sigma;
+        double const* uc;
+        double const* us;
+        double* tr;
+        double* ti;
+    };
+
+    /** \brief (a + b i) times (cos + i sin) */
+    inline void twiddle ( double& re, double& im, double c, double s ) {
+        double const t = re * c - im * s;
+        im             = re * s + im * c;
+        re             = t;
+    }
+
+    void radix2 ( stage const& g ) {
+        for ( std::size_t s = 0; s < g.r; ++s )
+            for ( std::size_t j = 0; j < g.l; ++j ) {
+                double const c = g.c [ j ], sn = g.s [ j ];
+                std::size_t const a = ( s * g.l + j ) * B, b = ( ( s + g.r ) * g.l + j ) * B;
+                std::size_t const o = ( s * 2 * g.l + j ) * B, l = g.l * B;
+                for ( std::size_t q = 0; q < B; ++q ) {
+                    double br = g.xr [ b + q ], bi = g.xi [ b + q ];
+                    twiddle ( br, bi, c, sn );
+                    g.yr [ o + q ]     = g.xr [ a + q ] + br;
+                    g.yi [ o + q ]     = g.xi [ a + q ] + bi;
+                    g.yr [ o + l + q ] = g.xr [ a + q ] - br;
+                    g.yi [ o + l + q ] = g.xi [ a + q ] - bi;
+                }
+            }
+    }
+
+    void radix3 ( stage const& g ) {
+        double const h = 0.86602540378443864676 * g.sigma;
+        for ( std::size_t s = 0; s < g.r; ++s )
+            for ( std::size_t j = 0; j < g.l; ++j ) {
+                double const c1 = g.c [ j ], s1 = g.s [ j ], c2 = g.c [ g.l + j ], s2 = g.s [ g.l + j ];
+                std::size_t const i0 = ( s * g.l + j ) * B, i1 = ( ( s + g.r ) * g.l + j ) * B,
+                                  i2 = ( ( s + 2 * g.r ) * g.l + j ) * B;
+                std::size_t const o = ( s * 3 * g.l + j ) * B, l = g.l * B;
+                for ( std::size_t q = 0; q < B; ++q ) {
+                    double br = g.xr [ i1 + q ], bi = g.xi [ i1 + q ];
+                    double dr = g.xr [ i2 + q ], di = g.xi [ i2 + q ];
+                    twiddle ( br, bi, c1, s1 );
+                    twiddle ( dr, di, c2, s2 );
+                    double const ar = g.xr [ i0 + q ], ai = g.xi [ i0 + q ];
+                    double const tr = br + dr, ti = bi + di;
+                    double const mr = ar - 0.5 * tr, mi = ai - 0.5 * ti;
+                    // (sigma i) sqrt(3) / 2 (b - d)
+                    double const nr = -h * ( bi - di ), ni = h * ( br - dr );
+                    g.yr [ o + q ]         = ar + tr;
+                    g.yi [ o + q ]         = ai + ti;
+                    g.yr [ o + l + q ]     = mr + nr;
+                    g.yi [ o + l + q ]     = mi + ni;
+                    g.yr [ o + 2 * l + q ] = mr - nr;
+                    g.yi [ o + 2 * l + q ] = mi - ni;
+                }
+            }
+    }
+
+    void radix4 ( stage const& g ) {
+        for ( std::size_t s = 0; s < g.r; ++s )
+            for ( std::size_t j = 0; j < g.l; ++j ) {
+                double const c1 = g.c [ j ], s1 = g.s [ j ];
+                double const c2 = g.c [ g.l + j ], s2 = g.s [ g.l + j ];
+                double const c3 = g.c [ 2 * g.l + j ], s3 = g.s [ 2 * g.l + j ];
+                std::size_t const i0 = ( s * g.l + j ) * B, i1 = ( ( s + g.r ) * g.l + j ) * B,
+                                  i2 = ( ( s + 2 * g.r ) * g.l + j ) * B,
+                                  i3 = ( ( s + 3 * g.r ) * g.l + j ) * B;
+                std::size_t const o = ( s * 4 * g.l + j ) * B, l = g.l * B;
+                for ( std::size_t q = 0; q < B; ++q ) {
+                    double br = g.xr [ i1 + q ], bi = g.xi [ i1 + q ];
+                    double cr = g.xr [ i2 + q ], ci = g.xi [ i2 + q ];
+                    double dr = g.xr [ i3 + q ], di = g.xi [ i3 + q ];
+                    twiddle ( br, bi, c1, s1 );
+                    twiddle ( cr, ci, c2, s2 );
+                    twiddle ( dr, di, c3, s3 );
+                    double const ar = g.xr [ i0 + q ], ai = g.xi [ i0 + q ];
+                    double const er = ar + cr, ei = ai + ci, fr = ar - cr, fi = ai - ci;
+                    double const gr = br + dr, gi = bi + di;
+                    // (sigma i) (b - d)
+                    double const hr = -g.sigma * ( bi - di ), hi = g.sigma * ( br - dr );
+                    g.yr [ o + q ]         = er + gr;
+                    g.yi [ o + q ]         = ei + gi;
+                    g.yr [ o + l + q ]     = fr + hr;
+                    g.yi [ o + l + q ]     = fi + hi;
+                    g.yr [ o + 2 * l + q ] = er - gr;
+                    g.yi [ o + 2 * l + q ] = ei - gi;
+                    g.yr [ o + 3 * l + q ] = fr - hr;
+                    g.yi [ o + 3 * l + q ] = fi - hi;
+                }
+            }
+    }
+
+    void radix5 ( stage const& g ) {
+        constexpr double k1 = 0.30901699437494742410, k2 = -0.80901699437494742410;
+        double const h1 = 0.95105651629515357212 * g.sigma, h2 = 0.58778525229247312917 * g.sigma;
+        for ( std::size_t s = 0; s < g.r; ++s )
+            for ( std::size_t j = 0; j < g.l; ++j ) {
+                std::size_t i [ 5 ];
+                for ( std::size_t k = 0; k < 5; ++k )
+                    i [ k ] = ( ( s + k * g.r ) * g.l + j ) * B;
+                std::size_t const o = ( s * 5 * g.l + j ) * B, l = g.l * B;
+                for ( std::size_t q = 0; q < B; ++q ) {
+                    double xr [ 5 ], xi [ 5 ];
+                    xr [ 0 ] = g.xr [ i [ 0 ] + q ];
+                    xi [ 0 ] = g.xi [ i [ 0 ] + q ];
+                    for ( std::size_t k = 1; k < 5; ++k ) {
+                        xr [ k ] = g.xr [ i [ k ] + q ];
+                        xi [ k ] = g.xi [ i [ k ] + q ];
+                        twiddle ( xr [ k ], xi [ k ], g.c [ ( k - 1 ) * g.l + j ], g.s [ ( k - 1 ) * g.l + j ] );
+                    }
+                    double const t1r = xr [ 1 ] + xr [ 4 ], t1i = xi [ 1 ] + xi [ 4 ];
+                    double const t2r = xr [ 2 ] + xr [ 3 ], t2i = xi [ 2 ] + xi [ 3 ];
+                    double const u1r = xr [ 1 ] - xr [ 4 ], u1i = xi [ 1 ] - xi [ 4 ];
+                    double const u2r = xr [ 2 ] - xr [ 3 ], u2i = xi [ 2 ] - xi [ 3 ];
+                    double const m1r = xr [ 0 ] + k1 * t1r + k2 * t2r, m1i = xi [ 0 ] + k1 * t1i + k2 * t2i;
+                    double const m2r = xr [ 0 ] + k2 * t1r + k1 * t2r, m2i = xi [ 0 ] + k2 * t1i + k1 * t2i;
+                    // (sigma i) (h1 u1 + h2 u2) and (sigma i) (h2 u1 - h1 u2)
+                    double const n1r = -( h1 * u1i + h2 * u2i ), n1i = h1 * u1r + h2 * u2r;
+                    double const n2r = -( h2 * u1i - h1 * u2i ), n2i = h2 * u1r - h1 * u2r;
+                    g.yr [ o + q ]         = xr [ 0 ] + t1r + t2r;
+                    g.yi [ o + q ]         = xi [ 0 ] + t1i + t2i;
+                    g.yr [ o + l + q ]     = m1r + n1r;
+                    g.yi [ o + l + q ]     = m1i + n1i;
+                    g.yr [ o + 2 * l + q ] = m2r + n2r;
+                    g.yi [ o + 2 * l + q ] = m2i + n2i;
+                    g.yr [ o + 3 * l + q ] = m2r - n2r;
+                    g.yi [ o + 3 * l + q ] = m2i - n2i;
+                    g.yr [ o + 4 * l + q ] = m1r - n1r;
+                    g.yi [ o + 4 * l + q ] = m1i - n1i;
+                }
+            }
+    }
+
+    /**
+     * \brief Direct Butterfly of any Radix p
+     * \note  The p roots w_p^k come with the plan (uc, us), the p B twiddled
+     *        inputs go to the caller's scratch (tr, ti)
+     */
+
+    void radix ( stage const& g, std::size_t p ) {
+        double* const tr = g.tr;
+        double* const ti = g.ti;
+        for ( std::size_t s = 0; s < g.r; ++s )
+            for ( std::size_t j = 0; j < g.l; ++j ) {
+                for ( std::size_t k = 0; k < p; ++k ) {
+                    std::size_t const i = ( ( s + k * g.r ) * g.l + j ) * B;
+                    for ( std::size_t q = 0; q < B; ++q ) {
+                        double re = g.xr [ i + q ], im = g.xi [ i + q ];
+                        if ( k > 0 )
+                            twiddle ( re, im, g.c [ ( k - 1 ) * g.l + j ], g.s [ ( k - 1 ) * g.l + j ] );
+                        tr [ k * B + q ] = re;
+                        ti [ k * B + q ] = im;
+                    }
+                }
+                for ( std::size_t u = 0; u < p; ++u ) {
+                    std::size_t const o = ( s * p * g.l + j + g.l * u ) * B;
+                    for ( std::size_t q = 0; q < B; ++q ) {
+                        g.yr [ o + q ] = 0.;
+                        g.yi [ o + q ] = 0.;
+                    }
+                    for ( std::size_t k = 0; k < p; ++k ) {
+                        double const c = g.uc [ ( k * u ) % p ], sn = g.us [ ( k * u ) % p ];
+                        for ( std::size_t q = 0; q < B; ++q ) {
+                            g.yr [ o + q ] += tr [ k * B + q ] * c - ti [ k * B + q ] * sn;
+                            g.yi [ o + q ] += tr [ k * B + q ] * sn + ti [ k * B + q ] * c;
+                        }
+                    }
+                }
+            }
+    }
+
+    /**
+     * \brief Per-Thread Scratch, Grown on Demand and Reused by that Thread
+     * \note  Lines are shared on persistent workers (see share), so every
+     *        thread keeps its buffers from one transform to the next
+     */
+    std::vector<double>& lane_buffer ( std::size_t i_size ) {
+        thread_local std::vector<double> buffer;
+        if ( buffer.size () < i_size )
+            buffer.resize ( i_size );
+        return buffer;
+    }
+
+    std::vector<complex>& line_buffer ( std::size_t i_size ) {
+        thread_local std::vector<complex> buffer;
+        if ( buffer.size () < i_size )
+            buffer.resize ( i_size );
+        return buffer;
+    }
+
+    std::mutex pool_mutex;
+    std::map<std::size_t, std::unique_ptr<worker_pool const>> pools;
+
+    /** \brief Shared Pool of i_threads Workers (0 for all), Built on First Use */
+    worker_pool const& workers ( std::size_t i_threads ) {
+        std::size_t const threads = concurrency ( i_threads );
+        std::lock_guard<std::mutex> const lock ( pool_mutex );
+        auto& entry = pools [ threads ];
+        if ( !entry )
+            entry = std::make_unique<worker_pool const> ( threads );
+        return *entry;
+    }
+
+    /**
+     * \brief i_function ( begin, end ) on Contiguous Chunks of [0, i_count),
+     *        Chunk t on Worker t of the Shared Pool
+     * \note  Transforms from several threads on the same pool take turns
+     */
+
+    template <class FunctionT>
+    void share ( std::size_t i_count, std::size_t i_threads, FunctionT&& i_function ) {
+        if ( i_count <= 1 || concurrency ( i_threads ) == 1 ) {
+            i_function ( std::size_t { 0 }, i_count );
+            return;
+        }
+        worker_pool const& pool = workers ( i_threads );
+        std::size_t const chunk = ( i_count + pool.size () - 1 ) / pool.size ();
+        pool.run ( [ & ] ( std::size_t t ) {
+            std::size_t const begin = std::min ( t * chunk, i_count );
+            std::size_t const end   = std::min ( begin + chunk, i_count );
+            if ( begin < end )
+                i_function ( begin, end );
+        } );
+    }
+
+    std::size_t product ( std::span<std::size_t const> i_shape, std::size_t i_begin, std::size_t i_end ) {
+        return std::accumulate ( i_shape.begin () + i_begin, i_shape.begin () + i_end, std::size_t { 1 }, std::multiplies<> {} );
+    }
+
+    /** \brief Transform every Line along Axis a of a Row-Major Array */
+    void transform_axis ( complex* io_data, std::span<std::size_t const> i_shape, std::size_t i_axis, direction i_direction, std::size_t i_threads ) {
+        std::size_t const n      = i_shape [ i_axis ];
+        std::size_t const stride = product ( i_shape, i_axis + 1, i_shape.size () );
+        std::size_t const outer  = product ( i_shape, 0, i_axis );
+        if ( n == 1 )
+            return;
+
+        auto const p = plan ( n, stride, i_direction );
+
+        if ( stride == 1 ) {
+            // rows: lanes are whole rows, gathered by tile transposes
+            std::size_t const groups = ( outer + B - 1 ) / B;
+            share ( groups, i_threads, [ & ] ( std::size_t begin, std::size_t end ) {
+                for ( std::size_t g = begin; g < end; ++g )
+                    p->execute ( io_data + g * B * n, std::min ( B, outer - g * B ), n );
+            } );
+            return;
+        }
+
+        // columns: lanes are adjacent columns
+        std::size_t const per    = ( stride + B - 1 ) / B;
+        std::size_t const groups = outer * per;
+        share ( groups, i_threads, [ & ] ( std::size_t begin, std::size_t end ) {
+            for ( std::size_t g = begin; g < end; ++g ) {
+                std::size_t const o = g / per, c = ( g % per ) * B;
+                p->execute ( io_data + o * n * stride + c, std::min ( B, stride - c ), 1 );
+            }
+        } );
+    }
+
+    /** \brief e^(sign 2 pi i k / n) for k = 0 .. n / 2 */
+    std::vector<complex> half_roots ( std::size_t i_length, double i_sign ) {
+        std::vector<complex> w ( i_length / 2 + 1 );
+        for ( std::size_t k = 0; k < w.size (); ++k )
+            w [ k ] = std::polar ( 1., i_sign * 2. * std::numbers::pi * double ( k ) / double ( i_length ) );
+        return w;
+    }
+
+} // namespace
+
+// ================================================================
+
+fourier_plan::fourier_plan ( std::size_t i_length, std::size_t i_stride, direction i_direction )
+    : m_length { i_length }, m_stride { i_stride }, m_direction { i_direction } {
+    assert ( m_length > 0 && m_stride > 0 );
+
+    std::size_t m = m_length;
+    for ( std::size_t const p : { 4, 2, 3, 5 } )
+        while ( m % p == 0 ) {
+            m_radix.push_back ( p );
+            m /= p;
+        }
+    for ( std::size_t p = 7; m > 1; p += 2 )
+        while ( m % p == 0 ) {
+            m_radix.push_back ( p );
+            m /= p;
+        }
+
+    double const sigma = double ( static_cast<int> ( m_direction ) );
+    std::size_t l      = 1;
+    for ( std::size_t const p : m_radix ) {
+        std::size_t const L = l * p;
+        m_offset.push_back ( m_cos.size () );
+        for ( std::size_t q = 1; q < p; ++q )
+            for ( std::size_t j = 0; j < l; ++j ) {
+                double const a = sigma * 2. * std::numbers::pi * double ( ( q * j ) % L ) / double ( L );
+                m_cos.push_back ( std::cos ( a ) );
+                m_sin.push_back ( std::sin ( a ) );
+            }
+        l = L;
+
+        // roots w_p^k of the direct butterflies
+        m_root.push_back ( m_unit_cos.size () );
+        if ( p > 5 ) {
+            for ( std::size_t k = 0; k < p; ++k ) {
+                double const a = sigma * 2. * std::numbers::pi * double ( k ) / double ( p );
+                m_unit_cos.push_back ( std::cos ( a ) );
+                m_unit_sin.push_back ( std::sin ( a ) );
+            }
+            m_widest = std::max ( m_widest, p );
+        }
+    }
+}
+
+bool fourier_plan::transform ( double* io_re, double* io_im, double* o_re, double* o_im, double* o_scratch ) const {
+    double const sigma = double ( static_cast<int> ( m_direction ) );
+    bool swapped       = false;
+    std::size_t l      = 1;
+    for ( std::size_t k = 0; k < m_radix.size (); ++k ) {
+        std::size_t const p = m_radix [ k ];
+        stage const g { io_re, io_im, o_re, o_im, l, m_length / ( l * p ), m_cos.data () + m_offset [ k ], m_sin.data () + m_offset [ k ], sigma,
+                        m_unit_cos.data () + m_root [ k ], m_unit_sin.data () + m_root [ k ], o_scratch, o_scratch + m_widest * B };
+        switch ( p ) {
+            case 2: radix2 ( g ); break;
+            case 3: radix3 ( g ); break;
+            case 4: radix4 ( g ); break;
+            case 5: radix5 ( g ); break;
+            default: radix ( g, p ); break;
+        }
+        std::swap ( io_re, o_re );
+        std::swap ( io_im, o_im );
+        swapped = !swapped;
+        l *= p;
+    }
+    return swapped;
+}
+
+void fourier_plan::execute ( complex* io_data, std::size_t i_lines, std::size_t i_distance ) const {
+    std::size_t const n = m_length;
+    std::vector<double>& buffer = lane_buffer ( ( 4 * n + 2 * m_widest ) * B );
+    double* const xr = buffer.data ();
+    double* const xi = xr + n * B;
+    double* const yr = xi + n * B;
+    double* const yi = yr + n * B;
+
+    for ( std::size_t first = 0; first < i_lines; first += B ) {
+        std::size_t const lines = std::min ( B, i_lines - first );
+        complex* const base     = io_data + first * i_distance;
+
+        // gather: read along whichever of line and lane is contiguous
+        if ( lines < B )
+            for ( std::size_t k = 0; k < n; ++k )
+                for ( std::size_t q = lines; q < B; ++q )
+                    xr [ k * B + q ] = xi [ k * B + q ] = 0.;
+        if ( m_stride == 1 )
+            for ( std::size_t q = 0; q < lines; ++q )
+                for ( std::size_t k = 0; k < n; ++k ) {
+                    complex const z  = base [ q * i_distance + k ];
+                    xr [ k * B + q ] = z.real ();
+                    xi [ k * B + q ] = z.imag ();
+                }
+        else
+            for ( std::size_t k = 0; k < n; ++k )
+                for ( std::size_t q = 0; q < lines; ++q ) {
+                    complex const z  = base [ q * i_distance + k * m_stride ];
+                    xr [ k * B + q ] = z.real ();
+                    xi [ k * B + q ] = z.imag ();
+                }
+
+        bool const scratch  = transform ( xr, xi, yr, yi, yi + n * B );
+        double const* const zr = scratch ? yr : xr;
+        double const* const zi = scratch ? yi : xi;
+
+        if ( m_stride == 1 )
+            for ( std::size_t q = 0; q < lines; ++q )
+                for ( std::size_t k = 0; k < n; ++k )
+                    base [ q * i_distance + k ] = { zr [ k * B + q ], zi [ k * B + q ] };
+        else
+            for ( std::size_t k = 0; k < n; ++k )
+                for ( std::size_t q = 0; q < lines; ++q )
+                    base [ q * i_distance + k * m_stride ] = { zr [ k * B + q ], zi [ k * B + q ] };
+    }
+}
+
+// ================================================================
+
+namespace {
+
+    std::mutex cache_mutex;
+    std::map<std::tuple<std::size_t, std::size_t, int>, std::shared_ptr<fourier_plan const>> cache;
+
+} // namespace
+
+std::shared_ptr<fourier_plan const> plan ( std::size_t i_length, std::size_t i_stride, direction i_direction ) {
+    std::lock_guard<std::mutex> const lock ( cache_mutex );
+    auto& entry = cache [ { i_length, i_stride, static_cast<int> ( i_direction ) } ];
+    if ( !entry )
+        entry = std::make_shared<fourier_plan const> ( i_length, i_stride, i_direction );
+    return entry;
+}
+
+std::size_t cached_plans () {
+    std::lock_guard<std::mutex> const lock ( cache_mutex );
+    return cache.size ();
+}
+
+void clear_plans () {
+    std::lock_guard<std::mutex> const lock ( cache_mutex );
+    cache.clear ();
+}
+
+// ================================================================
+
+void fft ( std::span<complex> io_data, std::span<std::size_t const> i_shape, direction i_direction, std::size_t i_threads ) {
+    assert ( !i_shape.empty () && i_shape.size () <= 3 );
+    assert ( io_data.size () == product ( i_shape, 0, i_shape.size () ) );
+    for ( std::size_t a = 0; a < i_shape.size (); ++a )
+        transform_axis ( io_data.data (), i_shape, a, i_direction, i_threads );
+}
+
+void rfft ( std::span<double const> i_data, std::span<complex> o_data, std::span<std::size_t const> i_shape, std::size_t i_threads ) {
+    assert ( !i_shape.empty () && i_shape.size () <= 3 );
+    std::size_t const d = i_shape.size (), n = i_shape.back ();
+    std::size_t const rows = product ( i_shape, 0, d - 1 ), hh = n / 2 + 1;
+    assert ( i_data.size () == rows * n && o_data.size () == rows * hh );
+
+    if ( n % 2 == 0 ) {
+        // pack x_2j + i x_2j+1, transform length n / 2, untangle
+        std::size_t const h = n / 2;
+        for ( std::size_t r = 0; r < rows; ++r )
+            for ( std::size_t j = 0; j < h; ++j )
+                o_data [ r * hh + j ] = { i_data [ r * n + 2 * j ], i_data [ r * n + 2 * j + 1 ] };
+
+        auto const p = plan ( h, 1, direction::forward );
+        auto const w = half_roots ( n, -1. );
+        share ( ( rows + B - 1 ) / B, i_threads, [ & ] ( std::size_t begin, std::size_t end ) {
+            std::vector<complex>& z = line_buffer ( h + 1 );
+            for ( std::size_t g = begin; g < end; ++g ) {
+                std::size_t const first = g * B, lines = std::min ( B, rows - first );
+                p->execute ( o_data.data () + first * hh, lines, hh );
+                for ( std::size_t r = first; r < first + lines; ++r ) {
+                    complex* const x = o_data.data () + r * hh;
+                    std::copy ( x, x + h, z.begin () );
+                    z [ h ] = z [ 0 ];
+                    for ( std::size_t k = 0; k <= h; ++k ) {
+                        complex const a = z [ k ], b = std::conj ( z [ h - k ] );
+                        complex const even = 0.5 * ( a + b ), odd = complex { 0., -0.5 } * ( a - b );
+                        x [ k ]            = even + w [ k ] * odd;
+                    }
+                }
+            }
+        } );
+    } else {
+        auto const p = plan ( n, 1, direction::forward );
+        share ( rows, i_threads, [ & ] ( std::size_t begin, std::size_t end ) {
+            std::vector<complex>& z = line_buffer ( n );
+            for ( std::size_t r = begin; r < end; ++r ) {
+                for ( std::size_t k = 0; k < n; ++k )
+                    z [ k ] = i_data [ r * n + k ];
+                p->execute ( z.data (), 1, n );
+                std::copy ( z.begin (), z.begin () + hh, o_data.begin () + r * hh );
+            }
+        } );
+    }
+
+    std::vector<std::size_t> shape ( i_shape.begin (), i_shape.end () );
+    shape.back () = hh;
+    for ( std::size_t a = 0; a + 1 < d; ++a )
+        transform_axis ( o_data.data (), shape, a, direction::forward, i_threads );
+}
+
+void irfft ( std::span<complex> io_data, std::span<double> o_data, std::span<std::size_t const> i_shape, std::size_t i_threads ) {
+    assert ( !i_shape.empty () && i_shape.size () <= 3 );
+    std::size_t const d = i_shape.size (), n = i_shape.back ();
+    std::size_t const rows = product ( i_shape, 0, d - 1 ), hh = n / 2 + 1;
+    assert ( io_data.size () == rows * hh && o_data.size () == rows * n );
+
+    std::vector<std::size_t> shape ( i_shape.begin (), i_shape.end () );
+    shape.back () = hh;
+    for ( std::size_t a = 0; a + 1 < d; ++a )
+        transform_axis ( io_data.data (), shape, a, direction::backward, i_threads );
+
+    if ( n % 2 == 0 ) {
+        // Z_k = (X_k + X*_h-k) + i e^(2 pi i k / n) (X_k - X*_h-k), then length n / 2
+        std::size_t const h = n / 2;
+        auto const p = plan ( h, 1, direction::backward );
+        auto const w = half_roots ( n, 1. );
+        share ( ( rows + B - 1 ) / B, i_threads, [ & ] ( std::size_t begin, std::size_t end ) {
+            std::vector<complex>& z = line_buffer ( h + 1 );
+            for ( std::size_t g = begin; g < end; ++g ) {
+                std::size_t const first = g * B, lines = std::min ( B, rows - first );
+                for ( std::size_t r = first; r < first + lines; ++r ) {
+                    complex* const x = io_data.data () + r * hh;
+                    std::copy ( x, x + hh, z.begin () );
+                    for ( std::size_t k = 0; k < h; ++k ) {
+                        complex const a = z [ k ], b = std::conj ( z [ h - k ] );
+                        x [ k ]         = ( a + b ) + complex { 0., 1. } * w [ k ] * ( a - b );
+                    }
+                }
+                p->execute ( io_data.data () + first * hh, lines, hh );
+                for ( std::size_t r = first; r < first + lines; ++r )
+                    for ( std::size_t j = 0; j < h; ++j ) {
+                        o_data [ r * n + 2 * j ]     = io_data [ r * hh + j ].real ();
+                        o_data [ r * n + 2 * j + 1 ] = io_data [ r * hh + j ].imag ();
+                    }
+            }
+        } );
+    } else {
+        auto const p = plan ( n, 1, direction::backward );
+        share ( rows, i_threads, [ & ] ( std::size_t begin, std::size_t end ) {
+            std::vector<complex>& z = line_buffer ( n );
+            for ( std::size_t r = begin; r < end; ++r ) {
+                complex const* const x = io_data.data () + r * hh;
+                z [ 0 ]                = x [ 0 ];
+                for ( std::size_t k = 1; k < hh; ++k ) {
+                    z [ k ]     = x [ k ];
+                    z [ n - k ] = std::conj ( x [ k ] );
+                }
+                p->execute ( z.data (), 1, n );
+                for ( std::size_t k = 0; k < n; ++k )
+                    o_data [ r * n + k ] = z [ k ].real ();
+            }
+        } );
+    }
+}
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
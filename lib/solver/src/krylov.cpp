@@ -0,0 +1,445 @@
+/**
+ * \file  microstructure/lib/solver/src/krylov.cpp
+ * \brief Preconditioned Krylov Solvers on Assembled or Matrix-Free Operators
+ */
+
+#include "krylov.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+namespace {
+
+    /**
+     * \class kernels
+     * \brief Fused Vector Passes over n Entries, Split into Fixed Chunks
+     * \note  Chunk t runs on worker t of a pool that lives for the whole
+     *        solve, so a pass costs a wake-up, not a thread start
+     * \note  Partial sums are added in chunk order, so a reduction gives the
+     *        same bits on every call with the same thread count
+     */
+
+    class kernels {
+
+    public:
+
+        kernels ( std::size_t i_size, krylov_settings const& i_settings )
+            : m_size { i_size },
+              m_pool { std::max<std::size_t> ( 1, std::min ( i_size < i_settings.parallel_length ? 1 : concurrency ( i_settings.threads ), i_size ) ) },
+              m_chunk { ( i_size + m_pool.size () - 1 ) / m_pool.size () },
+              m_partial ( m_pool.size () ),
+              m_pair ( m_pool.size () ) {}
+
+        /** \brief Sum of i_function ( begin, end ) over the Chunks */
+        template <class FunctionT>
+        double reduce ( FunctionT&& i_function ) {
+            run ( [ & ] ( std::size_t t, std::size_t begin, std::size_t end ) { m_partial [ t ] = i_function ( begin, end ); } );
+            double sum = 0.;
+            for ( double const p : m_partial )
+                sum += p;
+            return sum;
+        }
+
+        template <class FunctionT>
+        void apply ( FunctionT&& i_function ) {
+            run ( [ & ] ( std::size_t, std::size_t begin, std::size_t end ) { i_function ( begin, end ); } );
+        }
+
+        double dot ( std::span<double const> a, std::span<double const> b ) {
+            return reduce ( [ & ] ( std::size_t begin, std::size_t end ) {
+                double s = 0.;
+                for ( std::size_t i = begin; i < end; ++i )
+                    s += a [ i ] * b [ i ];
+                return s;
+            } );
+        }
+
+        /** \brief r = b - q; Returns |r|^2 */
+        double difference ( std::span<double const> b, std::span<double const> q, std::span<double> r ) {
+            return reduce ( [ & ] ( std::size_t begin, std::size_t end ) {
+                double s = 0.;
+                for ( std::size_t i = begin; i < end; ++i ) {
+                    r [ i ] = b [ i ] - q [ i ];
+                    s += r [ i ] * r [ i ];
+                }
+                return s;
+            } );
+        }
+
+        /** \brief y += a x; Returns y . z (z may be y) */
+        double axpy_dot ( double a, std::span<double const> x, std::span<double> y, std::span<double const> z ) {
+            return reduce ( [ & ] ( std::size_t begin, std::size_t end ) {
+                double s = 0.;
+                for ( std::size_t i = begin; i < end; ++i ) {
+                    y [ i ] += a * x [ i ];
+                    s += y [ i ] * z [ i ];
+                }
+                return s;
+            } );
+        }
+
+        /** \brief Returns ( a . b, a . c ) */
+        std::pair<double, double> dots ( std::span<double const> a, std::span<double const> b, std::span<double const> c ) {
+            run ( [ & ] ( std::size_t t, std::size_t begin, std::size_t end ) {
+                std::pair<double, double> s;
+                for ( std::size_t i = begin; i < end; ++i ) {
+                    s.first += a [ i ] * b [ i ];
+                    s.second += a [ i ] * c [ i ];
+                }
+                m_pair [ t ] = s;
+            } );
+            std::pair<double, double> sum;
+            for ( auto const& p : m_pair ) {
+                sum.first += p.first;
+                sum.second += p.second;
+            }
+            return sum;
+        }
+
+        void scale ( double a, std::span<double const> x, std::span<double> y ) {
+            apply ( [ & ] ( std::size_t begin, std::size_t end ) {
+                for ( std::size_t i = begin; i < end; ++i )
+                    y [ i ] = a * x [ i ];
+            } );
+        }
+
+    private:
+
+        /** \brief i_function ( t, begin, end ) on Chunk t of Worker t */
+        template <class FunctionT>
+        void run ( FunctionT&& i_function ) {
+            m_pool.run ( [ & ] ( std::size_t t ) {
+                std::size_t const begin = std::min ( t * m_chunk, m_size );
+                i_function ( t, begin, std::min ( begin + m_chunk, m_size ) );
+            } );
+        }
+
+        std::size_t m_size;
+        worker_pool m_pool;
+        std::size_t m_chunk;
+        std::vector<double> m_partial;
+        std::vector<std::pair<double, double>> m_pair;
+    };
+
+    /** \brief o_z = M^-1 i_r, or a Copy without a Preconditioner */
+    void precondition ( linear_operator const& i_m, std::span<double const> i_r, std::span<double> o_z ) {
+        if ( i_m )
+            i_m ( i_r, o_z );
+        else
+            std::copy ( i_r.begin (), i_r.end (), o_z.begin () );
+    }
+
+} // namespace
+
+// ================================================================
+
+jacobi_preconditioner::jacobi_preconditioner ( csr_matrix const& i_a ) : m_inverse ( i_a.rows () ) {
+    i_a.diagonal ( m_inverse );
+    for ( double& d : m_inverse ) {
+        assert ( d != 0. );
+        d = 1. / d;
+    }
+}
+
+jacobi_preconditioner::jacobi_preconditioner ( std::span<double const> i_diagonal ) : m_inverse ( i_diagonal.size () ) {
+    for ( std::size_t i = 0; i < m_inverse.size (); ++i ) {
+        assert ( i_diagonal [ i ] != 0. );
+        m_inverse [ i ] = 1. / i_diagonal [ i ];
+    }
+}
+
+void jacobi_preconditioner::operator() ( std::span<double const> i_r, std::span<double> o_z ) const {
+    assert ( i_r.size () == m_inverse.size () && o_z.size () == m_inverse.size () );
+    for ( std::size_t i = 0; i < m_inverse.size (); ++i )
+        o_z [ i ] = m_inverse [ i ] * i_r [ i ];
+}
+
+/**
+ * \brief IKJ Elimination Restricted to the Pattern; L (Unit Diagonal) and U
+ *        Share the Storage of A
+ */
+
+ilu0_preconditioner::ilu0_preconditioner ( csr_matrix const& i_a )
+    : m_offset ( i_a.offsets ().begin (), i_a.offsets ().end () ), m_index ( i_a.indices ().begin (), i_a.indices ().end () ),
+      m_diagonal ( i_a.rows () ), m_value ( i_a.values ().begin (), i_a.values ().end () ) {
+    assert ( i_a.rows () == i_a.columns () );
+    std::size_t const n    = i_a.rows ();
+    std::size_t const none = std::numeric_limits<std::size_t>::max ();
+
+    for ( std::size_t i = 0; i < n; ++i ) {
+        auto const first = m_index.begin () + std::ptrdiff_t ( m_offset [ i ] ), last = m_index.begin () + std::ptrdiff_t ( m_offset [ i + 1 ] );
+        auto const d     = std::lower_bound ( first, last, i );
+        assert ( d != last && *d == i );
+        m_diagonal [ i ] = std::size_t ( d - m_index.begin () );
+    }
+
+    std::vector<std::size_t> position ( n, none );
+    for ( std::size_t i = 0; i < n; ++i ) {
+        for ( std::size_t q = m_offset [ i ]; q < m_offset [ i + 1 ]; ++q )
+            position [ m_index [ q ] ] = q;
+
+        for ( std::size_t p = m_offset [ i ]; p < m_diagonal [ i ]; ++p ) {
+            std::size_t const k = m_index [ p ];
+            m_value [ p ] /= m_value [ m_diagonal [ k ] ];
+            for ( std::size_t q = m_diagonal [ k ] + 1; q < m_offset [ k + 1 ]; ++q )
+                if ( position [ m_index [ q ] ] != none )
+                    m_value [ position [ m_index [ q ] ] ] -= m_value [ p ] * m_value [ q ];
+        }
+        assert ( m_value [ m_diagonal [ i ] ] != 0. );
+
+        for ( std::size_t q = m_offset [ i ]; q < m_offset [ i + 1 ]; ++q )
+            position [ m_index [ q ] ] = none;
+    }
+}
+
+void ilu0_preconditioner::operator() ( std::span<double const> i_r, std::span<double> o_z ) const {
+    std::size_t const n = m_diagonal.size ();
+    assert ( i_r.size () == n && o_z.size () == n );
+
+    for ( std::size_t i = 0; i < n; ++i ) {
+        double s = i_r [ i ];
+        for ( std::size_t p = m_offset [ i ]; p < m_diagonal [ i ]; ++p )
+            s -= m_value [ p ] * o_z [ m_index [ p ] ];
+        o_z [ i ] = s;
+    }
+    for ( std::size_t i = n; i-- > 0; ) {
+        double s = o_z [ i ];
+        for ( std::size_t p = m_diagonal [ i ] + 1; p < m_offset [ i + 1 ]; ++p )
+            s -= m_value [ p ] * o_z [ m_index [ p ] ];
+        o_z [ i ] = s / m_value [ m_diagonal [ i ] ];
+    }
+}
+
+multigrid_preconditioner::multigrid_preconditioner ( multigrid& i_multigrid, std::size_t i_cycles )
+    : m_multigrid { &i_multigrid }, m_cycles { i_cycles } {}
+
+void multigrid_preconditioner::operator() ( std::span<double const> i_r, std::span<double> o_z ) const {
+    std::fill ( o_z.begin (), o_z.end (), 0. );
+    for ( std::size_t c = 0; c < m_cycles; ++c )
+        m_multigrid->cycle ( o_z, i_r );
+}
+
+// ================================================================
+
+krylov_report conjugate_gradient ( linear_operator const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner, krylov_settings const& i_settings ) {
+    std::size_t const n = i_b.size ();
+    assert ( io_x.size () == n );
+    kernels k ( n, i_settings );
+
+    std::vector<double> r ( n ), p ( n ), q ( n ), z;
+    double const scale  = std::sqrt ( k.dot ( i_b, i_b ) );
+    double const target = i_settings.tolerance * scale;
+
+    i_a ( io_x, q );
+    double rr = k.difference ( i_b, q, r );
+    double rz = rr;
+    if ( i_preconditioner ) {
+        z.resize ( n );
+        i_preconditioner ( r, z );
+        rz = k.dot ( r, z );
+    }
+    auto const& search = z.empty () ? r : z;
+    p                  = search;
+
+    krylov_report report;
+    while ( std::sqrt ( rr ) > target && report.iterations < i_settings.iterations ) {
+        i_a ( p, q );
+        double const pq = k.dot ( p, q );
+        if ( pq == 0. )
+            break;
+        double const alpha = rz / pq;
+
+        // x += alpha p, r -= alpha q and |r|^2 in one pass
+        rr = k.reduce ( [ & ] ( std::size_t begin, std::size_t end ) {
+            double s = 0.;
+            for ( std::size_t i = begin; i < end; ++i ) {
+                io_x [ i ] += alpha * p [ i ];
+                r [ i ] -= alpha * q [ i ];
+                s += r [ i ] * r [ i ];
+            }
+            return s;
+        } );
+        ++report.iterations;
+
+        double next = rr;
+        if ( i_preconditioner ) {
+            i_preconditioner ( r, z );
+            next = k.dot ( r, z );
+        }
+        double const beta = next / rz;
+        rz                = next;
+        k.apply ( [ & ] ( std::size_t begin, std::size_t end ) {
+            for ( std::size_t i = begin; i < end; ++i )
+                p [ i ] = search [ i ] + beta * p [ i ];
+        } );
+    }
+
+    report.residual  = scale > 0. ? std::sqrt ( rr ) / scale : std::sqrt ( rr );
+    report.converged = std::sqrt ( rr ) <= target;
+    return report;
+}
+
+krylov_report bicgstab ( linear_operator const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner, krylov_settings const& i_settings ) {
+    std::size_t const n = i_b.size ();
+    assert ( io_x.size () == n );
+    kernels k ( n, i_settings );
+
+    std::vector<double> r ( n ), shadow ( n ), p ( n, 0. ), v ( n, 0. ), t ( n ), hat_p ( n ), hat_s ( n );
+    double const scale  = std::sqrt ( k.dot ( i_b, i_b ) );
+    double const target = i_settings.tolerance * scale;
+
+    i_a ( io_x, t );
+    double rr = k.difference ( i_b, t, r );
+    shadow    = r;
+
+    double rho = 1., alpha = 1., omega = 1.;
+    krylov_report report;
+    while ( std::sqrt ( rr ) > target && report.iterations < i_settings.iterations ) {
+        double const next = k.dot ( shadow, r );
+        if ( next == 0. || omega == 0. )
+            break;
+        double const beta = ( next / rho ) * ( alpha / omega );
+        rho               = next;
+        k.apply ( [ & ] ( std::size_t begin, std::size_t end ) {
+            for ( std::size_t i = begin; i < end; ++i )
+                p [ i ] = r [ i ] + beta * ( p [ i ] - omega * v [ i ] );
+        } );
+
+        precondition ( i_preconditioner, p, hat_p );
+        i_a ( hat_p, v );
+        double const sv = k.dot ( shadow, v );
+        if ( sv == 0. )
+            break;
+        alpha = rho / sv;
+
+        // s = r - alpha v overwrites r
+        rr = k.axpy_dot ( -alpha, v, r, r );
+        ++report.iterations;
+        if ( std::sqrt ( rr ) <= target ) {
+            k.apply ( [ & ] ( std::size_t begin, std::size_t end ) {
+                for ( std::size_t i = begin; i < end; ++i )
+                    io_x [ i ] += alpha * hat_p [ i ];
+            } );
+            break;
+        }
+
+        precondition ( i_preconditioner, r, hat_s );
+        i_a ( hat_s, t );
+
+        auto const [ ts, tt ] = k.dots ( t, r, t );
+        omega                 = tt > 0. ? ts / tt : 0.;
+
+        // x += alpha p^ + omega s^, r = s - omega t and |r|^2 in one pass
+        rr = k.reduce ( [ & ] ( std::size_t begin, std::size_t end ) {
+            double s = 0.;
+            for ( std::size_t i = begin; i < end; ++i ) {
+                io_x [ i ] += alpha * hat_p [ i ] + omega * hat_s [ i ];
+                r [ i ] -= omega * t [ i ];
+                s += r [ i ] * r [ i ];
+            }
+            return s;
+        } );
+    }
+
+    report.residual  = scale > 0. ? std::sqrt ( rr ) / scale : std::sqrt ( rr );
+    report.converged = std::sqrt ( rr ) <= target;
+    return report;
+}
+
+krylov_report gmres ( linear_operator const& i_a, std::span<double const> i_b, std::span<double> io_x, linear_operator const& i_preconditioner, krylov_settings const& i_settings ) {
+    std::size_t const n = i_b.size (), m = std::max<std::size_t> ( 1, i_settings.restart );
+    assert ( io_x.size () == n );
+    kernels k ( n, i_settings );
+
+    // Krylov basis V (m + 1 rows of n), Hessenberg H column by column
+    std::vector<double> basis ( ( m + 1 ) * n ), w ( n ), z ( n );
+    std::vector<double> h ( ( m + 1 ) * m ), c ( m ), s ( m ), g ( m + 1 ), y ( m );
+    auto const V = [ & ] ( std::size_t j ) { return std::span<double> ( basis.data () + j * n, n ); };
+
+    double const scale  = std::sqrt ( k.dot ( i_b, i_b ) );
+    double const target = i_settings.tolerance * scale;
+    krylov_report report;
+    double residual = 0.;
+
+    for ( ;; ) {
+        i_a ( io_x, w );
+        residual = std::sqrt ( k.difference ( i_b, w, V ( 0 ) ) );
+        if ( residual <= target || report.iterations >= i_settings.iterations )
+            break;
+        k.scale ( 1. / residual, V ( 0 ), V ( 0 ) );
+        std::fill ( g.begin (), g.end (), 0. );
+        g [ 0 ] = residual;
+
+        std::size_t j = 0;
+        for ( ; j < m && report.iterations < i_settings.iterations; ) {
+            precondition ( i_preconditioner, V ( j ), z );
+            i_a ( z, w );
+
+            // modified Gram-Schmidt, each subtraction fused with the next dot
+            double* column = h.data () + j * ( m + 1 );
+            double d       = k.dot ( w, V ( 0 ) );
+            for ( std::size_t i = 0; i <= j; ++i ) {
+                column [ i ] = d;
+                d            = k.axpy_dot ( -column [ i ], V ( i ), w, i < j ? std::span<double const> ( V ( i + 1 ) ) : std::span<double const> ( w ) );
+            }
+            column [ j + 1 ] = std::sqrt ( d );
+
+            for ( std::size_t i = 0; i < j; ++i ) {
+                double const a = column [ i ], b = column [ i + 1 ];
+                column [ i ]     = c [ i ] * a + s [ i ] * b;
+                column [ i + 1 ] = -s [ i ] * a + c [ i ] * b;
+            }
+            double const norm = std::hypot ( column [ j ], column [ j + 1 ] );
+            c [ j ]           = norm > 0. ? column [ j ] / norm : 1.;
+            s [ j ]           = norm > 0. ? column [ j + 1 ] / norm : 0.;
+            double const next = column [ j + 1 ];
+            column [ j ]      = norm;
+            column [ j + 1 ]  = 0.;
+            g [ j + 1 ]       = -s [ j ] * g [ j ];
+            g [ j ]           = c [ j ] * g [ j ];
+
+            ++report.iterations;
+            ++j;
+            if ( std::abs ( g [ j ] ) <= target || next == 0. )
+                break;
+            k.scale ( 1. / next, w, V ( j ) );
+        }
+
+        // x += M^-1 V y with H y = g
+        for ( std::size_t i = j; i-- > 0; ) {
+            double t = g [ i ];
+            for ( std::size_t l = i + 1; l < j; ++l )
+                t -= h [ l * ( m + 1 ) + i ] * y [ l ];
+            y [ i ] = t / h [ i * ( m + 1 ) + i ];
+        }
+        k.apply ( [ & ] ( std::size_t begin, std::size_t end ) {
+            for ( std::size_t e = begin; e < end; ++e ) {
+                double t = 0.;
+                for ( std::size_t i = 0; i < j; ++i )
+                    t += y [ i ] * basis [ i * n + e ];
+                w [ e ] = t;
+            }
+        } );
+        precondition ( i_preconditioner, w, z );
+        k.apply ( [ & ] ( std::size_t begin, std::size_t end ) {
+            for ( std::size_t e = begin; e < end; ++e )
+                io_x [ e ] += z [ e ];
+        } );
+    }
+
+    report.residual  = scale > 0. ? residual / scale : residual;
+    report.converged = residual <= target;
+    return report;
+}
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
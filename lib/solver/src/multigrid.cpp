@@ -0,0 +1,436 @@
+/**
+ * \file  microstructure/lib/solver/src/multigrid.cpp
+ * \brief Geometric Multigrid for Poisson and Helmholtz Problems on Lattices
+ */
+
+#include "multigrid.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+namespace {
+
+    /** \brief Interior Range of an Axis; an Unused Axis is its Single Node */
+    inline std::size_t first ( std::size_t n ) { return n == 1 ? 0 : 1; }
+    inline std::size_t last ( std::size_t n ) { return n == 1 ? 1 : n - 1; }
+
+    inline std::size_t lines ( std::array<std::size_t, 3> const& n ) {
+        return ( last ( n [ 0 ] ) - first ( n [ 0 ] ) ) * ( last ( n [ 1 ] ) - first ( n [ 1 ] ) );
+    }
+
+    /** \brief Outer Coordinates (x0, x1) of Interior Line l */
+    inline std::array<std::size_t, 2> line ( std::array<std::size_t, 3> const& n, std::size_t l ) {
+        std::size_t const w = last ( n [ 1 ] ) - first ( n [ 1 ] );
+        return { first ( n [ 0 ] ) + l / w, first ( n [ 1 ] ) + l % w };
+    }
+
+    /** \brief Neighbour Weights 1 / h_a^2 (0 on an Unused Axis) and the Diagonal */
+    struct weights {
+        std::array<double, 3> neighbour;
+        double diagonal;
+    };
+
+    inline weights stencil ( std::array<std::size_t, 3> const& n, std::array<double, 3> const& h, double shift ) {
+        weights w { { 0., 0., 0. }, shift };
+        for ( std::size_t a = 0; a < 3; ++a )
+            if ( n [ a ] > 1 ) {
+                w.neighbour [ a ] = 1. / ( h [ a ] * h [ a ] );
+                w.diagonal += 2. * w.neighbour [ a ];
+            }
+        return w;
+    }
+
+    /** \brief Levels with fewer Interior Points run on the Calling Thread */
+    constexpr std::size_t parallel_points = 1 << 12;
+
+    /** \brief i_function ( begin, end ) over the Interior Lines of Extent n, Split over the Pool */
+    template <class FunctionT>
+    void for_lines ( worker_pool const& i_pool, std::array<std::size_t, 3> const& n, FunctionT&& i_function ) {
+        std::size_t const count   = lines ( n );
+        std::size_t const threads = std::min ( i_pool.size (), count );
+        if ( threads <= 1 || count * ( last ( n [ 2 ] ) - first ( n [ 2 ] ) ) < parallel_points ) {
+            i_function ( std::size_t { 0 }, count );
+            return;
+        }
+        std::size_t const chunk = ( count + threads - 1 ) / threads;
+        i_pool.run ( [ & ] ( std::size_t t ) {
+            std::size_t const begin = std::min ( t * chunk, count );
+            i_function ( begin, std::min ( begin + chunk, count ) );
+        } );
+    }
+
+} // namespace
+
+// ================================================================
+
+multigrid::multigrid ( std::span<std::size_t const> i_shape, double i_spacing, double i_shift, std::size_t i_threads )
+    : m_dimension { i_shape.size () }, m_shift { i_shift }, m_threads { concurrency ( i_threads ) } {
+    assert ( m_dimension >= 1 && m_dimension <= 3 && i_spacing > 0. && m_shift >= 0. );
+    m_pool = std::make_unique<worker_pool> ( m_threads );
+
+    level top;
+    top.extent = { 1, 1, 1 };
+    std::copy ( i_shape.begin (), i_shape.end (), top.extent.end () - m_dimension );
+    top.spacing = { i_spacing, i_spacing, i_spacing };
+
+    for ( level current = top;; ) {
+        current.stride = { current.extent [ 1 ] * current.extent [ 2 ], current.extent [ 2 ], 1 };
+        current.size   = current.extent [ 0 ] * current.stride [ 0 ];
+        current.r.assign ( current.size, 0. );
+        if ( !m_level.empty () ) {
+            current.u.assign ( current.size, 0. );
+            current.f.assign ( current.size, 0. );
+        }
+
+        // n - 1 cells become ceil((n - 1) / 2) wherever n >= 5
+        std::array<std::size_t, 3> coarse = current.extent;
+        bool coarsen                      = false;
+        for ( std::size_t a = 3 - m_dimension; a < 3; ++a )
+            if ( current.extent [ a ] >= 5 ) {
+                coarse [ a ] = current.extent [ a ] / 2 + 1;
+                coarsen      = true;
+            }
+        for ( std::size_t a = 0; a < 3; ++a )
+            current.map [ a ] = coarsen ? couple ( current.extent [ a ], coarse [ a ] ) : axis_map {};
+        m_level.push_back ( current );
+        if ( !coarsen )
+            break;
+
+        for ( std::size_t a = 3 - m_dimension; a < 3; ++a )
+            current.spacing [ a ] *= double ( current.extent [ a ] - 1 ) / double ( coarse [ a ] - 1 );
+        current.extent = coarse;
+    }
+
+    factorise ();
+    m_line.assign ( lines ( m_level.front ().extent ), 0. );
+}
+
+multigrid::axis_map multigrid::couple ( std::size_t i_fine, std::size_t i_coarse ) {
+    std::size_t const n = i_fine, m = i_coarse;
+    bool const identity = m == n;
+
+    axis_map map;
+    map.below.resize ( n );
+    map.above.resize ( n );
+    for ( std::size_t i = 0; i < n; ++i ) {
+        if ( identity ) {
+            map.below [ i ] = i;
+            map.above [ i ] = 0.;
+            continue;
+        }
+        // fine node i sits at coarse coordinate i (m - 1) / (n - 1)
+        std::size_t const position = i * ( m - 1 );
+        std::size_t const j        = std::min ( position / ( n - 1 ), m - 2 );
+        map.below [ i ]            = j;
+        map.above [ i ]            = double ( position - j * ( n - 1 ) ) / double ( n - 1 );
+    }
+
+    // restriction: the transpose scaled by h / H, so [1/4, 1/2, 1/4] for H = 2h
+    double const ratio = identity ? 1. : double ( m - 1 ) / double ( n - 1 );
+    map.start.assign ( m + 1, 0 );
+    for ( std::size_t i = 0; i < n; ++i ) {
+        ++map.start [ map.below [ i ] + 1 ];
+        if ( map.above [ i ] > 0. )
+            ++map.start [ map.below [ i ] + 2 ];
+    }
+    for ( std::size_t j = 0; j < m; ++j )
+        map.start [ j + 1 ] += map.start [ j ];
+
+    map.fine.resize ( map.start [ m ] );
+    map.share.resize ( map.start [ m ] );
+    std::vector<std::size_t> next ( map.start.begin (), map.start.end () - 1 );
+    for ( std::size_t i = 0; i < n; ++i ) {
+        std::size_t const j = map.below [ i ];
+        double const t      = map.above [ i ];
+        map.fine [ next [ j ] ]    = i;
+        map.share [ next [ j ]++ ] = ratio * ( 1. - t );
+        if ( t > 0. ) {
+            map.fine [ next [ j + 1 ] ]    = i;
+            map.share [ next [ j + 1 ]++ ] = ratio * t;
+        }
+    }
+    return map;
+}
+
+void multigrid::smoothing ( std::size_t i_pre, std::size_t i_post ) {
+    m_pre  = i_pre;
+    m_post = i_post;
+}
+
+// ================================================================
+
+multigrid_report multigrid::solve ( std::span<double> io_u, std::span<double const> i_f, double i_tolerance, std::size_t i_cycles ) {
+    assert ( io_u.size () == size () && i_f.size () == size () );
+
+    // |f| over the interior
+    auto const& n = m_level.front ().extent;
+    auto const& s = m_level.front ().stride;
+    double scale  = 0.;
+    for ( std::size_t l = 0; l < lines ( n ); ++l ) {
+        auto const [ x0, x1 ] = line ( n, l );
+        for ( std::size_t x2 = first ( n [ 2 ] ); x2 < last ( n [ 2 ] ); ++x2 ) {
+            double const v = i_f [ x0 * s [ 0 ] + x1 * s [ 1 ] + x2 ];
+            scale += v * v;
+        }
+    }
+    scale = std::sqrt ( scale );
+
+    multigrid_report report;
+    report.residual = residual ( io_u, i_f );
+    while ( report.residual > i_tolerance * scale && report.cycles < i_cycles ) {
+        cycle ( io_u, i_f );
+        ++report.cycles;
+        report.residual = residual ( io_u, i_f );
+    }
+    report.residual  = scale > 0. ? report.residual / scale : report.residual;
+    report.converged = report.residual <= i_tolerance;
+    return report;
+}
+
+void multigrid::cycle ( std::span<double> io_u, std::span<double const> i_f ) {
+    assert ( io_u.size () == size () && i_f.size () == size () );
+    recurse ( 0, io_u.data (), i_f.data () );
+}
+
+double multigrid::residual ( std::span<double const> i_u, std::span<double const> i_f ) const {
+    assert ( i_u.size () == size () && i_f.size () == size () );
+    return std::sqrt ( defect_norm ( i_u.data (), i_f.data () ) );
+}
+
+// ================================================================
+
+void multigrid::recurse ( std::size_t i_level, double* io_u, double const* i_f ) {
+    level& current = m_level [ i_level ];
+    if ( i_level + 1 == m_level.size () ) {
+        direct ( current, io_u, i_f );
+        return;
+    }
+
+    smooth ( current, io_u, i_f, m_pre );
+    defect ( current, io_u, i_f, current.r.data () );
+
+    level& coarse = m_level [ i_level + 1 ];
+    restriction ( current, current.r.data (), coarse );
+    std::fill ( coarse.u.begin (), coarse.u.end (), 0. );
+    for ( std::size_t g = 0; g < static_cast<std::size_t> ( m_shape ); ++g )
+        recurse ( i_level + 1, coarse.u.data (), coarse.f.data () );
+
+    prolongation ( coarse, current, io_u );
+    smooth ( current, io_u, i_f, m_post );
+}
+
+void multigrid::smooth ( level const& i_level, double* io_u, double const* i_f, std::size_t i_sweeps ) const {
+    auto const& n = i_level.extent;
+    auto const& s = i_level.stride;
+    auto const [ w, diagonal ] = stencil ( i_level.extent, i_level.spacing, m_shift );
+
+    for ( std::size_t sweep = 0; sweep < i_sweeps; ++sweep )
+        for ( std::size_t colour = 0; colour < 2; ++colour )
+            for_lines ( *m_pool, n, [ & ] ( std::size_t begin, std::size_t end ) {
+                for ( std::size_t l = begin; l < end; ++l ) {
+                    auto const [ x0, x1 ] = line ( n, l );
+                    std::size_t const base = x0 * s [ 0 ] + x1 * s [ 1 ];
+                    std::size_t x2         = first ( n [ 2 ] );
+                    if ( ( x0 + x1 + x2 ) % 2 != colour )
+                        ++x2;
+                    for ( ; x2 < last ( n [ 2 ] ); x2 += 2 ) {
+                        std::size_t const i = base + x2;
+                        double sum          = w [ 2 ] * ( io_u [ i - 1 ] + io_u [ i + 1 ] );
+                        if ( n [ 1 ] > 1 )
+                            sum += w [ 1 ] * ( io_u [ i - s [ 1 ] ] + io_u [ i + s [ 1 ] ] );
+                        if ( n [ 0 ] > 1 )
+                            sum += w [ 0 ] * ( io_u [ i - s [ 0 ] ] + io_u [ i + s [ 0 ] ] );
+                        io_u [ i ] = ( i_f [ i ] + sum ) / diagonal;
+                    }
+                }
+            } );
+}
+
+void multigrid::defect ( level const& i_level, double const* i_u, double const* i_f, double* o_r ) const {
+    auto const& n = i_level.extent;
+    auto const& s = i_level.stride;
+    auto const [ w, diagonal ] = stencil ( i_level.extent, i_level.spacing, m_shift );
+
+    for_lines ( *m_pool, n, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t l = begin; l < end; ++l ) {
+            auto const [ x0, x1 ] = line ( n, l );
+            std::size_t const base = x0 * s [ 0 ] + x1 * s [ 1 ];
+            for ( std::size_t x2 = first ( n [ 2 ] ); x2 < last ( n [ 2 ] ); ++x2 ) {
+                std::size_t const i = base + x2;
+                double sum          = w [ 2 ] * ( i_u [ i - 1 ] + i_u [ i + 1 ] );
+                if ( n [ 1 ] > 1 )
+                    sum += w [ 1 ] * ( i_u [ i - s [ 1 ] ] + i_u [ i + s [ 1 ] ] );
+                if ( n [ 0 ] > 1 )
+                    sum += w [ 0 ] * ( i_u [ i - s [ 0 ] ] + i_u [ i + s [ 0 ] ] );
+                o_r [ i ] = i_f [ i ] - ( diagonal * i_u [ i ] - sum );
+            }
+        }
+    } );
+}
+
+double multigrid::defect_norm ( double const* i_u, double const* i_f ) const {
+    level const& top = m_level.front ();
+    auto const& n    = top.extent;
+    auto const& s    = top.stride;
+    auto const [ w, diagonal ] = stencil ( top.extent, top.spacing, m_shift );
+
+    for_lines ( *m_pool, n, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t l = begin; l < end; ++l ) {
+            auto const [ x0, x1 ] = line ( n, l );
+            std::size_t const base = x0 * s [ 0 ] + x1 * s [ 1 ];
+            double squares         = 0.;
+            for ( std::size_t x2 = first ( n [ 2 ] ); x2 < last ( n [ 2 ] ); ++x2 ) {
+                std::size_t const i = base + x2;
+                double sum          = w [ 2 ] * ( i_u [ i - 1 ] + i_u [ i + 1 ] );
+                if ( n [ 1 ] > 1 )
+                    sum += w [ 1 ] * ( i_u [ i - s [ 1 ] ] + i_u [ i + s [ 1 ] ] );
+                if ( n [ 0 ] > 1 )
+                    sum += w [ 0 ] * ( i_u [ i - s [ 0 ] ] + i_u [ i + s [ 0 ] ] );
+                double const r = i_f [ i ] - ( diagonal * i_u [ i ] - sum );
+                squares += r * r;
+            }
+            m_line [ l ] = squares;
+        }
+    } );
+
+    double squares = 0.;
+    for ( double const v : m_line )
+        squares += v;
+    return squares;
+}
+
+/**
+ * \brief Scaled Transpose of the Prolongation, one Axis at a Time
+ */
+
+void multigrid::restriction ( level const& i_fine, double const* i_r, level& o_coarse ) const {
+    auto const& n  = o_coarse.extent;
+    auto const& s  = o_coarse.stride;
+    auto const& fs = i_fine.stride;
+    auto const& m  = i_fine.map;
+
+    for_lines ( *m_pool, n, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t l = begin; l < end; ++l ) {
+            auto const [ x0, x1 ] = line ( n, l );
+            for ( std::size_t x2 = first ( n [ 2 ] ); x2 < last ( n [ 2 ] ); ++x2 ) {
+                double sum = 0.;
+                for ( std::size_t k0 = m [ 0 ].start [ x0 ]; k0 < m [ 0 ].start [ x0 + 1 ]; ++k0 )
+                    for ( std::size_t k1 = m [ 1 ].start [ x1 ]; k1 < m [ 1 ].start [ x1 + 1 ]; ++k1 ) {
+                        std::size_t const base = m [ 0 ].fine [ k0 ] * fs [ 0 ] + m [ 1 ].fine [ k1 ] * fs [ 1 ];
+                        double const w         = m [ 0 ].share [ k0 ] * m [ 1 ].share [ k1 ];
+                        for ( std::size_t k2 = m [ 2 ].start [ x2 ]; k2 < m [ 2 ].start [ x2 + 1 ]; ++k2 )
+                            sum += w * m [ 2 ].share [ k2 ] * i_r [ base + m [ 2 ].fine [ k2 ] ];
+                    }
+                o_coarse.f [ x0 * s [ 0 ] + x1 * s [ 1 ] + x2 ] = sum;
+            }
+        }
+    } );
+}
+
+/**
+ * \brief Linear Interpolation per Axis between the Two Nearest Coarse Nodes
+ */
+
+void multigrid::prolongation ( level const& i_coarse, level const& i_fine, double* io_u ) const {
+    auto const& n  = i_fine.extent;
+    auto const& s  = i_fine.stride;
+    auto const& cs = i_coarse.stride;
+    auto const& m  = i_fine.map;
+
+    for_lines ( *m_pool, n, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t l = begin; l < end; ++l ) {
+            auto const [ x0, x1 ] = line ( n, l );
+            for ( std::size_t x2 = first ( n [ 2 ] ); x2 < last ( n [ 2 ] ); ++x2 ) {
+                std::array<std::size_t, 3> const x { x0, x1, x2 };
+
+                double sum = 0.;
+                for ( std::size_t corner = 0; corner < 8; ++corner ) {
+                    std::size_t i = 0;
+                    double w     = 1.;
+                    for ( std::size_t a = 0; a < 3; ++a ) {
+                        std::size_t const bit = ( corner >> a ) & 1;
+                        double const t        = m [ a ].above [ x [ a ] ];
+                        w *= bit == 0 ? 1. - t : t;
+                        i += ( m [ a ].below [ x [ a ] ] + bit ) * cs [ a ];
+                    }
+                    if ( w > 0. )
+                        sum += w * i_coarse.u [ i ];
+                }
+                io_u [ x0 * s [ 0 ] + x1 * s [ 1 ] + x2 ] += sum;
+            }
+        }
+    } );
+}
+
+// ================================================================
+
+void multigrid::factorise () {
+    level const& coarsest = m_level.back ();
+    auto const& n         = coarsest.extent;
+    auto const& s         = coarsest.stride;
+    auto const [ w, diagonal ] = stencil ( coarsest.extent, coarsest.spacing, m_shift );
+
+    m_unknown.clear ();
+    for ( std::size_t l = 0; l < lines ( n ); ++l ) {
+        auto const [ x0, x1 ] = line ( n, l );
+        for ( std::size_t x2 = first ( n [ 2 ] ); x2 < last ( n [ 2 ] ); ++x2 )
+            m_unknown.push_back ( x0 * s [ 0 ] + x1 * s [ 1 ] + x2 );
+    }
+    std::size_t const k = m_unknown.size ();
+
+    // the interior operator; boundary neighbours are data, not unknowns
+    m_factor.assign ( k * k, 0. );
+    for ( std::size_t p = 0; p < k; ++p ) {
+        m_factor [ p * k + p ] = diagonal;
+        for ( std::size_t q = 0; q < p; ++q )
+            for ( std::size_t a = 0; a < 3; ++a )
+                if ( n [ a ] > 1 && m_unknown [ p ] - m_unknown [ q ] == s [ a ] )
+                    m_factor [ p * k + q ] = -w [ a ];
+    }
+
+    // in-place Cholesky, lower triangle: A = L L^T
+    for ( std::size_t j = 0; j < k; ++j ) {
+        double d = m_factor [ j * k + j ];
+        for ( std::size_t c = 0; c < j; ++c )
+            d -= m_factor [ j * k + c ] * m_factor [ j * k + c ];
+        assert ( d > 0. );
+        m_factor [ j * k + j ] = std::sqrt ( d );
+        for ( std::size_t i = j + 1; i < k; ++i ) {
+            double v = m_factor [ i * k + j ];
+            for ( std::size_t c = 0; c < j; ++c )
+                v -= m_factor [ i * k + c ] * m_factor [ j * k + c ];
+            m_factor [ i * k + j ] = v / m_factor [ j * k + j ];
+        }
+    }
+    m_rhs.assign ( k, 0. );
+}
+
+void multigrid::direct ( level& io_level, double* io_u, double const* i_f ) {
+    defect ( io_level, io_u, i_f, io_level.r.data () );
+
+    std::size_t const k = m_unknown.size ();
+    for ( std::size_t i = 0; i < k; ++i ) {
+        double v = io_level.r [ m_unknown [ i ] ];
+        for ( std::size_t c = 0; c < i; ++c )
+            v -= m_factor [ i * k + c ] * m_rhs [ c ];
+        m_rhs [ i ] = v / m_factor [ i * k + i ];
+    }
+    for ( std::size_t i = k; i-- > 0; ) {
+        double v = m_rhs [ i ];
+        for ( std::size_t c = i + 1; c < k; ++c )
+            v -= m_factor [ c * k + i ] * m_rhs [ c ];
+        m_rhs [ i ] = v / m_factor [ i * k + i ];
+    }
+    for ( std::size_t i = 0; i < k; ++i )
+        io_u [ m_unknown [ i ] ] += m_rhs [ i ];
+}
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
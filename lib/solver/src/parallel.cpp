@@ -0,0 +1,92 @@
+/**
+ * \file  microstructure/lib/solver/src/parallel.cpp
+ * \brief Pinned Worker Pool
+ */
+
+#include "parallel.hpp"
+
+#if defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+worker_pool::worker_pool ( std::size_t i_threads )
+    : m_size { concurrency ( i_threads ) } {
+    if ( m_size == 1 )
+        return;
+
+    m_worker.reserve ( m_size );
+    for ( std::size_t t = 0; t < m_size; ++t )
+        m_worker.emplace_back ( [ this, t ] { work ( t ); } );
+
+#if defined( __linux__ )
+    // CPUs of the process mask in order; a failed call leaves the thread free
+    cpu_set_t allowed;
+    CPU_ZERO ( &allowed );
+    if ( sched_getaffinity ( 0, sizeof ( allowed ), &allowed ) != 0 )
+        return;
+    std::vector<int> cpu;
+    for ( int c = 0; c < CPU_SETSIZE; ++c )
+        if ( CPU_ISSET ( c, &allowed ) )
+            cpu.push_back ( c );
+    if ( cpu.empty () )
+        return;
+
+    for ( std::size_t t = 0; t < m_size; ++t ) {
+        cpu_set_t one;
+        CPU_ZERO ( &one );
+        CPU_SET ( cpu [ t % cpu.size () ], &one );
+        pthread_setaffinity_np ( m_worker [ t ].native_handle (), sizeof ( one ), &one );
+    }
+#endif
+}
+
+worker_pool::~worker_pool () {
+    {
+        std::lock_guard lock { m_mutex };
+        m_stop = true;
+    }
+    m_wake.notify_all ();
+}
+
+void worker_pool::dispatch ( task_type i_task, void const* i_context ) const {
+    std::lock_guard call { m_call };
+    std::unique_lock lock { m_mutex };
+    m_task    = i_task;
+    m_context = i_context;
+    m_pending = m_size;
+    ++m_generation;
+    lock.unlock ();
+    m_wake.notify_all ();
+
+    lock.lock ();
+    m_done.wait ( lock, [ this ] { return m_pending == 0; } );
+}
+
+void worker_pool::work ( std::size_t i_worker ) {
+    std::size_t seen = 0;
+    for ( ;; ) {
+        std::unique_lock lock { m_mutex };
+        m_wake.wait ( lock, [ & ] { return m_stop || m_generation != seen; } );
+        if ( m_stop )
+            return;
+        seen = m_generation;
+        auto const task = m_task;
+        auto const context = m_context;
+        lock.unlock ();
+
+        task ( context, i_worker );
+
+        lock.lock ();
+        if ( --m_pending == 0 )
+            m_done.notify_one ();
+    }
+}
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
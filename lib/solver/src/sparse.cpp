@@ -0,0 +1,307 @@
+/**
+ * \file  microstructure/lib/solver/src/sparse.cpp
+ * \brief Sparse Matrix Storage (CSR, SELL-C-sigma, BCSR) and Multithreaded SpMV
+ */
+
+#include "sparse.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <utility>
+
+namespace microstructure {
+namespace libraries {
+namespace solver {
+
+namespace {
+
+    struct compressed {
+        std::vector<std::size_t> offset;
+        std::vector<std::size_t> index;
+        std::vector<double> value;
+    };
+
+    /**
+     * \brief Row-Sorted Entries with Sorted Columns, Repeats Summed
+     * \note  Counting sort on rows, then a sort of each (short) row
+     */
+
+    compressed compress ( coordinate_matrix const& i_assembly ) {
+        auto const row = i_assembly.row_indices ();
+        auto const column = i_assembly.column_indices ();
+        auto const value = i_assembly.values ();
+
+        std::vector<std::size_t> offset ( i_assembly.rows () + 1, 0 );
+        for ( std::size_t const r : row )
+            ++offset [ r + 1 ];
+        std::partial_sum ( offset.begin (), offset.end (), offset.begin () );
+
+        std::vector<std::pair<std::size_t, double>> entry ( value.size () );
+        std::vector<std::size_t> cursor ( offset.begin (), offset.end () - 1 );
+        for ( std::size_t e = 0; e < value.size (); ++e )
+            entry [ cursor [ row [ e ] ]++ ] = { column [ e ], value [ e ] };
+
+        compressed o;
+        o.offset.assign ( i_assembly.rows () + 1, 0 );
+        o.index.reserve ( entry.size () );
+        o.value.reserve ( entry.size () );
+        for ( std::size_t r = 0; r < i_assembly.rows (); ++r ) {
+            auto const first = entry.begin () + std::ptrdiff_t ( offset [ r ] );
+            auto const last  = entry.begin () + std::ptrdiff_t ( offset [ r + 1 ] );
+            std::sort ( first, last, [] ( auto const& a, auto const& b ) { return a.first < b.first; } );
+            for ( auto e = first; e != last; ++e )
+                if ( o.index.size () > o.offset [ r ] && o.index.back () == e->first )
+                    o.value.back () += e->second;
+                else {
+                    o.index.push_back ( e->first );
+                    o.value.push_back ( e->second );
+                }
+            o.offset [ r + 1 ] = o.index.size ();
+        }
+        return o;
+    }
+
+    /**
+     * \brief Split Rows (or Chunks) into i_parts Ranges of about Equal Work,
+     *        i_offset being the Running Work Count
+     */
+
+    template <class OffsetT>
+    std::vector<std::size_t> balance ( OffsetT const& i_offset, std::size_t i_count, std::size_t i_parts ) {
+        std::size_t const total = i_offset [ i_count ];
+        std::vector<std::size_t> partition ( i_parts + 1, i_count );
+        partition [ 0 ] = 0;
+        for ( std::size_t t = 1; t < i_parts; ++t ) {
+            std::size_t const target = ( total * t + i_parts - 1 ) / i_parts;
+            std::size_t r = partition [ t - 1 ];
+            while ( r < i_count && i_offset [ r ] < target )
+                ++r;
+            partition [ t ] = r;
+        }
+        return partition;
+    }
+
+    /** \brief i_function ( begin, end ) on each Range of i_partition, Range t on Worker t */
+    template <class FunctionT>
+    void distribute ( worker_pool const& i_pool, std::vector<std::size_t> const& i_partition, FunctionT&& i_function ) {
+        assert ( i_pool.size () + 1 == i_partition.size () );
+        i_pool.run ( [ & ] ( std::size_t t ) { i_function ( i_partition [ t ], i_partition [ t + 1 ] ); } );
+    }
+
+    /** \brief y = A x over Block Rows [i_begin, i_end); B = 0 for a Runtime Block Size */
+    template <std::size_t B>
+    void block_product ( std::size_t const* i_offset, std::size_t const* i_index, double const* i_value, std::size_t i_block, double const* i_x, double* o_y, std::size_t i_begin, std::size_t i_end ) {
+        std::size_t const b = B ? B : i_block;
+        for ( std::size_t r = i_begin; r < i_end; ++r ) {
+            double* y = o_y + r * b;
+            for ( std::size_t p = 0; p < b; ++p )
+                y [ p ] = 0.;
+            for ( std::size_t k = i_offset [ r ]; k < i_offset [ r + 1 ]; ++k ) {
+                double const* a = i_value + k * b * b;
+                double const* x = i_x + i_index [ k ] * b;
+                for ( std::size_t p = 0; p < b; ++p )
+                    for ( std::size_t q = 0; q < b; ++q )
+                        y [ p ] += a [ p * b + q ] * x [ q ];
+            }
+        }
+    }
+
+} // namespace
+
+// ================================================================
+
+coordinate_matrix::coordinate_matrix ( std::size_t i_rows, std::size_t i_columns )
+    : m_rows { i_rows }, m_columns { i_columns } {}
+
+void coordinate_matrix::reserve ( std::size_t i_entries ) {
+    m_row.reserve ( i_entries );
+    m_column.reserve ( i_entries );
+    m_value.reserve ( i_entries );
+}
+
+void coordinate_matrix::add ( std::size_t i_row, std::size_t i_column, double i_value ) {
+    assert ( i_row < m_rows && i_column < m_columns );
+    m_row.push_back ( i_row );
+    m_column.push_back ( i_column );
+    m_value.push_back ( i_value );
+}
+
+void coordinate_matrix::clear () {
+    m_row.clear ();
+    m_column.clear ();
+    m_value.clear ();
+}
+
+// ================================================================
+
+csr_matrix::csr_matrix ( coordinate_matrix const& i_assembly, std::size_t i_threads )
+    : m_rows { i_assembly.rows () }, m_columns { i_assembly.columns () } {
+    auto const c = compress ( i_assembly );
+    m_partition  = balance ( c.offset, m_rows, concurrency ( i_threads ) );
+    m_pool       = std::make_unique<worker_pool> ( m_partition.size () - 1 );
+
+    m_offset = numa_array<std::size_t> ( m_rows + 1 );
+    m_index  = numa_array<std::size_t> ( c.index.size () );
+    m_value  = numa_array<double> ( c.value.size () );
+    distribute ( *m_pool, m_partition, [ & ] ( std::size_t begin, std::size_t end ) {
+        std::copy ( c.offset.begin () + std::ptrdiff_t ( begin ), c.offset.begin () + std::ptrdiff_t ( end ), m_offset.data () + begin );
+        for ( std::size_t k = c.offset [ begin ]; k < c.offset [ end ]; ++k ) {
+            m_index [ k ] = c.index [ k ];
+            m_value [ k ] = c.value [ k ];
+        }
+    } );
+    m_offset [ m_rows ] = c.offset [ m_rows ];
+}
+
+void csr_matrix::multiply ( std::span<double const> i_x, std::span<double> o_y ) const {
+    assert ( i_x.size () == m_columns && o_y.size () == m_rows );
+    distribute ( *m_pool, m_partition, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t r = begin; r < end; ++r ) {
+            double sum = 0.;
+            for ( std::size_t k = m_offset [ r ]; k < m_offset [ r + 1 ]; ++k )
+                sum += m_value [ k ] * i_x [ m_index [ k ] ];
+            o_y [ r ] = sum;
+        }
+    } );
+}
+
+void csr_matrix::diagonal ( std::span<double> o_diagonal ) const {
+    assert ( o_diagonal.size () == m_rows );
+    for ( std::size_t r = 0; r < m_rows; ++r ) {
+        auto const first = m_index.data () + m_offset [ r ], last = m_index.data () + m_offset [ r + 1 ];
+        auto const k     = std::lower_bound ( first, last, r );
+        o_diagonal [ r ] = k != last && *k == r ? m_value [ std::size_t ( k - m_index.data () ) ] : 0.;
+    }
+}
+
+// ================================================================
+
+sell_matrix::sell_matrix ( coordinate_matrix const& i_assembly, std::size_t i_sigma, std::size_t i_threads )
+    : m_rows { i_assembly.rows () }, m_columns { i_assembly.columns () } {
+    auto const c = compress ( i_assembly );
+    m_nonzeros   = c.index.size ();
+
+    std::size_t const chunks = ( m_rows + chunk - 1 ) / chunk, padded = chunks * chunk;
+    std::size_t const sigma  = std::max<std::size_t> ( chunk, ( i_sigma + chunk - 1 ) / chunk * chunk );
+    auto const length        = [ & ] ( std::size_t r ) { return r < m_rows ? c.offset [ r + 1 ] - c.offset [ r ] : 0; };
+
+    // longest rows first within each window; padded rows are empty
+    std::vector<std::size_t> permutation ( padded );
+    std::iota ( permutation.begin (), permutation.end (), 0 );
+    for ( std::size_t w = 0; w < padded; w += sigma )
+        std::stable_sort ( permutation.begin () + std::ptrdiff_t ( w ), permutation.begin () + std::ptrdiff_t ( std::min ( w + sigma, padded ) ),
+                           [ & ] ( std::size_t a, std::size_t b ) { return length ( a ) > length ( b ); } );
+
+    std::vector<std::size_t> offset ( chunks + 1, 0 );
+    for ( std::size_t k = 0; k < chunks; ++k )
+        offset [ k + 1 ] = offset [ k ] + chunk * length ( permutation [ k * chunk ] );
+    m_partition = balance ( offset, chunks, concurrency ( i_threads ) );
+    m_pool      = std::make_unique<worker_pool> ( m_partition.size () - 1 );
+
+    m_permutation = numa_array<std::size_t> ( padded );
+    m_offset      = numa_array<std::size_t> ( chunks + 1 );
+    m_length      = numa_array<std::size_t> ( chunks );
+    m_index       = numa_array<std::size_t> ( offset [ chunks ] );
+    m_value       = numa_array<double> ( offset [ chunks ] );
+    distribute ( *m_pool, m_partition, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t k = begin; k < end; ++k ) {
+            std::size_t const width = length ( permutation [ k * chunk ] );
+            m_offset [ k ] = offset [ k ];
+            m_length [ k ] = width;
+            for ( std::size_t q = 0; q < chunk; ++q ) {
+                std::size_t const r = permutation [ k * chunk + q ];
+                m_permutation [ k * chunk + q ] = r;
+                for ( std::size_t j = 0; j < width; ++j ) {
+                    std::size_t const s = offset [ k ] + j * chunk + q;
+                    bool const stored   = j < length ( r );
+                    m_index [ s ]       = stored ? c.index [ c.offset [ r ] + j ] : 0;
+                    m_value [ s ]       = stored ? c.value [ c.offset [ r ] + j ] : 0.;
+                }
+            }
+        }
+    } );
+    m_offset [ chunks ] = offset [ chunks ];
+}
+
+void sell_matrix::multiply ( std::span<double const> i_x, std::span<double> o_y ) const {
+    assert ( i_x.size () == m_columns && o_y.size () == m_rows );
+    distribute ( *m_pool, m_partition, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t k = begin; k < end; ++k ) {
+            double sum [ chunk ] = {};
+            std::size_t const* index = m_index.data () + m_offset [ k ];
+            double const* value      = m_value.data () + m_offset [ k ];
+            for ( std::size_t j = 0; j < m_length [ k ]; ++j )
+                for ( std::size_t q = 0; q < chunk; ++q )
+                    sum [ q ] += value [ j * chunk + q ] * i_x [ index [ j * chunk + q ] ];
+            for ( std::size_t q = 0; q < chunk; ++q )
+                if ( std::size_t const r = m_permutation [ k * chunk + q ]; r < m_rows )
+                    o_y [ r ] = sum [ q ];
+        }
+    } );
+}
+
+double sell_matrix::fill () const {
+    std::size_t const stored = m_value.size ();
+    return stored > 0 ? double ( m_nonzeros ) / double ( stored ) : 1.;
+}
+
+// ================================================================
+
+bcsr_matrix::bcsr_matrix ( coordinate_matrix const& i_assembly, std::size_t i_block, std::size_t i_threads )
+    : m_rows { i_assembly.rows () }, m_columns { i_assembly.columns () }, m_block { i_block } {
+    assert ( m_block > 0 && m_rows % m_block == 0 && m_columns % m_block == 0 );
+    auto const c            = compress ( i_assembly );
+    std::size_t const b     = m_block, rows = m_rows / b, area = b * b;
+
+    // block columns of block row R: the union of its b scalar rows
+    std::vector<std::size_t> offset ( rows + 1, 0 ), index;
+    for ( std::size_t R = 0; R < rows; ++R ) {
+        std::size_t const start = index.size ();
+        for ( std::size_t k = c.offset [ R * b ]; k < c.offset [ R * b + b ]; ++k )
+            index.push_back ( c.index [ k ] / b );
+        std::sort ( index.begin () + std::ptrdiff_t ( start ), index.end () );
+        index.erase ( std::unique ( index.begin () + std::ptrdiff_t ( start ), index.end () ), index.end () );
+        offset [ R + 1 ] = index.size ();
+    }
+    m_partition = balance ( offset, rows, concurrency ( i_threads ) );
+    m_pool      = std::make_unique<worker_pool> ( m_partition.size () - 1 );
+
+    m_offset = numa_array<std::size_t> ( rows + 1 );
+    m_index  = numa_array<std::size_t> ( index.size () );
+    m_value  = numa_array<double> ( index.size () * area );
+    distribute ( *m_pool, m_partition, [ & ] ( std::size_t begin, std::size_t end ) {
+        for ( std::size_t R = begin; R < end; ++R ) {
+            m_offset [ R ] = offset [ R ];
+            for ( std::size_t k = offset [ R ]; k < offset [ R + 1 ]; ++k ) {
+                m_index [ k ] = index [ k ];
+                std::fill ( m_value.data () + k * area, m_value.data () + ( k + 1 ) * area, 0. );
+            }
+            for ( std::size_t p = 0; p < b; ++p )
+                for ( std::size_t k = c.offset [ R * b + p ]; k < c.offset [ R * b + p + 1 ]; ++k ) {
+                    auto const at = std::lower_bound ( index.begin () + std::ptrdiff_t ( offset [ R ] ), index.begin () + std::ptrdiff_t ( offset [ R + 1 ] ), c.index [ k ] / b );
+                    m_value [ std::size_t ( at - index.begin () ) * area + p * b + c.index [ k ] % b ] = c.value [ k ];
+                }
+        }
+    } );
+    m_offset [ rows ] = offset [ rows ];
+}
+
+void bcsr_matrix::multiply ( std::span<double const> i_x, std::span<double> o_y ) const {
+    assert ( i_x.size () == m_columns && o_y.size () == m_rows );
+    distribute ( *m_pool, m_partition, [ & ] ( std::size_t begin, std::size_t end ) {
+        auto const product = [ & ] ( auto kernel ) { kernel ( m_offset.data (), m_index.data (), m_value.data (), m_block, i_x.data (), o_y.data (), begin, end ); };
+        switch ( m_block ) {
+            case 1: product ( block_product<1> ); break;
+            case 2: product ( block_product<2> ); break;
+            case 3: product ( block_product<3> ); break;
+            case 4: product ( block_product<4> ); break;
+            default: product ( block_product<0> ); break;
+        }
+    } );
+}
+
+} // namespace solver
+} // namespace libraries
+} // namespace microstructure
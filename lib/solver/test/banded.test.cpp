@@ -0,0 +1,101 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <solver/solver.hpp>
+
+namespace solver = microstructure::libraries::solver;
+
+namespace {
+
+    /** \brief Diagonally Dominant Random Bands, Interleaved, with the Exact Solution x */
+    struct batch {
+        std::vector<std::vector<double>> band;
+        std::vector<double> rhs;
+        std::vector<double> x;
+    };
+
+    batch random ( std::size_t bands, std::size_t n, std::size_t m, unsigned seed ) {
+        std::mt19937 engine ( seed );
+        std::uniform_real_distribution<double> u ( -1., 1. );
+        std::size_t const centre = bands / 2;
+
+        batch o { std::vector<std::vector<double>> ( bands, std::vector<double> ( n * m ) ), std::vector<double> ( n * m, 0. ), std::vector<double> ( n * m ) };
+        for ( auto& v : o.x )
+            v = u ( engine );
+        for ( std::size_t k = 0; k < bands; ++k )
+            for ( auto& v : o.band [ k ] )
+                v = k == centre ? double ( bands ) + 1. + u ( engine ) : u ( engine );
+
+        // rhs = A x over the bands that fall inside the matrix
+        for ( std::size_t i = 0; i < n; ++i )
+            for ( std::size_t s = 0; s < m; ++s )
+                for ( std::size_t k = 0; k < bands; ++k ) {
+                    std::ptrdiff_t const j = std::ptrdiff_t ( i + k ) - std::ptrdiff_t ( centre );
+                    if ( j >= 0 && j < std::ptrdiff_t ( n ) )
+                        o.rhs [ i * m + s ] += o.band [ k ] [ i * m + s ] * o.x [ std::size_t ( j ) * m + s ];
+                }
+        return o;
+    }
+
+} // namespace
+
+TEST ( banded_test, thomas_and_cyclic_reduction_solve_tridiagonal_batches ) {
+    for ( std::size_t const n : { 1, 2, 3, 7, 8, 64, 100, 257 } )
+        for ( std::size_t const m : { 1, 5, 64, 131 } ) {
+            auto const p = random ( 3, n, m, unsigned ( n * 1000 + m ) );
+
+            auto x = p.rhs;
+            solver::tridiagonal_thomas ( p.band [ 0 ], p.band [ 1 ], p.band [ 2 ], x, n, m, 3 );
+            for ( std::size_t i = 0; i < n * m; ++i )
+                EXPECT_NEAR ( x [ i ], p.x [ i ], 1e-12 ) << "thomas n = " << n << ", m = " << m;
+
+            x = p.rhs;
+            solver::tridiagonal_cyclic_reduction ( p.band [ 0 ], p.band [ 1 ], p.band [ 2 ], x, n, m, 3 );
+            for ( std::size_t i = 0; i < n * m; ++i )
+                EXPECT_NEAR ( x [ i ], p.x [ i ], 1e-12 ) << "cyclic reduction n = " << n << ", m = " << m;
+        }
+}
+
+TEST ( banded_test, pentadiagonal_thomas_solves_batches ) {
+    for ( std::size_t const n : { 1, 2, 3, 4, 50, 301 } )
+        for ( std::size_t const m : { 1, 9, 200 } ) {
+            auto const p = random ( 5, n, m, unsigned ( n + 7 * m ) );
+            auto x       = p.rhs;
+            solver::pentadiagonal_thomas ( p.band [ 0 ], p.band [ 1 ], p.band [ 2 ], p.band [ 3 ], p.band [ 4 ], x, n, m, 2 );
+            for ( std::size_t i = 0; i < n * m; ++i )
+                EXPECT_NEAR ( x [ i ], p.x [ i ], 1e-12 ) << "n = " << n << ", m = " << m;
+        }
+}
+
+TEST ( banded_test, implicit_diffusion_step_along_the_first_axis ) {
+    // (1 - r d^2/dx^2) u = u0 on the lines along axis 0 of a 40 x 33 lattice
+    std::size_t const n = 40, m = 33;
+    double const r = 0.8;
+    std::vector<double> lower ( n * m, -r ), diagonal ( n * m, 1. + 2. * r ), upper ( n * m, -r ), u ( n * m );
+    for ( std::size_t i = 0; i < n; ++i )
+        for ( std::size_t s = 0; s < m; ++s )
+            u [ i * m + s ] = std::sin ( 0.3 * double ( i ) ) + double ( s );
+    auto const u0 = u;
+
+    solver::tridiagonal_thomas ( lower, diagonal, upper, u, n, m );
+    for ( std::size_t i = 0; i < n; ++i )
+        for ( std::size_t s = 0; s < m; ++s ) {
+            double const left = i > 0 ? u [ ( i - 1 ) * m + s ] : 0., right = i + 1 < n ? u [ ( i + 1 ) * m + s ] : 0.;
+            EXPECT_NEAR ( ( 1. + 2. * r ) * u [ i * m + s ] - r * ( left + right ), u0 [ i * m + s ], 1e-12 );
+        }
+}
+
+TEST ( banded_test, interleave_round_trip ) {
+    std::size_t const n = 6, m = 4;
+    std::vector<double> lines ( n * m ), batch ( n * m ), back ( n * m );
+    for ( std::size_t i = 0; i < n * m; ++i )
+        lines [ i ] = double ( i );
+
+    solver::interleave ( lines, batch, n, m );
+    EXPECT_EQ ( batch [ 1 * m + 2 ], lines [ 2 * n + 1 ] );
+    solver::deinterleave ( batch, back, n, m );
+    EXPECT_EQ ( back, lines );
+}
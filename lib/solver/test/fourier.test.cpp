@@ -0,0 +1,145 @@
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <solver/solver.hpp>
+
+namespace solver = microstructure::libraries::solver;
+
+namespace {
+
+    /** \brief Direct O(N^2) Transform of a Row-Major Array */
+    std::vector<solver::complex> naive ( std::vector<solver::complex> const& x, std::vector<std::size_t> const& shape, solver::direction sense ) {
+        std::size_t const n = x.size ();
+        std::vector<solver::complex> y ( n );
+        for ( std::size_t k = 0; k < n; ++k )
+            for ( std::size_t i = 0; i < n; ++i ) {
+                double phase = 0.;
+                std::size_t ri = i, rk = k;
+                for ( std::size_t a = shape.size (); a-- > 0; ) {
+                    phase += double ( ( ri % shape [ a ] ) * ( rk % shape [ a ] ) % shape [ a ] ) / double ( shape [ a ] );
+                    ri /= shape [ a ];
+                    rk /= shape [ a ];
+                }
+                y [ k ] += x [ i ] * std::polar ( 1., double ( static_cast<int> ( sense ) ) * 2. * std::numbers::pi * phase );
+            }
+        return y;
+    }
+
+    std::vector<solver::complex> noise ( std::size_t n, unsigned seed ) {
+        std::mt19937 engine ( seed );
+        std::uniform_real_distribution<double> u ( -1., 1. );
+        std::vector<solver::complex> x ( n );
+        for ( auto& z : x )
+            z = { u ( engine ), u ( engine ) };
+        return x;
+    }
+
+} // namespace
+
+TEST ( fourier_test, matches_direct_transform_in_one_dimension ) {
+    for ( std::size_t const n : { 1, 2, 3, 4, 5, 6, 7, 8, 12, 30, 49, 64, 97, 120, 1001 } ) {
+        std::vector<std::size_t> const shape { n };
+        auto const x = noise ( n, unsigned ( n ) );
+        for ( auto const sense : { solver::direction::forward, solver::direction::backward } ) {
+            auto y = x;
+            solver::fft ( y, shape, sense, 1 );
+            auto const z = naive ( x, shape, sense );
+            for ( std::size_t k = 0; k < n; ++k )
+                EXPECT_NEAR ( std::abs ( y [ k ] - z [ k ] ), 0., 1e-11 * double ( n ) ) << "n = " << n;
+        }
+    }
+}
+
+TEST ( fourier_test, matches_direct_transform_in_several_dimensions ) {
+    for ( auto const& shape : std::vector<std::vector<std::size_t>> { { 9, 16 }, { 10, 3 }, { 6, 10, 7 }, { 3, 1, 25 }, { 11, 12, 2 } } ) {
+        std::size_t n = 1;
+        for ( std::size_t const e : shape )
+            n *= e;
+        auto const x = noise ( n, 7 );
+        auto y       = x;
+        solver::fft ( y, shape, solver::direction::forward, 3 );
+        auto const z = naive ( x, shape, solver::direction::forward );
+        for ( std::size_t k = 0; k < n; ++k )
+            EXPECT_NEAR ( std::abs ( y [ k ] - z [ k ] ), 0., 1e-10 );
+
+        // backward undoes forward up to N
+        solver::fft ( y, shape, solver::direction::backward, 2 );
+        for ( std::size_t k = 0; k < n; ++k )
+            EXPECT_NEAR ( std::abs ( y [ k ] / double ( n ) - x [ k ] ), 0., 1e-13 );
+    }
+}
+
+TEST ( fourier_test, real_transforms_match_the_complex_half_spectrum ) {
+    for ( auto const& shape : std::vector<std::vector<std::size_t>> { { 16 }, { 15 }, { 2 }, { 5, 12 }, { 4, 6, 10 }, { 3, 5, 9 } } ) {
+        std::size_t n = 1;
+        for ( std::size_t const e : shape )
+            n *= e;
+        std::size_t const last = shape.back (), hh = last / 2 + 1, rows = n / last;
+
+        auto const noisy = noise ( n, 3 );
+        std::vector<double> x ( n );
+        std::vector<solver::complex> full ( n );
+        for ( std::size_t i = 0; i < n; ++i )
+            full [ i ] = x [ i ] = noisy [ i ].real ();
+        solver::fft ( full, shape, solver::direction::forward, 1 );
+
+        std::vector<solver::complex> half ( rows * hh );
+        solver::rfft ( x, half, shape, 2 );
+        for ( std::size_t r = 0; r < rows; ++r )
+            for ( std::size_t k = 0; k < hh; ++k )
+                EXPECT_NEAR ( std::abs ( half [ r * hh + k ] - full [ r * last + k ] ), 0., 1e-11 );
+
+        std::vector<double> back ( n );
+        solver::irfft ( half, back, shape, 2 );
+        for ( std::size_t i = 0; i < n; ++i )
+            EXPECT_NEAR ( back [ i ] / double ( n ), x [ i ], 1e-13 );
+    }
+}
+
+TEST ( fourier_test, plans_are_cached_by_length_stride_and_direction ) {
+    solver::clear_plans ();
+    auto const a = solver::plan ( 60, 1, solver::direction::forward );
+    auto const b = solver::plan ( 60, 1, solver::direction::forward );
+    auto const c = solver::plan ( 60, 4, solver::direction::forward );
+    auto const d = solver::plan ( 60, 1, solver::direction::backward );
+    EXPECT_EQ ( a.get (), b.get () );
+    EXPECT_NE ( a.get (), c.get () );
+    EXPECT_NE ( a.get (), d.get () );
+    EXPECT_EQ ( solver::cached_plans (), 3u );
+
+    // a transform reuses the plans of its axes
+    std::vector<solver::complex> x ( 4 * 60 );
+    std::vector<std::size_t> const shape { 4, 60 };
+    solver::fft ( x, shape, solver::direction::forward, 1 );
+    EXPECT_EQ ( solver::cached_plans (), 4u );
+
+    solver::clear_plans ();
+    EXPECT_EQ ( solver::cached_plans (), 0u );
+    EXPECT_EQ ( a->length (), 60u );
+}
+
+TEST ( fourier_test, results_do_not_depend_on_thread_count ) {
+    std::vector<std::size_t> const shape { 24, 18, 20 };
+    auto const x = noise ( 24 * 18 * 20, 5 );
+    auto one = x, many = x;
+    solver::fft ( one, shape, solver::direction::forward, 1 );
+    solver::fft ( many, shape, solver::direction::forward, 6 );
+    EXPECT_EQ ( one, many );
+
+    // generic radices on the shared pool, from two callers at once
+    std::vector<std::size_t> const odd { 14, 11, 26 };
+    auto const y = noise ( 14 * 11 * 26, 6 );
+    auto serial = y, left = y, right = y;
+    solver::fft ( serial, odd, solver::direction::backward, 1 );
+    std::thread other ( [ & ] { solver::fft ( left, odd, solver::direction::backward, 4 ); } );
+    solver::fft ( right, odd, solver::direction::backward, 4 );
+    other.join ();
+    EXPECT_EQ ( serial, left );
+    EXPECT_EQ ( serial, right );
+}
@@ -0,0 +1,150 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <solver/solver.hpp>
+
+namespace solver = microstructure::libraries::solver;
+
+namespace {
+
+    /** \brief Five-Point -lap + c d/dx on an n x n Grid (Dirichlet, h = 1); c = 0 is Symmetric */
+    solver::coordinate_matrix convection_diffusion ( std::size_t n, double c ) {
+        solver::coordinate_matrix a ( n * n, n * n );
+        for ( std::size_t i = 0; i < n; ++i )
+            for ( std::size_t j = 0; j < n; ++j ) {
+                std::size_t const r = i * n + j;
+                a.add ( r, r, 4. );
+                if ( i > 0 )
+                    a.add ( r, r - n, -1. );
+                if ( i + 1 < n )
+                    a.add ( r, r + n, -1. );
+                if ( j > 0 )
+                    a.add ( r, r - 1, -1. - c / 2. );
+                if ( j + 1 < n )
+                    a.add ( r, r + 1, -1. + c / 2. );
+            }
+        return a;
+    }
+
+    std::vector<double> right_hand_side ( std::size_t n ) {
+        std::vector<double> b ( n );
+        for ( std::size_t i = 0; i < n; ++i )
+            b [ i ] = 1. + std::sin ( 0.1 * double ( i ) );
+        return b;
+    }
+
+    /** \brief |b - A x| / |b| Measured Independently of the Solver */
+    double relative_residual ( solver::csr_matrix const& a, std::vector<double> const& b, std::vector<double> const& x ) {
+        std::vector<double> ax ( b.size () );
+        a.multiply ( x, ax );
+        double r = 0., s = 0.;
+        for ( std::size_t i = 0; i < b.size (); ++i ) {
+            r += ( b [ i ] - ax [ i ] ) * ( b [ i ] - ax [ i ] );
+            s += b [ i ] * b [ i ];
+        }
+        return std::sqrt ( r / s );
+    }
+
+} // namespace
+
+TEST ( krylov_test, conjugate_gradient_with_each_preconditioner ) {
+    std::size_t const n = 48;
+    solver::csr_matrix const a ( convection_diffusion ( n, 0. ), 2 );
+    auto const b = right_hand_side ( n * n );
+
+    std::vector<std::size_t> iterations;
+    for ( solver::linear_operator const& m : { solver::linear_operator {}, solver::linear_operator { solver::jacobi_preconditioner ( a ) },
+                                                solver::linear_operator { solver::ilu0_preconditioner ( a ) } } ) {
+        std::vector<double> x ( n * n, 0. );
+        auto const report = solver::conjugate_gradient ( a, b, x, m );
+        EXPECT_TRUE ( report.converged );
+        EXPECT_LT ( relative_residual ( a, b, x ), 1e-9 );
+        iterations.push_back ( report.iterations );
+    }
+
+    // ILU(0) roughly halves the iterations on the Laplacian
+    EXPECT_LT ( 2 * iterations [ 2 ], iterations [ 0 ] + 10 );
+}
+
+TEST ( krylov_test, bicgstab_and_gmres_solve_nonsymmetric_systems ) {
+    std::size_t const n = 40;
+    auto const assembly = convection_diffusion ( n, 1.5 );
+    solver::csr_matrix const a ( assembly, 3 );
+    auto const b = right_hand_side ( n * n );
+    solver::ilu0_preconditioner const ilu ( a );
+
+    for ( bool const preconditioned : { false, true } ) {
+        solver::linear_operator const m = preconditioned ? solver::linear_operator { ilu } : solver::linear_operator {};
+
+        std::vector<double> x ( n * n, 0. );
+        auto report = solver::bicgstab ( a, b, x, m );
+        EXPECT_TRUE ( report.converged );
+        EXPECT_LT ( relative_residual ( a, b, x ), 1e-9 );
+
+        // the other formats go through the same template
+        std::fill ( x.begin (), x.end (), 0. );
+        report = solver::gmres ( solver::sell_matrix ( assembly, 64, 2 ), b, x, m, { .restart = 20 } );
+        EXPECT_TRUE ( report.converged );
+        EXPECT_LT ( relative_residual ( a, b, x ), 1e-9 );
+
+        std::fill ( x.begin (), x.end (), 0. );
+        report = solver::gmres ( solver::bcsr_matrix ( assembly, 2, 2 ), b, x, m, { .restart = 50 } );
+        EXPECT_TRUE ( report.converged );
+        EXPECT_LT ( relative_residual ( a, b, x ), 1e-9 );
+    }
+}
+
+TEST ( krylov_test, matrix_free_operator_and_threaded_kernels ) {
+    std::size_t const n = 2000;
+
+    // -u'' on a line, never assembled
+    solver::linear_operator const a = [ n ] ( std::span<double const> x, std::span<double> y ) {
+        for ( std::size_t i = 0; i < n; ++i )
+            y [ i ] = 2. * x [ i ] - ( i > 0 ? x [ i - 1 ] : 0. ) - ( i + 1 < n ? x [ i + 1 ] : 0. );
+    };
+    std::vector<double> b ( n, 0. ), x ( n, 0. );
+    b [ n / 3 ] = 1.;
+
+    solver::krylov_settings settings;
+    settings.threads         = 4;
+    settings.parallel_length = 0;
+    settings.tolerance       = 1e-12;
+    settings.iterations      = 2 * n;
+    auto const report        = solver::conjugate_gradient ( a, b, x, {}, settings );
+    EXPECT_TRUE ( report.converged );
+
+    // Green's function of the discrete -u'': piecewise linear with a kink at n/3
+    double const s = double ( n / 3 + 1 ), l = double ( n + 1 );
+    for ( std::size_t i = 0; i < n; ++i ) {
+        double const t = double ( i + 1 );
+        EXPECT_NEAR ( x [ i ], t <= s ? t * ( l - s ) / l : s * ( l - t ) / l, 1e-6 );
+    }
+}
+
+TEST ( krylov_test, multigrid_preconditioned_conjugate_gradient ) {
+    std::size_t const n = 65;
+    double const h      = 1. / double ( n - 1 );
+    std::vector<std::size_t> const shape { n, n };
+    solver::multigrid mg ( shape, h, 0., 2 );
+
+    // identity rows on the boundary, the five-point -lap inside
+    auto const boundary = [ n ] ( std::size_t i ) { return i / n == 0 || i / n == n - 1 || i % n == 0 || i % n == n - 1; };
+    solver::linear_operator const a = [ & ] ( std::span<double const> x, std::span<double> y ) {
+        for ( std::size_t i = 0; i < n * n; ++i )
+            y [ i ] = boundary ( i ) ? x [ i ] : ( 4. * x [ i ] - x [ i - 1 ] - x [ i + 1 ] - x [ i - n ] - x [ i + n ] ) / ( h * h );
+    };
+    std::vector<double> b ( n * n, 0. ), x ( n * n, 0. );
+    for ( std::size_t i = 0; i < n * n; ++i )
+        if ( !boundary ( i ) )
+            b [ i ] = double ( i / n ) * h + std::exp ( double ( i % n ) * h );
+
+    auto const plain  = solver::conjugate_gradient ( a, b, x );
+    std::fill ( x.begin (), x.end (), 0. );
+    auto const report = solver::conjugate_gradient ( a, b, x, solver::multigrid_preconditioner ( mg ) );
+    EXPECT_TRUE ( plain.converged );
+    EXPECT_TRUE ( report.converged );
+    EXPECT_LT ( report.iterations, 15u );
+    EXPECT_LT ( 5 * report.iterations, plain.iterations );
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <solver/solver.hpp>
+
+namespace solver = microstructure::libraries::solver;
+
+namespace {
+
+    struct poisson {
+        std::vector<double> u;
+        std::vector<double> f;
+        std::vector<double> exact;
+    };
+
+    /** \brief -lap u = 2 pi^2 sin(pi x) sin(pi y) on the Unit Square, u = 0 on the Boundary */
+    poisson sine ( std::size_t n ) {
+        double const h  = 1. / double ( n - 1 );
+        double const pi = std::numbers::pi;
+        poisson p { std::vector<double> ( n * n, 0. ), std::vector<double> ( n * n ), std::vector<double> ( n * n ) };
+        for ( std::size_t i = 0; i < n; ++i )
+            for ( std::size_t j = 0; j < n; ++j ) {
+                p.exact [ i * n + j ] = std::sin ( pi * double ( i ) * h ) * std::sin ( pi * double ( j ) * h );
+                p.f [ i * n + j ]     = 2. * pi * pi * p.exact [ i * n + j ];
+            }
+        return p;
+    }
+
+    double error ( poisson const& p ) {
+        double e = 0.;
+        for ( std::size_t i = 0; i < p.u.size (); ++i )
+            e = std::max ( e, std::abs ( p.u [ i ] - p.exact [ i ] ) );
+        return e;
+    }
+
+} // namespace
+
+TEST ( multigrid_test, poisson_converges_in_a_mesh_independent_number_of_cycles ) {
+    std::vector<std::size_t> cycles;
+    std::vector<double> errors;
+    for ( std::size_t const n : { 33, 129 } ) {
+        std::vector<std::size_t> const shape { n, n };
+        solver::multigrid mg ( shape, 1. / double ( n - 1 ), 0., 2 );
+        EXPECT_GE ( mg.levels (), 4u );
+
+        auto p            = sine ( n );
+        auto const report = mg.solve ( p.u, p.f, 1e-10 );
+        EXPECT_TRUE ( report.converged );
+        EXPECT_LE ( report.residual, 1e-10 );
+        cycles.push_back ( report.cycles );
+        errors.push_back ( error ( p ) );
+    }
+    EXPECT_LE ( cycles [ 1 ], cycles [ 0 ] + 2 );
+    EXPECT_LE ( cycles [ 1 ], 15u );
+
+    // second-order discretisation: four times finer, sixteen times smaller
+    EXPECT_NEAR ( errors [ 0 ] / errors [ 1 ], 16., 1. );
+}
+
+TEST ( multigrid_test, any_extent_gets_a_full_hierarchy ) {
+    // 100 = 99 cells and 64 = 63 cells do not halve; the hierarchy still reaches 3 x 3
+    for ( std::size_t const n : { 64, 100 } ) {
+        std::vector<std::size_t> const shape { n, n };
+        solver::multigrid mg ( shape, 1. / double ( n - 1 ) );
+        EXPECT_GE ( mg.levels (), 6u );
+
+        auto p            = sine ( n );
+        auto const report = mg.solve ( p.u, p.f, 1e-10 );
+        EXPECT_TRUE ( report.converged );
+        EXPECT_LE ( report.cycles, 12u );
+        EXPECT_NEAR ( error ( p ) * double ( ( n - 1 ) * ( n - 1 ) ), 0.82, 0.01 );
+    }
+
+    std::vector<std::size_t> const shape { 40, 27, 18 };
+    std::vector<double> u ( 40 * 27 * 18, 0. ), f ( u.size (), 1. );
+    solver::multigrid mg ( shape, 0.05, 0.5, 2 );
+    EXPECT_GE ( mg.levels (), 4u );
+    auto const report = mg.solve ( u, f, 1e-10 );
+    EXPECT_TRUE ( report.converged );
+    EXPECT_LE ( report.cycles, 15u );
+}
+
+TEST ( multigrid_test, coarsest_level_is_solved_exactly ) {
+    // no axis has 5 nodes: a single level, one cycle is the direct solve
+    std::vector<std::size_t> const shape { 4, 4, 4 };
+    std::vector<double> u ( 64, 0. ), f ( 64 );
+    for ( std::size_t c = 0; c < f.size (); ++c )
+        f [ c ] = std::cos ( double ( c ) );
+
+    solver::multigrid mg ( shape, 0.3, 2. );
+    EXPECT_EQ ( mg.levels (), 1u );
+    auto const report = mg.solve ( u, f, 1e-13 );
+    EXPECT_TRUE ( report.converged );
+    EXPECT_EQ ( report.cycles, 1u );
+}
+
+TEST ( multigrid_test, helmholtz_reproduces_linear_dirichlet_data ) {
+    std::size_t const n = 17;
+    double const h = 1. / double ( n - 1 ), alpha = 10.;
+    std::vector<std::size_t> const shape { n, n, n };
+
+    // u = x + y + z is harmonic, so -lap u + alpha u = alpha u exactly
+    std::vector<double> u ( n * n * n, 0. ), f ( n * n * n ), exact ( n * n * n );
+    for ( std::size_t i = 0; i < n; ++i )
+        for ( std::size_t j = 0; j < n; ++j )
+            for ( std::size_t k = 0; k < n; ++k ) {
+                std::size_t const c  = ( i * n + j ) * n + k;
+                exact [ c ]          = double ( i + j + k ) * h;
+                f [ c ]              = alpha * exact [ c ];
+                bool const interior  = i % ( n - 1 ) && j % ( n - 1 ) && k % ( n - 1 );
+                u [ c ]              = interior ? 0. : exact [ c ];
+            }
+
+    solver::multigrid mg ( shape, h, alpha, 3 );
+    auto const report = mg.solve ( u, f, 1e-12 );
+    EXPECT_TRUE ( report.converged );
+    for ( std::size_t c = 0; c < u.size (); ++c )
+        EXPECT_NEAR ( u [ c ], exact [ c ], 1e-10 );
+}
+
+TEST ( multigrid_test, w_cycles_need_no_more_cycles_than_v_cycles ) {
+    std::size_t const n = 65;
+    std::vector<std::size_t> const shape { n, n };
+
+    solver::multigrid mg ( shape, 1. / double ( n - 1 ) );
+    mg.smoothing ( 1, 1 );
+    auto v             = sine ( n );
+    auto const reportv = mg.solve ( v.u, v.f, 1e-9 );
+
+    mg.shape ( solver::cycle_shape::w );
+    auto w             = sine ( n );
+    auto const reportw = mg.solve ( w.u, w.f, 1e-9 );
+
+    EXPECT_TRUE ( reportv.converged );
+    EXPECT_TRUE ( reportw.converged );
+    EXPECT_LE ( reportw.cycles, reportv.cycles );
+    EXPECT_NEAR ( error ( v ), error ( w ), 1e-7 );
+}
+
+TEST ( multigrid_test, results_do_not_depend_on_thread_count ) {
+    // 129^2 points run the finest levels on the pool, 33^2 only the caller
+    for ( std::size_t const n : { 33, 129 } ) {
+        std::vector<std::size_t> const shape { n, n };
+        auto one = sine ( n ), many = sine ( n );
+
+        solver::multigrid a ( shape, 1. / double ( n - 1 ), 1., 1 );
+        solver::multigrid b ( shape, 1. / double ( n - 1 ), 1., 5 );
+        for ( std::size_t c = 0; c < 3; ++c ) {
+            a.cycle ( one.u, one.f );
+            b.cycle ( many.u, many.f );
+        }
+        EXPECT_EQ ( one.u, many.u );
+        EXPECT_EQ ( a.residual ( one.u, one.f ), b.residual ( many.u, many.f ) );
+    }
+}
@@ -0,0 +1,196 @@
+#include <cmath>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined( __linux__ )
+#include <sched.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <solver/solver.hpp>
+
+namespace solver = microstructure::libraries::solver;
+
+namespace {
+
+    /** \brief Random Assembly with Repeated Positions, Empty Rows and a Dense Copy */
+    solver::coordinate_matrix random ( std::size_t rows, std::size_t columns, std::vector<double>& dense, unsigned seed ) {
+        std::mt19937 engine ( seed );
+        std::uniform_real_distribution<double> u ( -1., 1. );
+        std::uniform_int_distribution<std::size_t> width ( 0, 12 ), column ( 0, columns - 1 );
+
+        solver::coordinate_matrix a ( rows, columns );
+        dense.assign ( rows * columns, 0. );
+        for ( std::size_t r = 0; r < rows; ++r ) {
+            std::size_t const n = r % 7 == 3 ? 0 : width ( engine ) * ( r % 5 == 0 ? 4 : 1 );
+            for ( std::size_t e = 0; e < n; ++e ) {
+                std::size_t const c = column ( engine );
+                double const v      = u ( engine );
+                a.add ( r, c, v );
+                dense [ r * columns + c ] += v;
+            }
+        }
+        return a;
+    }
+
+    std::vector<double> product ( std::vector<double> const& dense, std::vector<double> const& x ) {
+        std::vector<double> y ( dense.size () / x.size (), 0. );
+        for ( std::size_t r = 0; r < y.size (); ++r )
+            for ( std::size_t c = 0; c < x.size (); ++c )
+                y [ r ] += dense [ r * x.size () + c ] * x [ c ];
+        return y;
+    }
+
+    std::vector<double> vector ( std::size_t n ) {
+        std::vector<double> x ( n );
+        for ( std::size_t i = 0; i < n; ++i )
+            x [ i ] = std::sin ( 0.37 * double ( i ) + 1. );
+        return x;
+    }
+
+} // namespace
+
+TEST ( sparse_test, csr_sums_repeated_entries_and_multiplies ) {
+    std::vector<double> dense;
+    auto const a = random ( 203, 117, dense, 1 );
+    auto const x = vector ( 117 ), expected = product ( dense, x );
+
+    for ( std::size_t const threads : { 1, 3, 8 } ) {
+        solver::csr_matrix const m ( a, threads );
+        EXPECT_EQ ( m.threads (), threads );
+        EXPECT_LE ( m.nonzeros (), a.entries () );
+
+        std::vector<double> y ( 203 );
+        m.multiply ( x, y );
+        for ( std::size_t r = 0; r < 203; ++r )
+            EXPECT_NEAR ( y [ r ], expected [ r ], 1e-12 );
+    }
+
+    // columns are sorted and unique within each row
+    solver::csr_matrix const m ( a, 2 );
+    for ( std::size_t r = 0; r < m.rows (); ++r )
+        for ( std::size_t k = m.offsets () [ r ] + 1; k < m.offsets () [ r + 1 ]; ++k )
+            EXPECT_LT ( m.indices () [ k - 1 ], m.indices () [ k ] );
+}
+
+TEST ( sparse_test, csr_extracts_the_diagonal ) {
+    solver::coordinate_matrix a ( 4, 4 );
+    a.add ( 0, 0, 2. );
+    a.add ( 0, 0, 1. );
+    a.add ( 1, 2, 5. );
+    a.add ( 3, 3, -1. );
+    a.add ( 3, 0, 7. );
+
+    std::vector<double> d ( 4 );
+    solver::csr_matrix ( a, 1 ).diagonal ( d );
+    EXPECT_EQ ( d, ( std::vector<double> { 3., 0., 0., -1. } ) );
+}
+
+TEST ( sparse_test, sell_matches_csr_for_any_sorting_window ) {
+    std::vector<double> dense;
+    auto const a = random ( 301, 90, dense, 2 );
+    auto const x = vector ( 90 ), expected = product ( dense, x );
+
+    std::vector<double> fill;
+    for ( std::size_t const sigma : { 1, 8, 64, 1024 } ) {
+        solver::sell_matrix const m ( a, sigma, 4 );
+        std::vector<double> y ( 301 );
+        m.multiply ( x, y );
+        for ( std::size_t r = 0; r < 301; ++r )
+            EXPECT_NEAR ( y [ r ], expected [ r ], 1e-12 );
+
+        EXPECT_LE ( m.fill (), 1. );
+        fill.push_back ( m.fill () );
+    }
+
+    // a window spanning all rows sorts globally and pads least
+    EXPECT_GT ( fill.back (), fill.front () );
+    EXPECT_GT ( fill.back (), 0.9 );
+}
+
+TEST ( sparse_test, bcsr_matches_dense_for_each_block_size ) {
+    for ( std::size_t const b : { 1, 2, 3, 4, 5 } ) {
+        std::vector<double> dense;
+        auto const a = random ( 60 * b, 25 * b, dense, unsigned ( b ) );
+        auto const x = vector ( 25 * b ), expected = product ( dense, x );
+
+        solver::bcsr_matrix const m ( a, b, 3 );
+        EXPECT_EQ ( m.block (), b );
+        std::vector<double> y ( 60 * b );
+        m.multiply ( x, y );
+        for ( std::size_t r = 0; r < 60 * b; ++r )
+            EXPECT_NEAR ( y [ r ], expected [ r ], 1e-12 ) << "b = " << b;
+    }
+}
+
+TEST ( sparse_test, formats_agree_on_a_five_point_laplacian ) {
+    std::size_t const n = 40, size = n * n;
+    solver::coordinate_matrix a ( size, size );
+    a.reserve ( 5 * size );
+    for ( std::size_t i = 0; i < n; ++i )
+        for ( std::size_t j = 0; j < n; ++j ) {
+            std::size_t const r = i * n + j;
+            a.add ( r, r, 4. );
+            if ( i > 0 )
+                a.add ( r, r - n, -1. );
+            if ( i + 1 < n )
+                a.add ( r, r + n, -1. );
+            if ( j > 0 )
+                a.add ( r, r - 1, -1. );
+            if ( j + 1 < n )
+                a.add ( r, r + 1, -1. );
+        }
+
+    auto const x = vector ( size );
+    std::vector<double> y1 ( size ), y2 ( size ), y3 ( size );
+    solver::csr_matrix ( a, 5 ).multiply ( x, y1 );
+    solver::sell_matrix ( a, 32, 5 ).multiply ( x, y2 );
+    solver::bcsr_matrix ( a, 2, 5 ).multiply ( x, y3 );
+    for ( std::size_t r = 0; r < size; ++r ) {
+        EXPECT_DOUBLE_EQ ( y1 [ r ], y2 [ r ] );
+        EXPECT_NEAR ( y1 [ r ], y3 [ r ], 1e-13 );
+    }
+}
+
+TEST ( sparse_test, pool_workers_stay_on_their_thread_and_cpu ) {
+    std::size_t const threads = 4;
+    solver::worker_pool const pool ( threads );
+    ASSERT_EQ ( pool.size (), threads );
+
+    std::vector<std::thread::id> id ( threads );
+    std::vector<int> cpu ( threads, -1 );
+    for ( std::size_t call = 0; call < 50; ++call )
+        pool.run ( [ & ] ( std::size_t t ) {
+            int here = -1;
+#if defined( __linux__ )
+            here = sched_getcpu ();
+#endif
+            if ( call == 0 ) {
+                id [ t ]  = std::this_thread::get_id ();
+                cpu [ t ] = here;
+            }
+            EXPECT_EQ ( id [ t ], std::this_thread::get_id () );
+            EXPECT_EQ ( cpu [ t ], here );
+        } );
+    for ( std::size_t t = 0; t < threads; ++t ) {
+        EXPECT_NE ( id [ t ], std::this_thread::get_id () );
+        for ( std::size_t s = 0; s < t; ++s )
+            EXPECT_NE ( id [ s ], id [ t ] );
+    }
+}
+
+TEST ( sparse_test, moved_matrices_keep_their_workers ) {
+    std::vector<double> dense;
+    auto const a = random ( 300, 200, dense, 7 );
+    auto const x = vector ( 200 );
+    std::vector<double> y1 ( 300 ), y2 ( 300 );
+
+    solver::csr_matrix m ( a, 3 );
+    m.multiply ( x, y1 );
+    solver::csr_matrix const moved = std::move ( m );
+    moved.multiply ( x, y2 );
+    EXPECT_EQ ( y1, y2 );
+}
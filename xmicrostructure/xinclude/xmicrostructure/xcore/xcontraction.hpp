@@ -0,0 +1,231 @@
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \brief Compile-Time Index Contraction (einsum-style)
+ * \note  contract<"ijkl,kl->ij">(C, e) sums the product of its operands
+ *        over every label that does not appear after "->"; each operand is
+ *        a formation_across tensor with one label per index
+ * \note  The label string is parsed at compile time and all n^labels terms
+ *        are emitted as straight-line code with constant offsets, so
+ *        2-D and 3-D contractions need no runtime index arithmetic
+ */
+
+namespace detail {
+
+template <std::size_t N>
+struct einsum_string {
+  char label[N]{};
+
+  constexpr einsum_string(char const (&a_label)[N]) {
+    for (std::size_t i = 0; i < N; ++i)
+      label[i] = a_label[i];
+  }
+};
+
+/** \brief Parsed Contraction: Operand and Output Labels, Distinct Labels */
+struct einsum_spec {
+  static constexpr std::size_t max_operands = 8;
+  static constexpr std::size_t max_rank     = 8;
+  static constexpr std::size_t max_labels   = 16;
+
+  bool        valid                         = true;
+  std::size_t operands                      = 0;
+  std::size_t order[max_operands]           = {};
+  char        label[max_operands][max_rank] = {};
+  std::size_t output_order                  = 0;
+  char        output[max_rank]              = {};
+  std::size_t distinct                      = 0;
+  char        unique[max_labels]            = {};
+
+  constexpr std::size_t position(char c) const {
+    for (std::size_t u = 0; u < distinct; ++u)
+      if (unique[u] == c)
+        return u;
+    return max_labels;
+  }
+
+  constexpr void insert(char c) {
+    if (position(c) != max_labels)
+      return;
+    if (distinct == max_labels) {
+      valid = false;
+      return;
+    }
+    unique[distinct++] = c;
+  }
+};
+
+template <std::size_t N>
+constexpr einsum_spec parse_einsum(einsum_string<N> const& s) {
+  einsum_spec spec;
+
+  std::size_t i = 0;
+  bool        arrow = false;
+  spec.operands     = 1;
+  for (; i + 1 < N && s.label[i] != '\0'; ++i) {
+    char const c = s.label[i];
+    if (c == ' ')
+      continue;
+    if (c == ',') {
+      if (++spec.operands > einsum_spec::max_operands)
+        return spec.valid = false, spec;
+      continue;
+    }
+    if (c == '-' && s.label[i + 1] == '>') {
+      arrow = true;
+      i += 2;
+      break;
+    }
+    if (c < 'a' || c > 'z')
+      return spec.valid = false, spec;
+    std::size_t& r = spec.order[spec.operands - 1];
+    if (r == einsum_spec::max_rank)
+      return spec.valid = false, spec;
+    spec.label[spec.operands - 1][r++] = c;
+  }
+  if (!arrow)
+    return spec.valid = false, spec;
+
+  for (; i + 1 < N && s.label[i] != '\0'; ++i) {
+    char const c = s.label[i];
+    if (c == ' ')
+      continue;
+    if (c < 'a' || c > 'z' || spec.output_order == einsum_spec::max_rank)
+      return spec.valid = false, spec;
+    for (std::size_t k = 0; k < spec.output_order; ++k)
+      if (spec.output[k] == c)
+        return spec.valid = false, spec; // repeated output label
+    spec.output[spec.output_order++] = c;
+  }
+
+  // output labels first so the output offset varies slowest
+  for (std::size_t k = 0; k < spec.output_order; ++k)
+    spec.insert(spec.output[k]);
+  std::size_t const free = spec.distinct;
+  for (std::size_t a = 0; a < spec.operands; ++a)
+    for (std::size_t k = 0; k < spec.order[a]; ++k)
+      spec.insert(spec.label[a][k]);
+
+  // every output label must come from an operand
+  for (std::size_t u = 0; u < free; ++u) {
+    bool found = false;
+    for (std::size_t a = 0; a < spec.operands; ++a)
+      for (std::size_t k = 0; k < spec.order[a]; ++k)
+        found = found || spec.label[a][k] == spec.unique[u];
+    if (!found)
+      spec.valid = false;
+  }
+  return spec;
+}
+
+template <einsum_string S>
+inline constexpr einsum_spec einsum_v = parse_einsum(S);
+
+/**
+ * \brief Row-Major Offset into Operand a (the output for a == operands) of
+ *        the Index Tuple Selected by the Flat Term
+ */
+
+constexpr std::size_t einsum_offset(einsum_spec const& spec, std::size_t n,
+                                    std::size_t term, std::size_t a) {
+  char const* const label = a < spec.operands ? spec.label[a] : spec.output;
+  std::size_t const order =
+      a < spec.operands ? spec.order[a] : spec.output_order;
+
+  std::size_t offset = 0;
+  for (std::size_t k = 0; k < order; ++k) {
+    std::size_t const u = spec.position(label[k]);
+    std::size_t       v = term;
+    for (std::size_t s = u + 1; s < spec.distinct; ++s)
+      v /= n;
+    offset = offset * n + v % n;
+  }
+  return offset;
+}
+
+constexpr std::size_t einsum_power(std::size_t n, std::size_t e) {
+  std::size_t p = 1;
+  for (std::size_t k = 0; k < e; ++k)
+    p *= n;
+  return p;
+}
+
+constexpr bool einsum_rank(std::size_t order) {
+  return order == 0 || order == 1 || order == 2 || order == 4;
+}
+
+} // namespace detail
+
+// ================================
+
+/**
+ * \brief Contract formation_across Tensors by Compile-Time Index Labels
+ * \return accumulate_t<ArithmeticT> for "->", otherwise a tensor of the
+ *         output rank
+ * \note   Every output entry is summed in accumulate_t and rounded to
+ *         ArithmeticT once, when it is stored
+ */
+
+template <detail::einsum_string S, arithmetical ArithmeticT, dimension D,
+          rank... R>
+inline constexpr auto
+contract(tensor<ArithmeticT, R, D, formation_across> const&... a) {
+  constexpr auto const& spec = detail::einsum_v<S>;
+  static_assert(spec.valid, "contract: malformed label string");
+  static_assert(spec.operands == sizeof...(R),
+                "contract: operand count does not match the labels");
+  static_assert(
+      []<std::size_t... K>(std::index_sequence<K...>) {
+        return ((static_cast<std::size_t>(R) ==
+                 detail::einsum_v<S>.order[K]) &&
+                ...);
+      }(std::index_sequence_for<decltype(R)...>{}),
+      "contract: operand rank does not match its labels");
+  static_assert(detail::einsum_rank(spec.output_order),
+                "contract: output rank must be 0, 1, 2 or 4");
+
+  constexpr std::size_t n     = dimension_t(D);
+  constexpr std::size_t terms = detail::einsum_power(n, spec.distinct);
+
+  auto const operand = std::tie(a...);
+
+  using accumulator = accumulate_t<ArithmeticT>;
+
+  auto const product = [&](auto term) {
+    accumulator p{1};
+    detail::unroll<sizeof...(R)>([&](auto k) {
+      constexpr std::size_t offset = detail::einsum_offset(
+          spec, n, decltype(term)::value, decltype(k)::value);
+      p *= std::get<decltype(k)::value>(operand).value[offset];
+    });
+    return p;
+  };
+
+  if constexpr (spec.output_order == 0) {
+    accumulator s{};
+    detail::unroll<terms>([&](auto term) { s += product(term); });
+    return s;
+  } else {
+    constexpr std::size_t m = detail::einsum_power(n, spec.output_order);
+
+    std::array<accumulator, m> s{};
+    detail::unroll<terms>([&](auto term) {
+      constexpr std::size_t offset = detail::einsum_offset(
+          spec, n, decltype(term)::value, spec.operands);
+      s[offset] += product(term);
+    });
+
+    tensor<ArithmeticT, static_cast<rank>(spec.output_order), D,
+           formation_across>
+        o;
+    for (std::size_t i = 0; i < m; ++i)
+      o.value[i] = static_cast<ArithmeticT>(s[i]);
+    return o;
+  }
+}
+
+// ================================
+
+} // namespace xmicrostructure
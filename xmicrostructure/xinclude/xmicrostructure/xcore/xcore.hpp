@@ -3,4 +3,10 @@
 #include "xdefinition.hpp"
 #include "xkernel.hpp"
 #include "xmesh.hpp"
-#include "xtensor.hpp"
\ No newline at end of file
+#include "xparallel.hpp"
+#include "xtensor.hpp"
+#include "xcontraction.hpp"
+#include "xtensor_field.hpp"
+#include "xeigen.hpp"
+#include "xrotation.hpp"
+#include "xfourier.hpp"
\ No newline at end of file
@@ -0,0 +1,474 @@
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \brief Eigen-Decomposition of Symmetric Rank-2 Tensors in 2-D and 3-D
+ * \note  Eigenvalues are closed form (half-angle in 2-D, trigonometric
+ *        Cardano in 3-D) and returned in descending order; eigenvectors are
+ *        the columns of a formation_across rank-2 tensor
+ * \note  Batched kernels sweep a tensor_field point by point with the
+ *        closed form (acos, cos and sqrt per point, no iteration); 3-D
+ *        points whose eigenvectors are ill-conditioned by a near-repeated
+ *        eigenvalue are flagged and recomputed by cyclic Jacobi in a second
+ *        pass, so only those points pay for the iteration
+ * \note  Near a repeated root the trigonometric eigenvalues are only
+ *        accurate to about sqrt(eps) relative; eigen() returns the Jacobi
+ *        values for those points, eigenvalues() does not
+ */
+
+namespace detail {
+
+template <class FormationPol>
+constexpr std::size_t symmetric_row(std::size_t i, std::size_t j,
+                                    dimension d) {
+  if constexpr (std::is_same_v<FormationPol, formation_across>)
+    return i * dimension_t(d) + j;
+  else
+    return voigt_index(i, j, d);
+}
+
+/** \brief Factor Mapping a Stored Component to the Tensor Component */
+template <class FormationPol, arithmetical ArithmeticT>
+constexpr ArithmeticT symmetric_scale(std::size_t i, std::size_t j,
+                                      dimension d) {
+  if constexpr (std::is_same_v<FormationPol, formation_across>)
+    return ArithmeticT{1};
+  else
+    return ArithmeticT{1} /
+           shear_weight<FormationPol, ArithmeticT>(voigt_index(i, j, d), d);
+}
+
+// ================================
+
+template <arithmetical ArithmeticT>
+inline void eigenvalues2(ArithmeticT a11, ArithmeticT a22, ArithmeticT a12,
+                         ArithmeticT* l) {
+  ArithmeticT const m = (a11 + a22) / 2;
+  ArithmeticT const h = (a11 - a22) / 2;
+  ArithmeticT const r = std::sqrt(h * h + a12 * a12);
+  l[0]                = m + r;
+  l[1]                = m - r;
+}
+
+/** \brief Rotation Angle of the Major Principal Axis */
+template <arithmetical ArithmeticT>
+inline ArithmeticT principal_angle2(ArithmeticT a11, ArithmeticT a22,
+                                    ArithmeticT a12) {
+  return std::atan2(2 * a12, a11 - a22) / 2;
+}
+
+/**
+ * \brief Trigonometric Eigenvalues of a Symmetric 3 x 3 Matrix
+ */
+
+template <arithmetical ArithmeticT>
+inline void eigenvalues3(ArithmeticT a11, ArithmeticT a22, ArithmeticT a33,
+                         ArithmeticT a23, ArithmeticT a13, ArithmeticT a12,
+                         ArithmeticT* l) {
+  ArithmeticT const q   = (a11 + a22 + a33) / 3;
+  ArithmeticT const b11 = a11 - q, b22 = a22 - q, b33 = a33 - q;
+  ArithmeticT const p1  = a23 * a23 + a13 * a13 + a12 * a12;
+  ArithmeticT const p2  = b11 * b11 + b22 * b22 + b33 * b33 + 2 * p1;
+  ArithmeticT const p   = std::sqrt(p2 / 6);
+  ArithmeticT const ip  = p > 0 ? 1 / p : 0;
+
+  ArithmeticT const det = b11 * (b22 * b33 - a23 * a23) -
+                          a12 * (a12 * b33 - a23 * a13) +
+                          a13 * (a12 * a23 - b22 * a13);
+  ArithmeticT const r =
+      std::min(ArithmeticT{1},
+               std::max(ArithmeticT{-1}, det * ip * ip * ip / 2));
+  ArithmeticT const phi = std::acos(r) / 3;
+
+  l[0] = q + 2 * p * std::cos(phi);
+  l[2] = q + 2 * p * std::cos(phi + 2 * std::numbers::pi_v<ArithmeticT> / 3);
+  l[1] = 3 * q - l[0] - l[2];
+}
+
+/**
+ * \brief Unit Null Vector of A - l I from the Largest Cross Product of Rows
+ */
+
+template <arithmetical ArithmeticT>
+inline void eigenvector3(ArithmeticT a11, ArithmeticT a22, ArithmeticT a33,
+                         ArithmeticT a23, ArithmeticT a13, ArithmeticT a12,
+                         ArithmeticT l, ArithmeticT* v) {
+  ArithmeticT const r0[3] = {a11 - l, a12, a13};
+  ArithmeticT const r1[3] = {a12, a22 - l, a23};
+  ArithmeticT const r2[3] = {a13, a23, a33 - l};
+
+  auto const cross = [](ArithmeticT const* x, ArithmeticT const* y,
+                        ArithmeticT* z) {
+    z[0] = x[1] * y[2] - x[2] * y[1];
+    z[1] = x[2] * y[0] - x[0] * y[2];
+    z[2] = x[0] * y[1] - x[1] * y[0];
+    return z[0] * z[0] + z[1] * z[1] + z[2] * z[2];
+  };
+
+  ArithmeticT c0[3], c1[3], c2[3];
+  ArithmeticT const n0 = cross(r0, r1, c0);
+  ArithmeticT const n1 = cross(r0, r2, c1);
+  ArithmeticT const n2 = cross(r1, r2, c2);
+
+  bool const        s1 = n1 > n0;
+  ArithmeticT const nb = s1 ? n1 : n0;
+  bool const        s2 = n2 > nb;
+  ArithmeticT const nm = s2 ? n2 : nb;
+  ArithmeticT const in = nm > 0 ? 1 / std::sqrt(nm) : 0;
+  for (std::size_t i = 0; i < 3; ++i)
+    v[i] = (s2 ? c2[i] : (s1 ? c1[i] : c0[i])) * in;
+}
+
+/**
+ * \brief Cyclic Jacobi Eigen-Decomposition of a Symmetric 3 x 3 Matrix
+ * \note  Fallback for (near-)repeated eigenvalues; sorted descending
+ */
+
+template <arithmetical ArithmeticT>
+inline void jacobi3(ArithmeticT a11, ArithmeticT a22, ArithmeticT a33,
+                    ArithmeticT a23, ArithmeticT a13, ArithmeticT a12,
+                    ArithmeticT* l, ArithmeticT* vectors) {
+  ArithmeticT a[3][3] = {{a11, a12, a13}, {a12, a22, a23}, {a13, a23, a33}};
+  ArithmeticT v[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+
+  constexpr ArithmeticT eps = std::numeric_limits<ArithmeticT>::epsilon();
+  ArithmeticT const     norm =
+      a11 * a11 + a22 * a22 + a33 * a33 +
+      2 * (a23 * a23 + a13 * a13 + a12 * a12);
+
+  for (int sweep = 0; sweep < 32; ++sweep) {
+    ArithmeticT const off =
+        a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+    if (off <= eps * eps * norm)
+      break;
+
+    for (std::size_t p = 0; p < 2; ++p)
+      for (std::size_t q = p + 1; q < 3; ++q) {
+        if (a[p][q] == 0)
+          continue;
+        ArithmeticT const theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+        ArithmeticT const t =
+            std::copysign(ArithmeticT{1}, theta) /
+            (std::abs(theta) + std::sqrt(theta * theta + 1));
+        ArithmeticT const c = 1 / std::sqrt(t * t + 1);
+        ArithmeticT const s = t * c;
+
+        for (std::size_t k = 0; k < 3; ++k) {
+          ArithmeticT const akp = a[k][p], akq = a[k][q];
+          a[k][p]               = c * akp - s * akq;
+          a[k][q]               = s * akp + c * akq;
+        }
+        for (std::size_t k = 0; k < 3; ++k) {
+          ArithmeticT const apk = a[p][k], aqk = a[q][k];
+          a[p][k]               = c * apk - s * aqk;
+          a[q][k]               = s * apk + c * aqk;
+        }
+        for (std::size_t k = 0; k < 3; ++k) {
+          ArithmeticT const vkp = v[k][p], vkq = v[k][q];
+          v[k][p]               = c * vkp - s * vkq;
+          v[k][q]               = s * vkp + c * vkq;
+        }
+      }
+  }
+
+  std::array<std::size_t, 3> order = {0, 1, 2};
+  std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+    return a[x][x] > a[y][y];
+  });
+  for (std::size_t k = 0; k < 3; ++k) {
+    l[k] = a[order[k]][order[k]];
+    for (std::size_t i = 0; i < 3; ++i)
+      vectors[i * 3 + k] = v[i][order[k]];
+  }
+}
+
+/**
+ * \brief Closed-Form 3-D Eigen-Decomposition
+ * \return false when the eigenvectors need the Jacobi fallback
+ */
+
+template <arithmetical ArithmeticT>
+inline bool eigen3(ArithmeticT a11, ArithmeticT a22, ArithmeticT a33,
+                   ArithmeticT a23, ArithmeticT a13, ArithmeticT a12,
+                   ArithmeticT* l, ArithmeticT* vectors) {
+  eigenvalues3(a11, a22, a33, a23, a13, a12, l);
+
+  ArithmeticT v0[3], v2[3];
+  eigenvector3(a11, a22, a33, a23, a13, a12, l[0], v0);
+  eigenvector3(a11, a22, a33, a23, a13, a12, l[2], v2);
+
+  // make v2 exactly orthogonal to v0, then v1 = v2 x v0 (right-handed)
+  ArithmeticT const d  = v0[0] * v2[0] + v0[1] * v2[1] + v0[2] * v2[2];
+  for (std::size_t i = 0; i < 3; ++i)
+    v2[i] -= d * v0[i];
+  ArithmeticT const nn = v2[0] * v2[0] + v2[1] * v2[1] + v2[2] * v2[2];
+  ArithmeticT const in = nn > 0 ? 1 / std::sqrt(nn) : 0;
+  for (std::size_t i = 0; i < 3; ++i)
+    v2[i] *= in;
+  ArithmeticT const v1[3] = {v2[1] * v0[2] - v2[2] * v0[1],
+                             v2[2] * v0[0] - v2[0] * v0[2],
+                             v2[0] * v0[1] - v2[1] * v0[0]};
+
+  for (std::size_t i = 0; i < 3; ++i) {
+    vectors[i * 3 + 0] = v0[i];
+    vectors[i * 3 + 1] = v1[i];
+    vectors[i * 3 + 2] = v2[i];
+  }
+
+  // eigenvector error grows like (eigenvalue error) / (gap): the Cardano
+  // error near a repeated root is relative to the deviatoric spread, the
+  // rounding of A - l I relative to the largest eigenvalue, so a large
+  // hydrostatic part alone does not send a point to Jacobi
+  constexpr ArithmeticT eps = std::numeric_limits<ArithmeticT>::epsilon();
+  ArithmeticT const     tol =
+      std::max(std::sqrt(std::sqrt(eps)) * (l[0] - l[2]),
+               std::sqrt(eps) * std::max(std::abs(l[0]), std::abs(l[2])));
+  return std::min(l[0] - l[1], l[1] - l[2]) > tol;
+}
+
+} // namespace detail
+
+// ================================
+
+/**
+ * \brief Principal Values of a Symmetric Rank-2 Tensor (Descending)
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+  requires(D == dimension::two || D == dimension::three)
+inline auto
+eigenvalues(tensor<ArithmeticT, rank::tensor2, D, FormationPol> const& a) {
+  auto const at = [&](std::size_t i, std::size_t j) {
+    return a.value[detail::symmetric_row<FormationPol>(i, j, D)] *
+           detail::symmetric_scale<FormationPol, ArithmeticT>(i, j, D);
+  };
+
+  tensor<ArithmeticT, rank::vector, D, FormationPol> l;
+  if constexpr (D == dimension::two)
+    detail::eigenvalues2(at(0, 0), at(1, 1), at(0, 1), l.value.data());
+  else
+    detail::eigenvalues3(at(0, 0), at(1, 1), at(2, 2), at(1, 2), at(0, 2),
+                         at(0, 1), l.value.data());
+  return l;
+}
+
+/**
+ * \brief Principal Values and Axes of a Symmetric Rank-2 Tensor
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+  requires(D == dimension::two || D == dimension::three)
+inline void
+eigen(tensor<ArithmeticT, rank::tensor2, D, FormationPol> const&     a,
+      tensor<ArithmeticT, rank::vector, D, FormationPol>&            values,
+      tensor<ArithmeticT, rank::tensor2, D, formation_across>&       vectors) {
+  auto const at = [&](std::size_t i, std::size_t j) {
+    return a.value[detail::symmetric_row<FormationPol>(i, j, D)] *
+           detail::symmetric_scale<FormationPol, ArithmeticT>(i, j, D);
+  };
+
+  if constexpr (D == dimension::two) {
+    detail::eigenvalues2(at(0, 0), at(1, 1), at(0, 1), values.value.data());
+    ArithmeticT const t = detail::principal_angle2(at(0, 0), at(1, 1), at(0, 1));
+    ArithmeticT const c = std::cos(t), s = std::sin(t);
+    vectors.value       = {c, -s, s, c};
+  } else {
+    ArithmeticT const a11 = at(0, 0), a22 = at(1, 1), a33 = at(2, 2);
+    ArithmeticT const a23 = at(1, 2), a13 = at(0, 2), a12 = at(0, 1);
+    if (!detail::eigen3(a11, a22, a33, a23, a13, a12, values.value.data(),
+                        vectors.value.data()))
+      detail::jacobi3(a11, a22, a33, a23, a13, a12, values.value.data(),
+                      vectors.value.data());
+  }
+}
+
+// ================================
+
+/**
+ * \brief Batched Principal Values over a tensor_field
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+  requires(D == dimension::two || D == dimension::three)
+inline auto
+eigenvalues(tensor_field<ArithmeticT, rank::tensor2, D, FormationPol> const& a) {
+  constexpr std::size_t n  = dimension_t(D);
+  std::size_t const     np = a.size();
+  std::size_t const     ld = a.leading();
+
+  tensor_field<ArithmeticT, rank::vector, D, FormationPol> l(np);
+  ArithmeticT* const __restrict y = l.data();
+
+  auto const row = [&](std::size_t i, std::size_t j) {
+    return a.data() + detail::symmetric_row<FormationPol>(i, j, D) * ld;
+  };
+  auto const scale = [](std::size_t i, std::size_t j) {
+    return detail::symmetric_scale<FormationPol, ArithmeticT>(i, j, D);
+  };
+
+  if constexpr (D == dimension::two) {
+    ArithmeticT const* const __restrict x11 = row(0, 0);
+    ArithmeticT const* const __restrict x22 = row(1, 1);
+    ArithmeticT const* const __restrict x12 = row(0, 1);
+    ArithmeticT const                   s12 = scale(0, 1);
+    for (std::size_t p = 0; p < np; ++p) {
+      ArithmeticT e[n];
+      detail::eigenvalues2(x11[p], x22[p], s12 * x12[p], e);
+      y[p]      = e[0];
+      y[ld + p] = e[1];
+    }
+  } else {
+    ArithmeticT const* const __restrict x11 = row(0, 0);
+    ArithmeticT const* const __restrict x22 = row(1, 1);
+    ArithmeticT const* const __restrict x33 = row(2, 2);
+    ArithmeticT const* const __restrict x23 = row(1, 2);
+    ArithmeticT const* const __restrict x13 = row(0, 2);
+    ArithmeticT const* const __restrict x12 = row(0, 1);
+    ArithmeticT const s23 = scale(1, 2), s13 = scale(0, 2), s12 = scale(0, 1);
+    for (std::size_t p = 0; p < np; ++p) {
+      ArithmeticT e[n];
+      detail::eigenvalues3(x11[p], x22[p], x33[p], s23 * x23[p],
+                           s13 * x13[p], s12 * x12[p], e);
+      y[p]          = e[0];
+      y[ld + p]     = e[1];
+      y[2 * ld + p] = e[2];
+    }
+  }
+  return l;
+}
+
+/**
+ * \brief Batched Principal Values and Axes over a tensor_field
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+  requires(D == dimension::two || D == dimension::three)
+inline void
+eigen(tensor_field<ArithmeticT, rank::tensor2, D, FormationPol> const& a,
+      tensor_field<ArithmeticT, rank::vector, D, FormationPol>&        values,
+      tensor_field<ArithmeticT, rank::tensor2, D, formation_across>&   vectors) {
+  constexpr std::size_t n  = dimension_t(D);
+  std::size_t const     np = a.size();
+  std::size_t const     ld = a.leading();
+
+  values  = tensor_field<ArithmeticT, rank::vector, D, FormationPol>(np);
+  vectors = tensor_field<ArithmeticT, rank::tensor2, D, formation_across>(np);
+  ArithmeticT* const __restrict y = values.data();
+  ArithmeticT* const __restrict w = vectors.data();
+
+  auto const row = [&](std::size_t i, std::size_t j) {
+    return a.data() + detail::symmetric_row<FormationPol>(i, j, D) * ld;
+  };
+  auto const scale = [](std::size_t i, std::size_t j) {
+    return detail::symmetric_scale<FormationPol, ArithmeticT>(i, j, D);
+  };
+
+  if constexpr (D == dimension::two) {
+    ArithmeticT const* const __restrict x11 = row(0, 0);
+    ArithmeticT const* const __restrict x22 = row(1, 1);
+    ArithmeticT const* const __restrict x12 = row(0, 1);
+    ArithmeticT const                   s12 = scale(0, 1);
+    for (std::size_t p = 0; p < np; ++p) {
+      ArithmeticT e[n];
+      ArithmeticT const a12 = s12 * x12[p];
+      detail::eigenvalues2(x11[p], x22[p], a12, e);
+      ArithmeticT const t = detail::principal_angle2(x11[p], x22[p], a12);
+      ArithmeticT const c = std::cos(t), s = std::sin(t);
+      y[p]          = e[0];
+      y[ld + p]     = e[1];
+      w[p]          = c;
+      w[ld + p]     = -s;
+      w[2 * ld + p] = s;
+      w[3 * ld + p] = c;
+    }
+  } else {
+    ArithmeticT const* const __restrict x11 = row(0, 0);
+    ArithmeticT const* const __restrict x22 = row(1, 1);
+    ArithmeticT const* const __restrict x33 = row(2, 2);
+    ArithmeticT const* const __restrict x23 = row(1, 2);
+    ArithmeticT const* const __restrict x13 = row(0, 2);
+    ArithmeticT const* const __restrict x12 = row(0, 1);
+    ArithmeticT const s23 = scale(1, 2), s13 = scale(0, 2), s12 = scale(0, 1);
+
+    std::vector<unsigned char> fallback(np);
+    for (std::size_t p = 0; p < np; ++p) {
+      ArithmeticT e[n], v[n * n];
+      fallback[p] = !detail::eigen3(x11[p], x22[p], x33[p], s23 * x23[p],
+                                    s13 * x13[p], s12 * x12[p], e, v);
+      for (std::size_t i = 0; i < n; ++i)
+        y[i * ld + p] = e[i];
+      for (std::size_t k = 0; k < n * n; ++k)
+        w[k * ld + p] = v[k];
+    }
+
+    for (std::size_t p = 0; p < np; ++p) {
+      if (!fallback[p])
+        continue;
+      ArithmeticT e[n], v[n * n];
+      detail::jacobi3(x11[p], x22[p], x33[p], s23 * x23[p], s13 * x13[p],
+                      s12 * x12[p], e, v);
+      for (std::size_t i = 0; i < n; ++i)
+        y[i * ld + p] = e[i];
+      for (std::size_t k = 0; k < n * n; ++k)
+        w[k * ld + p] = v[k];
+    }
+  }
+}
+
+/**
+ * \brief Batched von Mises Equivalent sqrt(3/2 s:s) of a Stress Field
+ * \note  In 2-D the out-of-plane stress is taken as zero (plane stress)
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+  requires(D == dimension::two || D == dimension::three)
+inline auto
+von_mises(tensor_field<ArithmeticT, rank::tensor2, D, FormationPol> const& a) {
+  std::size_t const np = a.size();
+  std::size_t const ld = a.leading();
+
+  tensor_field<ArithmeticT, rank::scalar, D, FormationPol> m(np);
+  ArithmeticT* const __restrict y = m.data();
+
+  auto const row = [&](std::size_t i, std::size_t j) {
+    return a.data() + detail::symmetric_row<FormationPol>(i, j, D) * ld;
+  };
+  auto const scale = [](std::size_t i, std::size_t j) {
+    return detail::symmetric_scale<FormationPol, ArithmeticT>(i, j, D);
+  };
+
+  if constexpr (D == dimension::two) {
+    ArithmeticT const* const __restrict x11 = row(0, 0);
+    ArithmeticT const* const __restrict x22 = row(1, 1);
+    ArithmeticT const* const __restrict x12 = row(0, 1);
+    ArithmeticT const                   s12 = scale(0, 1);
+    for (std::size_t p = 0; p < np; ++p) {
+      ArithmeticT const a12 = s12 * x12[p];
+      y[p] = std::sqrt(x11[p] * x11[p] - x11[p] * x22[p] + x22[p] * x22[p] +
+                       3 * a12 * a12);
+    }
+  } else {
+    ArithmeticT const* const __restrict x11 = row(0, 0);
+    ArithmeticT const* const __restrict x22 = row(1, 1);
+    ArithmeticT const* const __restrict x33 = row(2, 2);
+    ArithmeticT const* const __restrict x23 = row(1, 2);
+    ArithmeticT const* const __restrict x13 = row(0, 2);
+    ArithmeticT const* const __restrict x12 = row(0, 1);
+    ArithmeticT const s23 = scale(1, 2), s13 = scale(0, 2), s12 = scale(0, 1);
+    for (std::size_t p = 0; p < np; ++p) {
+      ArithmeticT const d1 = x11[p] - x22[p];
+      ArithmeticT const d2 = x22[p] - x33[p];
+      ArithmeticT const d3 = x33[p] - x11[p];
+      ArithmeticT const a23 = s23 * x23[p], a13 = s13 * x13[p],
+                        a12 = s12 * x12[p];
+      y[p] = std::sqrt((d1 * d1 + d2 * d2 + d3 * d3) / 2 +
+                       3 * (a23 * a23 + a13 * a13 + a12 * a12));
+    }
+  }
+  return m;
+}
+
+// ================================
+
+} // namespace xmicrostructure
@@ -0,0 +1,428 @@
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \brief In-Tree Complex Fast Fourier Transform on Periodic Grids
+ * \note  One-dimensional lines use a self-sorting (Stockham) mixed-radix
+ *        scheme with radix 4, 2, 3 and 5 butterflies; any other prime
+ *        factor falls back to a direct O(p^2) butterfly, so extents with
+ *        small factors are fastest
+ * \note  Multi-dimensional transforms run line by line along each axis;
+ *        the lines of an axis are shared among threads
+ */
+
+namespace detail {
+
+/**
+ * \class fourier_line
+ * \brief Plan of a Forward 1-D DFT of Length n: Factors and Twiddles
+ * \note  Stage s of radix p combines p transforms of length l into one of
+ *        length l p: y[s L + j + l u] = sum_q w_p^(q u) w_L^(q j) x[(s + q r) l + j]
+ */
+
+class fourier_line {
+
+public:
+  using complex_type = std::complex<double>;
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  fourier_line() = default;
+
+  explicit fourier_line(std::size_t a_length) : length{a_length} {
+    assert(length > 0);
+
+    std::size_t m = length;
+    for (std::size_t const p : {std::size_t{4}, std::size_t{2}, std::size_t{3},
+                                std::size_t{5}})
+      while (m % p == 0) {
+        radix.push_back(p);
+        m /= p;
+      }
+    for (std::size_t p = 7; m > 1; p += 2)
+      while (m % p == 0) {
+        radix.push_back(p);
+        m /= p;
+      }
+
+    std::size_t l = 1;
+    for (std::size_t const p : radix) {
+      std::size_t const L = l * p;
+      offset.push_back(twiddle.size());
+      for (std::size_t q = 1; q < p; ++q)
+        for (std::size_t j = 0; j < l; ++j)
+          twiddle.push_back(root(q * j, L));
+      l = L;
+    }
+
+    // p-th roots of unity of the generic butterflies
+    unit_offset.assign(radix.size(), 0);
+    for (std::size_t s = 0; s < radix.size(); ++s)
+      if (radix[s] > 5) {
+        unit_offset[s] = roots.size();
+        for (std::size_t k = 0; k < radix[s]; ++k)
+          roots.push_back(root(k, radix[s]));
+        widest = std::max(widest, radix[s]);
+      }
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return length; }
+
+  /** \brief Length of the Scratch t that forward needs (0 for 2, 3, 5) */
+  [[nodiscard]] std::size_t scratch() const { return widest; }
+
+  /**
+   * \brief Forward Transform of x using the Scratch y (both of Length n)
+   *        and t (of Length scratch())
+   * \return the buffer holding the result, x or y
+   */
+
+  complex_type* forward(complex_type* x, complex_type* y,
+                        complex_type* t = nullptr) const {
+    std::size_t l = 1;
+    for (std::size_t s = 0; s < radix.size(); ++s) {
+      std::size_t const p = radix[s];
+      std::size_t const r = length / (l * p);
+      complex_type const* const w = twiddle.data() + offset[s];
+      switch (p) {
+      case 2:  stage2(x, y, l, r, w); break;
+      case 3:  stage3(x, y, l, r, w); break;
+      case 4:  stage4(x, y, l, r, w); break;
+      case 5:  stage5(x, y, l, r, w); break;
+      default: stage(x, y, l, r, p, w, roots.data() + unit_offset[s], t);
+               break;
+      }
+      std::swap(x, y);
+      l *= p;
+    }
+    return x;
+  }
+
+  // --------------------------------
+
+private:
+  static complex_type root(std::size_t k, std::size_t n) {
+    double const a = -2. * std::numbers::pi * double(k % n) / double(n);
+    return {std::cos(a), std::sin(a)};
+  }
+
+  /** \brief Multiply by -i */
+  static complex_type rotate(complex_type a) { return {a.imag(), -a.real()}; }
+
+  static void stage2(complex_type const* x, complex_type* y, std::size_t l,
+                     std::size_t r, complex_type const* w) {
+    for (std::size_t s = 0; s < r; ++s) {
+      complex_type const* const x0 = x + s * l;
+      complex_type const* const x1 = x + (s + r) * l;
+      complex_type* const       y0 = y + s * 2 * l;
+      for (std::size_t j = 0; j < l; ++j) {
+        complex_type const a = x0[j], b = x1[j] * w[j];
+        y0[j]     = a + b;
+        y0[j + l] = a - b;
+      }
+    }
+  }
+
+  static void stage3(complex_type const* x, complex_type* y, std::size_t l,
+                     std::size_t r, complex_type const* w) {
+    constexpr double c = -0.5, s3 = 0.86602540378443864676;
+    for (std::size_t s = 0; s < r; ++s) {
+      complex_type* const y0 = y + s * 3 * l;
+      for (std::size_t j = 0; j < l; ++j) {
+        complex_type const a = x[s * l + j];
+        complex_type const b = x[(s + r) * l + j] * w[j];
+        complex_type const d = x[(s + 2 * r) * l + j] * w[l + j];
+        complex_type const t = b + d;
+        complex_type const m = a + c * t;
+        complex_type const n = s3 * rotate(b - d);
+        y0[j]         = a + t;
+        y0[j + l]     = m + n;
+        y0[j + 2 * l] = m - n;
+      }
+    }
+  }
+
+  static void stage4(complex_type const* x, complex_type* y, std::size_t l,
+                     std::size_t r, complex_type const* w) {
+    for (std::size_t s = 0; s < r; ++s) {
+      complex_type* const y0 = y + s * 4 * l;
+      for (std::size_t j = 0; j < l; ++j) {
+        complex_type const a = x[s * l + j];
+        complex_type const b = x[(s + r) * l + j] * w[j];
+        complex_type const c = x[(s + 2 * r) * l + j] * w[l + j];
+        complex_type const d = x[(s + 3 * r) * l + j] * w[2 * l + j];
+        complex_type const e = a + c, f = a - c;
+        complex_type const g = b + d, h = rotate(b - d);
+        y0[j]         = e + g;
+        y0[j + l]     = f + h;
+        y0[j + 2 * l] = e - g;
+        y0[j + 3 * l] = f - h;
+      }
+    }
+  }
+
+  static void stage5(complex_type const* x, complex_type* y, std::size_t l,
+                     std::size_t r, complex_type const* w) {
+    constexpr double c1 = 0.30901699437494742410, c2 = -0.80901699437494742410;
+    constexpr double s1 = 0.95105651629515357212, s2 = 0.58778525229247312917;
+    for (std::size_t s = 0; s < r; ++s) {
+      complex_type* const y0 = y + s * 5 * l;
+      for (std::size_t j = 0; j < l; ++j) {
+        complex_type const a = x[s * l + j];
+        complex_type const b = x[(s + r) * l + j] * w[j];
+        complex_type const c = x[(s + 2 * r) * l + j] * w[l + j];
+        complex_type const d = x[(s + 3 * r) * l + j] * w[2 * l + j];
+        complex_type const e = x[(s + 4 * r) * l + j] * w[3 * l + j];
+        complex_type const t1 = b + e, t2 = c + d;
+        complex_type const u1 = rotate(b - e), u2 = rotate(c - d);
+        complex_type const m1 = a + c1 * t1 + c2 * t2;
+        complex_type const m2 = a + c2 * t1 + c1 * t2;
+        complex_type const n1 = s1 * u1 + s2 * u2;
+        complex_type const n2 = s2 * u1 - s1 * u2;
+        y0[j]         = a + t1 + t2;
+        y0[j + l]     = m1 + n1;
+        y0[j + 2 * l] = m2 + n2;
+        y0[j + 3 * l] = m2 - n2;
+        y0[j + 4 * l] = m1 - n1;
+      }
+    }
+  }
+
+  /** \brief Direct Butterfly of any Radix */
+  static void stage(complex_type const* x, complex_type* y, std::size_t l,
+                    std::size_t r, std::size_t p, complex_type const* w,
+                    complex_type const* unit, complex_type* t) {
+    assert(t != nullptr);
+    for (std::size_t s = 0; s < r; ++s)
+      for (std::size_t j = 0; j < l; ++j) {
+        t[0] = x[s * l + j];
+        for (std::size_t q = 1; q < p; ++q)
+          t[q] = x[(s + q * r) * l + j] * w[(q - 1) * l + j];
+        for (std::size_t u = 0; u < p; ++u) {
+          complex_type sum = t[0];
+          for (std::size_t q = 1; q < p; ++q)
+            sum += t[q] * unit[(q * u) % p];
+          y[s * p * l + j + l * u] = sum;
+        }
+      }
+  }
+
+  // --------------------------------
+
+private:
+  std::size_t               length = 0;
+  std::size_t               widest = 0;
+  std::vector<std::size_t>  radix;
+  std::vector<std::size_t>  offset;
+  std::vector<complex_type> twiddle;
+  std::vector<std::size_t>  unit_offset;
+  std::vector<complex_type> roots;
+};
+
+} // namespace detail
+
+// ================================
+
+/**
+ * \class fourier
+ * \brief Plan of a D-Dimensional Complex DFT over a Row-Major Grid
+ * \note  Axis 0 is contiguous. forward computes the unnormalised sum
+ *        X_k = sum_x x_x exp(-2 pi i k.x / n); inverse undoes it exactly,
+ *        including the 1/N factor
+ * \note  The plan owns its per-thread scratch lines, including the work
+ *        space of the generic butterflies, and every line plan holds its
+ *        twiddles and roots, so repeated transforms allocate no buffers
+ */
+
+template <std::size_t DimensionN>
+class fourier {
+
+public:
+  using complex_type = std::complex<double>;
+  using index_type   = std::array<std::size_t, DimensionN>;
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  explicit fourier(index_type a_extent, std::size_t a_threads = 0)
+      : extent{a_extent}, blocks{detail::concurrency(a_threads)} {
+    std::size_t longest = 0;
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      stride[a] = points;
+      points *= extent[a];
+      line[a]   = detail::fourier_line(extent[a]);
+      longest   = std::max(longest, 2 * extent[a] + line[a].scratch());
+    }
+    scratch.assign(blocks, std::vector<complex_type>(longest));
+  }
+
+  // --------------------------------
+
+public:
+  void forward(std::span<complex_type> a_data) { transform(a_data, false); }
+
+  void inverse(std::span<complex_type> a_data) {
+    transform(a_data, true);
+    double const scale = 1. / double(points);
+    for (complex_type& z : a_data)
+      z *= scale;
+  }
+
+  /** \brief Signed Frequency Index of Fourier Coefficient k along Axis a */
+  [[nodiscard]] std::ptrdiff_t frequency(std::size_t a, std::size_t k) const {
+    return 2 * k < extent[a] ? std::ptrdiff_t(k)
+                             : std::ptrdiff_t(k) - std::ptrdiff_t(extent[a]);
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return points; }
+  [[nodiscard]] index_type const& shape() const { return extent; }
+
+  // --------------------------------
+
+private:
+  /** \brief Every Axis in Turn; the Inverse by Conjugation */
+  void transform(std::span<complex_type> data, bool conjugate) {
+    assert(data.size() == points);
+
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      std::size_t const n     = extent[a];
+      std::size_t const lines = points / n;
+      std::size_t const step  = stride[a];
+
+      detail::parallel_blocks(
+          lines, blocks, [&](std::size_t b, std::size_t begin, std::size_t end) {
+            complex_type* const x = scratch[b].data();
+            complex_type* const y = x + n;
+            for (std::size_t l = begin; l < end; ++l) {
+              // first element of line l: l split around axis a
+              complex_type* const first =
+                  data.data() + (l / step) * step * n + l % step;
+
+              for (std::size_t k = 0; k < n; ++k)
+                x[k] = conjugate && a == 0 ? std::conj(first[k * step])
+                                           : first[k * step];
+              complex_type const* const z = line[a].forward(x, y, y + n);
+              for (std::size_t k = 0; k < n; ++k)
+                first[k * step] =
+                    conjugate && a + 1 == DimensionN ? std::conj(z[k]) : z[k];
+            }
+          });
+    }
+  }
+
+  // --------------------------------
+
+private:
+  index_type                                   extent;
+  index_type                                   stride{};
+  std::size_t                                  points = 1;
+  std::size_t                                  blocks;
+  std::array<detail::fourier_line, DimensionN> line;
+  std::vector<std::vector<complex_type>>       scratch;
+};
+
+// ================================
+
+#if X_MICROSTRUCTURE_SOLVER > 0
+
+/**
+ * \class solver_fourier
+ * \brief The fourier Interface over the Solver Library FFT (lib/solver)
+ * \note  Plans come from the library cache; butterflies run on eight lines
+ *        at once in split real/imaginary buffers, so it is the transform of
+ *        choice for the spectral solvers. The library grid is row-major, so
+ *        the axes are handed over in reverse
+ */
+
+template <std::size_t DimensionN>
+  requires(DimensionN >= 1 && DimensionN <= 3)
+class solver_fourier {
+
+public:
+  using complex_type = std::complex<double>;
+  using index_type   = std::array<std::size_t, DimensionN>;
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  explicit solver_fourier(index_type a_extent, std::size_t a_threads = 0)
+      : extent{a_extent}, threads{a_threads} {
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      layout[DimensionN - 1 - a] = extent[a];
+      points *= extent[a];
+    }
+  }
+
+  // --------------------------------
+
+public:
+  void forward(std::span<complex_type> a_data) {
+    assert(a_data.size() == points);
+    microstructure::libraries::solver::fft(
+        a_data, layout, microstructure::libraries::solver::direction::forward,
+        threads);
+  }
+
+  void inverse(std::span<complex_type> a_data) {
+    assert(a_data.size() == points);
+    microstructure::libraries::solver::fft(
+        a_data, layout, microstructure::libraries::solver::direction::backward,
+        threads);
+    double const scale = 1. / double(points);
+    for (complex_type& z : a_data)
+      z *= scale;
+  }
+
+  /** \brief Signed Frequency Index of Fourier Coefficient k along Axis a */
+  [[nodiscard]] std::ptrdiff_t frequency(std::size_t a, std::size_t k) const {
+    return 2 * k < extent[a] ? std::ptrdiff_t(k)
+                             : std::ptrdiff_t(k) - std::ptrdiff_t(extent[a]);
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return points; }
+  [[nodiscard]] index_type const& shape() const { return extent; }
+
+  // --------------------------------
+
+private:
+  index_type  extent;
+  index_type  layout{};
+  std::size_t points = 1;
+  std::size_t threads;
+};
+
+/** \brief Transform of the Spectral Solvers: the Solver Library's */
+template <std::size_t DimensionN>
+using fourier_t = solver_fourier<DimensionN>;
+
+#else // |X_MICROSTRUCTURE_SOLVER
+
+/** \brief Transform of the Spectral Solvers: the In-Tree fourier */
+template <std::size_t DimensionN>
+using fourier_t = fourier<DimensionN>;
+
+#endif // !X_MICROSTRUCTURE_SOLVER
+
+// ================================
+
+} // namespace xmicrostructure
@@ -0,0 +1,140 @@
+#pragma once
+
+namespace xmicrostructure {
+
+namespace detail {
+
+/**
+ * \brief Invoke f(block, begin, end) on Contiguous Blocks of [0, count)
+ * \note  One std::jthread per block beyond the first, which the caller runs
+ */
+
+template <class FunctionF>
+void parallel_blocks(std::size_t count, std::size_t blocks, FunctionF&& f) {
+  blocks = std::max<std::size_t>(1, std::min(blocks, count));
+  if (blocks == 1) {
+    f(std::size_t{0}, std::size_t{0}, count);
+    return;
+  }
+
+  std::size_t const chunk = (count + blocks - 1) / blocks;
+
+  std::vector<std::jthread> worker;
+  worker.reserve(blocks - 1);
+  for (std::size_t b = 1; b < blocks; ++b) {
+    std::size_t const begin = std::min(b * chunk, count);
+    std::size_t const end   = std::min(begin + chunk, count);
+    worker.emplace_back([&f, b, begin, end] { f(b, begin, end); });
+  }
+  f(std::size_t{0}, std::size_t{0}, std::min(chunk, count));
+}
+
+/**
+ * \class worker_pool
+ * \brief Persistent Workers that Run One Task at a Time
+ * \note  run(f) calls f(worker) once on every worker, the caller acting as
+ *        worker 0, and returns when all calls have returned. The threads
+ *        live as long as the pool, so repeated short tasks pay a wake-up
+ *        rather than a thread start
+ */
+
+class worker_pool {
+
+public:
+  explicit worker_pool(std::size_t a_workers = 1)
+      : workers{std::max<std::size_t>(1, a_workers)} {
+    thread.reserve(workers - 1);
+    for (std::size_t w = 1; w < workers; ++w)
+      thread.emplace_back([this, w] { loop(w); });
+  }
+
+  ~worker_pool() {
+    {
+      std::lock_guard lock{mutex};
+      stop = true;
+    }
+    wake.notify_all();
+  }
+
+  worker_pool(worker_pool const&)            = delete;
+  worker_pool& operator=(worker_pool const&) = delete;
+
+  // --------------------------------
+
+public:
+  template <std::invocable<std::size_t> FunctionF>
+  void run(FunctionF&& f) {
+    if (workers == 1) {
+      f(std::size_t{0});
+      return;
+    }
+
+    {
+      std::lock_guard lock{mutex};
+      context = const_cast<void*>(static_cast<void const*>(&f));
+      task    = [](void* c, std::size_t w) {
+        (*static_cast<std::remove_reference_t<FunctionF>*>(c))(w);
+      };
+      pending = workers - 1;
+      ++generation;
+    }
+    wake.notify_all();
+
+    f(std::size_t{0});
+
+    std::unique_lock lock{mutex};
+    done.wait(lock, [this] { return pending == 0; });
+  }
+
+  [[nodiscard]] std::size_t size() const { return workers; }
+
+  // --------------------------------
+
+private:
+  void loop(std::size_t w) {
+    std::size_t seen = 0;
+    for (;;) {
+      std::unique_lock lock{mutex};
+      wake.wait(lock, [&] { return stop || generation != seen; });
+      if (stop)
+        return;
+      seen = generation;
+      lock.unlock();
+
+      task(context, w);
+
+      lock.lock();
+      if (--pending == 0)
+        done.notify_one();
+    }
+  }
+
+  // --------------------------------
+
+private:
+  using task_type = void (*)(void*, std::size_t);
+
+  std::size_t               workers;
+  std::mutex                mutex;
+  std::condition_variable   wake, done;
+  void*                     context    = nullptr;
+  task_type                 task       = nullptr;
+  std::size_t               pending    = 0;
+  std::size_t               generation = 0;
+  bool                      stop       = false;
+  std::vector<std::jthread> thread; // last, so it joins before the rest goes
+};
+
+// ================================
+
+inline std::size_t concurrency(std::size_t threads) {
+  if (threads > 0)
+    return threads;
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+} // namespace detail
+
+// ================================
+
+} // namespace xmicrostructure
@@ -0,0 +1,225 @@
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \brief Rotation of Rank-2 and Rank-4 Tensors into Grain Frames
+ * \note  A rotation is a formation_across rank-2 tensor R with components
+ *        transforming as a'_ij = R_ik R_jl a_kl and
+ *        C'_ijkl = R_ip R_jq R_kr R_ls C_pqrs
+ * \note  Symmetric rank-4 tensors rotate as C' = M C M^T with the m x m
+ *        Mandel Bond matrix M of R (orthogonal, m = n(n+1)/2); Voigt
+ *        tensors are rescaled to Mandel and back around that product
+ */
+
+// ================================
+
+/**
+ * \brief Rotation Matrix of Bunge Euler Angles (z-x-z, radians)
+ * \note  This is the passive sample-to-crystal matrix g; its transpose
+ *        takes crystal components into the sample frame
+ */
+
+template <arithmetical ArithmeticT>
+inline auto bunge(ArithmeticT phi1, ArithmeticT Phi, ArithmeticT phi2) {
+  ArithmeticT const c1 = std::cos(phi1), s1 = std::sin(phi1);
+  ArithmeticT const c  = std::cos(Phi), s = std::sin(Phi);
+  ArithmeticT const c2 = std::cos(phi2), s2 = std::sin(phi2);
+
+  return tensor<ArithmeticT, rank::tensor2, dimension::three,
+                formation_across>{{c1 * c2 - s1 * s2 * c,
+                                   s1 * c2 + c1 * s2 * c, s2 * s,
+                                   -c1 * s2 - s1 * c2 * c,
+                                   -s1 * s2 + c1 * c2 * c, c2 * s, s1 * s,
+                                   -c1 * s, c}};
+}
+
+namespace detail {
+
+/**
+ * \brief Mandel Bond Matrix Entry M_IJ of the Rotation R
+ * \note  M_IJ = (w_I / w_J) (R_ik R_jl + R_il R_jk) / (1 + d_kl) with
+ *        (i, j) = pair(I), (k, l) = pair(J) and w the Mandel weights
+ */
+
+template <arithmetical ArithmeticT, dimension D>
+constexpr ArithmeticT bond_weight(std::size_t I, std::size_t J) {
+  auto const [k, l] = voigt_pair(J, D);
+  return shear_weight<formation_mandel, ArithmeticT>(I, D) /
+         shear_weight<formation_mandel, ArithmeticT>(J, D) /
+         (k == l ? 2 : 1);
+}
+
+template <arithmetical ArithmeticT, dimension D, class RotationF>
+constexpr ArithmeticT bond(std::size_t I, std::size_t J, RotationF&& r) {
+  auto const [i, j] = voigt_pair(I, D);
+  auto const [k, l] = voigt_pair(J, D);
+  return bond_weight<ArithmeticT, D>(I, J) *
+         (r(i, k) * r(j, l) + r(i, l) * r(j, k));
+}
+
+/** \brief Dense m x m Mandel Matrix of a Rank-4 Tensor in any Policy */
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+constexpr auto
+mandel_matrix(tensor<ArithmeticT, rank::tensor4, D, FormationPol> const& c) {
+  constexpr std::size_t m = symmetric_t(rank::tensor2, D);
+
+  auto const cm = formation_cast<formation_mandel>(c);
+
+  std::array<ArithmeticT, m * m> k{};
+  for (std::size_t I = 0; I < m; ++I)
+    for (std::size_t J = 0; J < m; ++J)
+      k[I * m + J] = cm.value[packed_index(I, J, m)];
+  return k;
+}
+
+} // namespace detail
+
+// ================================
+
+/**
+ * \brief Rotate a Rank-2 Tensor: R a R^T
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+inline auto
+rotate(tensor<ArithmeticT, rank::tensor2, D, FormationPol> const&     a,
+       tensor<ArithmeticT, rank::tensor2, D, formation_across> const& r) {
+  constexpr std::size_t n = dimension_t(D);
+
+  auto const ra = dot(r, formation_cast<formation_across>(a));
+
+  tensor<ArithmeticT, rank::tensor2, D, formation_across> o;
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t k = 0; k < n; ++k)
+        o.value[i * n + j] += ra.value[i * n + k] * r.value[j * n + k];
+  return formation_cast<FormationPol>(o);
+}
+
+/**
+ * \brief Rotate a Symmetric Rank-4 Tensor through its Mandel Bond Matrix
+ * \note  formation_across tensors are assumed to carry minor and major
+ *        symmetry and are rotated in Mandel form
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+inline auto
+rotate(tensor<ArithmeticT, rank::tensor4, D, FormationPol> const&     c,
+       tensor<ArithmeticT, rank::tensor2, D, formation_across> const& r) {
+  constexpr std::size_t n = dimension_t(D);
+  constexpr std::size_t m = symmetric_t(rank::tensor2, D);
+
+  auto const k   = detail::mandel_matrix(c);
+  auto const rij = [&](std::size_t i, std::size_t j) {
+    return r.value[i * n + j];
+  };
+
+  std::array<ArithmeticT, m * m> b{};
+  for (std::size_t I = 0; I < m; ++I)
+    for (std::size_t J = 0; J < m; ++J)
+      b[I * m + J] = detail::bond<ArithmeticT, D>(I, J, rij);
+
+  // t = K M^T, then the upper triangle of M t
+  std::array<ArithmeticT, m * m> t{};
+  for (std::size_t I = 0; I < m; ++I)
+    for (std::size_t J = 0; J < m; ++J)
+      for (std::size_t K = 0; K < m; ++K)
+        t[I * m + J] += k[I * m + K] * b[J * m + K];
+
+  tensor<ArithmeticT, rank::tensor4, D, formation_mandel> o;
+  for (std::size_t I = 0; I < m; ++I)
+    for (std::size_t J = I; J < m; ++J)
+      for (std::size_t K = 0; K < m; ++K)
+        o.value[detail::packed_index(I, J, m)] += b[I * m + K] * t[K * m + J];
+  return formation_cast<FormationPol>(o);
+}
+
+/**
+ * \brief Batched Rotation of one Reference Rank-4 Tensor into many Frames
+ * \note  Grains are processed in blocks of lane points; the Bond matrices
+ *        and the intermediate product of a block are held component-major
+ *        so that every inner loop runs across grains
+ */
+
+template <class FormationPol, arithmetical ArithmeticT, dimension D,
+          class ReferencePol>
+  requires symmetric_v<FormationPol>
+inline auto
+rotate(tensor<ArithmeticT, rank::tensor4, D, ReferencePol> const&           c,
+       tensor_field<ArithmeticT, rank::tensor2, D, formation_across> const& r) {
+  constexpr std::size_t n    = dimension_t(D);
+  constexpr std::size_t m    = symmetric_t(rank::tensor2, D);
+  constexpr std::size_t lane = 64;
+
+  std::size_t const np = r.size();
+  std::size_t const ld = r.leading();
+
+  auto const k = detail::mandel_matrix(c);
+
+  tensor_field<ArithmeticT, rank::tensor4, D, FormationPol> o(np);
+  std::size_t const lo = o.leading();
+
+  std::vector<ArithmeticT> b(m * m * lane), t(m * m * lane);
+
+  for (std::size_t p0 = 0; p0 < np; p0 += lane) {
+    std::size_t const nb = std::min(lane, np - p0);
+
+    // Bond matrices of the block
+    for (std::size_t I = 0; I < m; ++I)
+      for (std::size_t J = 0; J < m; ++J) {
+        auto const [i, j]  = detail::voigt_pair(I, D);
+        auto const [kk, l] = detail::voigt_pair(J, D);
+
+        ArithmeticT const w = detail::bond_weight<ArithmeticT, D>(I, J);
+        auto const row = [&](std::size_t u, std::size_t v) {
+          return r.data() + (u * n + v) * ld + p0;
+        };
+        ArithmeticT const* const __restrict rik = row(i, kk);
+        ArithmeticT const* const __restrict rjl = row(j, l);
+        ArithmeticT const* const __restrict ril = row(i, l);
+        ArithmeticT const* const __restrict rjk = row(j, kk);
+        ArithmeticT* const __restrict       y   = b.data() + (I * m + J) * lane;
+        for (std::size_t q = 0; q < nb; ++q)
+          y[q] = w * (rik[q] * rjl[q] + ril[q] * rjk[q]);
+      }
+
+    // t = K M^T
+    std::fill(t.begin(), t.end(), ArithmeticT{});
+    for (std::size_t I = 0; I < m; ++I)
+      for (std::size_t J = 0; J < m; ++J) {
+        ArithmeticT* const __restrict y = t.data() + (I * m + J) * lane;
+        for (std::size_t K = 0; K < m; ++K) {
+          ArithmeticT const                   kik = k[I * m + K];
+          ArithmeticT const* const __restrict x   = b.data() + (J * m + K) * lane;
+          for (std::size_t q = 0; q < nb; ++q)
+            y[q] += kik * x[q];
+        }
+      }
+
+    // upper triangle of M t, rescaled to the target policy
+    for (std::size_t I = 0; I < m; ++I)
+      for (std::size_t J = I; J < m; ++J) {
+        ArithmeticT const s =
+            detail::shear_weight<FormationPol, ArithmeticT>(I, D) *
+            detail::shear_weight<FormationPol, ArithmeticT>(J, D) /
+            (detail::shear_weight<formation_mandel, ArithmeticT>(I, D) *
+             detail::shear_weight<formation_mandel, ArithmeticT>(J, D));
+        ArithmeticT* const __restrict y =
+            o.data() + detail::packed_index(I, J, m) * lo + p0;
+        for (std::size_t K = 0; K < m; ++K) {
+          ArithmeticT const* const __restrict x0 = b.data() + (I * m + K) * lane;
+          ArithmeticT const* const __restrict x1 = t.data() + (K * m + J) * lane;
+          for (std::size_t q = 0; q < nb; ++q)
+            y[q] += x0[q] * x1[q];
+        }
+        for (std::size_t q = 0; q < nb; ++q)
+          y[q] *= s;
+      }
+  }
+  return o;
+}
+
+// ================================
+
+} // namespace xmicrostructure
@@ -37,7 +37,7 @@ constexpr std::size_t dimension_t(dimension const& d) {
 
 /**
  * \brief R-Rank and D-Dimensional Tensor Size with Redundancies
- * \todo  Correction for Redundacies
+ * \note  See symmetric_t for the size without redundancies
  */
 
 constexpr std::size_t tensor_t(rank const& r, dimension const& d) {
@@ -61,12 +61,150 @@ constexpr std::size_t tensor_t(rank const& r, dimension const& d) {
 
 // ================================
 
+namespace detail {
+
+/**
+ * \brief Compile-Time Unrolled Loop: f(std::integral_constant<I>) for I < N
+ * \note  Straight-line code lets the compiler vectorise every tensor_t(R, D)
+ */
+
+template <std::size_t N, class FunctionF>
+constexpr void unroll(FunctionF&& f) {
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    (f(std::integral_constant<std::size_t, I>{}), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+} // namespace detail
+
+// ================================
+
+/**
+ * \brief Accumulation Type of Contractions and Reductions
+ * \note  float state is summed in double so that memory-bound kernels can
+ *        halve their traffic without losing accuracy in the reductions
+ */
+
+template <arithmetical ArithmeticT>
+struct accumulation {
+  using type = ArithmeticT;
+};
+
+template <>
+struct accumulation<float> {
+  using type = double;
+};
+
+template <arithmetical ArithmeticT>
+using accumulate_t = typename accumulation<ArithmeticT>::type;
+
+// ================================
+
 /**
  * \brief Default Formation Policies
- * \todo  <unfinished>
+ * \note  Symmetric policies store rank-2 tensors as n(n+1)/2 components in
+ *        Voigt order (11, 22, 33, 23, 13, 12) and rank-4 tensors with minor
+ *        and major symmetry as the packed upper triangle of that matrix
  */
 
 struct formation_across; // l-to-r stride
+struct formation_voigt;  // symmetric, tensor components (shear weight 1)
+struct formation_mandel; // symmetric, sqrt(2)-weighted shear components
+
+/**
+ * \brief R-Rank and D-Dimensional Tensor Size without Redundancies
+ */
+
+constexpr std::size_t symmetric_t(rank const& r, dimension const& d) {
+  std::size_t const m = dimension_t(d) * (dimension_t(d) + 1) / 2;
+  switch (r) {
+  case rank::scalar:
+    return 1;
+    break;
+  case rank::vector:
+    return dimension_t(d);
+    break;
+  case rank::tensor2:
+    return m;
+    break;
+  case rank::tensor4:
+    return m * (m + 1) / 2;
+    break;
+  default:
+    return 1;
+    break;
+  }
+}
+
+/**
+ * \brief Stored Size under a Formation Policy
+ */
+
+template <class FormationPol>
+constexpr std::size_t formation_t(rank const& r, dimension const& d) {
+  if constexpr (std::is_same_v<FormationPol, formation_across>)
+    return tensor_t(r, d);
+  else
+    return symmetric_t(r, d);
+}
+
+template <class FormationPol>
+inline constexpr bool symmetric_v =
+    std::is_same_v<FormationPol, formation_voigt> ||
+    std::is_same_v<FormationPol, formation_mandel>;
+
+namespace detail {
+
+/**
+ * \brief Voigt Index I of the Pair (i, j) and its Inverse
+ */
+
+constexpr std::size_t voigt_index(std::size_t i, std::size_t j, dimension d) {
+  if (i == j)
+    return i;
+  if (dimension_t(d) == 2)
+    return 2;
+  return 6 - i - j; // (1,2) -> 3, (0,2) -> 4, (0,1) -> 5
+}
+
+constexpr std::pair<std::size_t, std::size_t> voigt_pair(std::size_t I,
+                                                         dimension   d) {
+  constexpr std::pair<std::size_t, std::size_t> shear[3] = {
+      {1, 2}, {0, 2}, {0, 1}};
+  std::size_t const n = dimension_t(d);
+  if (I < n)
+    return {I, I};
+  if (n == 2)
+    return {0, 1};
+  return shear[I - 3];
+}
+
+/**
+ * \brief Position of (I, J) in the Packed Upper Triangle of an m x m Matrix
+ */
+
+constexpr std::size_t packed_index(std::size_t I, std::size_t J,
+                                   std::size_t m) {
+  if (I > J)
+    std::swap(I, J);
+  return I * m - I * (I - 1) / 2 + (J - I);
+}
+
+/**
+ * \brief Shear Weight of Voigt Component I under a Formation Policy
+ */
+
+template <class FormationPol, arithmetical ArithmeticT>
+constexpr ArithmeticT shear_weight(std::size_t I, dimension d) {
+  if (I < dimension_t(d))
+    return ArithmeticT{1};
+  if constexpr (std::is_same_v<FormationPol, formation_mandel>)
+    return std::numbers::sqrt2_v<ArithmeticT>;
+  else
+    return ArithmeticT{1};
+}
+
+} // namespace detail
 
 // ================================
 
@@ -107,36 +245,42 @@ public:
 
 public:
 
-    // CONSTRUCTORS
-  tensor () {}
+  // CONSTRUCTORS
+
+  constexpr tensor() : value{} {}
+
+  constexpr explicit tensor(std::array<ArithmeticT, formation_t<FormationPol>(R, D)> const& a_value)
+      : value{a_value} {}
+
+  constexpr tensor(tensor_type const&) = default;
 
 public:
   // ASSIGNMENT: COPY, MOVE, ...
 
-  tensor_type& operator=(tensor_type const& other) {
-    // TODO
+  constexpr tensor_type& operator=(tensor_type const& other) {
+    detail::unroll<formation_t<FormationPol>(R, D)>([&](auto i) { value[i] = other.value[i]; });
     return *this;
   }
 
   // ARITHMETIC OVERLOADS
 
-  tensor_type& operator+=(tensor_type const& rhs) {
-    // TODO
+  constexpr tensor_type& operator+=(tensor_type const& rhs) {
+    detail::unroll<formation_t<FormationPol>(R, D)>([&](auto i) { value[i] += rhs.value[i]; });
     return *this;
   }
 
-  tensor_type& operator-=(tensor_type const& rhs) {
-    // TODO
+  constexpr tensor_type& operator-=(tensor_type const& rhs) {
+    detail::unroll<formation_t<FormationPol>(R, D)>([&](auto i) { value[i] -= rhs.value[i]; });
     return *this;
   }
 
-  tensor_type& operator*=(ArithmeticT const& s) {
-    // TODO
+  constexpr tensor_type& operator*=(ArithmeticT const& s) {
+    detail::unroll<formation_t<FormationPol>(R, D)>([&](auto i) { value[i] *= s; });
     return *this;
   }
 
-  tensor_type& operator/=(ArithmeticT const& s) {
-    // TODO
+  constexpr tensor_type& operator/=(ArithmeticT const& s) {
+    detail::unroll<formation_t<FormationPol>(R, D)>([&](auto i) { value[i] /= s; });
     return *this;
   }
 
@@ -147,20 +291,20 @@ public:
   // --------------------------------
 
 public:
-  ArithmeticT& operator[](index_t i) { return value[i]; }
+  constexpr ArithmeticT& operator[](index_t i) { return value[i]; }
 
-  ArithmeticT const operator[](index_t i) const { return value[i]; }
+  constexpr ArithmeticT const operator[](index_t i) const { return value[i]; }
 
   // --------------------------------
 
 public:
-  std::array<ArithmeticT, tensor_t(R, D)> value;
+  std::array<ArithmeticT, formation_t<FormationPol>(R, D)> value;
 };
 
 template <arithmetical ArithmeticT, rank R, dimension D,
           class FormationPol>
 inline constexpr auto
-operator+(tensor<ArithmeticT, R, D, FormationPol>& lhs,
+operator+(tensor<ArithmeticT, R, D, FormationPol> lhs,
           tensor<ArithmeticT, R, D, FormationPol> const& rhs) {
   lhs += rhs;
   return lhs;
@@ -169,12 +313,36 @@ operator+(tensor<ArithmeticT, R, D, FormationPol>& lhs,
 template <arithmetical ArithmeticT, rank R, dimension D,
           class FormationPol>
 inline constexpr auto
-operator-(tensor<ArithmeticT, R, D, FormationPol>& lhs,
+operator-(tensor<ArithmeticT, R, D, FormationPol> lhs,
           tensor<ArithmeticT, R, D, FormationPol> const& rhs) {
   lhs -= rhs;
   return lhs;
 }
 
+template <arithmetical ArithmeticT, rank R, dimension D,
+          class FormationPol>
+inline constexpr auto
+operator*(tensor<ArithmeticT, R, D, FormationPol> lhs, ArithmeticT const& s) {
+  lhs *= s;
+  return lhs;
+}
+
+template <arithmetical ArithmeticT, rank R, dimension D,
+          class FormationPol>
+inline constexpr auto
+operator*(ArithmeticT const& s, tensor<ArithmeticT, R, D, FormationPol> rhs) {
+  rhs *= s;
+  return rhs;
+}
+
+template <arithmetical ArithmeticT, rank R, dimension D,
+          class FormationPol>
+inline constexpr auto
+operator/(tensor<ArithmeticT, R, D, FormationPol> lhs, ArithmeticT const& s) {
+  lhs /= s;
+  return lhs;
+}
+
 template <arithmetical ArithmeticT, rank R, dimension D,
           class FormationPol>
 std::ostream& operator<< ( std::ostream& os, tensor<ArithmeticT, R, D, FormationPol> const& a_tensor ) {
@@ -188,6 +356,232 @@ std::ostream& operator<< ( std::ostream& os, tensor<ArithmeticT, R, D, Formation
 
 // ================================
 
+/**
+ * \brief Single Contraction of Rank-2 Tensors: C_ij = A_ik B_kj
+ */
+
+template <arithmetical ArithmeticT, dimension D>
+inline constexpr auto
+dot(tensor<ArithmeticT, rank::tensor2, D, formation_across> const& a,
+    tensor<ArithmeticT, rank::tensor2, D, formation_across> const& b) {
+  constexpr std::size_t n = dimension_t(D);
+
+  tensor<ArithmeticT, rank::tensor2, D, formation_across> c;
+  detail::unroll<n * n>([&](auto ij) {
+    constexpr std::size_t i = decltype(ij)::value / n;
+    constexpr std::size_t j = decltype(ij)::value % n;
+    accumulate_t<ArithmeticT> s{};
+    detail::unroll<n>([&](auto k) {
+      s += accumulate_t<ArithmeticT>(a.value[i * n + k]) * b.value[k * n + j];
+    });
+    c.value[ij] = static_cast<ArithmeticT>(s);
+  });
+  return c;
+}
+
+/**
+ * \brief Double Contraction of Rank-2 Tensors: A_ij B_ij
+ */
+
+template <arithmetical ArithmeticT, dimension D>
+inline constexpr auto
+ddot(tensor<ArithmeticT, rank::tensor2, D, formation_across> const& a,
+     tensor<ArithmeticT, rank::tensor2, D, formation_across> const& b) {
+  accumulate_t<ArithmeticT> s{};
+  detail::unroll<tensor_t(rank::tensor2, D)>([&](auto ij) {
+    s += accumulate_t<ArithmeticT>(a.value[ij]) * b.value[ij];
+  });
+  return s;
+}
+
+/**
+ * \brief Double Contraction of Rank-4 and Rank-2 Tensors: C_ijkl e_kl
+ * \note  With formation_across the rank-4 tensor is a row-major n^2 x n^2
+ *        matrix acting on the rank-2 tensor as an n^2 vector
+ */
+
+template <arithmetical ArithmeticT, dimension D>
+inline constexpr auto
+ddot(tensor<ArithmeticT, rank::tensor4, D, formation_across> const& c,
+     tensor<ArithmeticT, rank::tensor2, D, formation_across> const& e) {
+  constexpr std::size_t m = tensor_t(rank::tensor2, D);
+
+  tensor<ArithmeticT, rank::tensor2, D, formation_across> s;
+  detail::unroll<m>([&](auto ij) {
+    accumulate_t<ArithmeticT> t{};
+    detail::unroll<m>([&](auto kl) {
+      t += accumulate_t<ArithmeticT>(c.value[decltype(ij)::value * m + kl]) *
+           e.value[kl];
+    });
+    s.value[ij] = static_cast<ArithmeticT>(t);
+  });
+  return s;
+}
+
+// ================================
+
+/**
+ * \brief Double Contraction of Symmetric Rank-2 Tensors: A_ij B_ij
+ * \note  Voigt shear components appear twice in the full sum; Mandel
+ *        components already carry the sqrt(2) and need no weight
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+  requires symmetric_v<FormationPol>
+inline constexpr auto
+ddot(tensor<ArithmeticT, rank::tensor2, D, FormationPol> const& a,
+     tensor<ArithmeticT, rank::tensor2, D, FormationPol> const& b) {
+  constexpr std::size_t n = dimension_t(D);
+
+  accumulate_t<ArithmeticT> s{};
+  detail::unroll<symmetric_t(rank::tensor2, D)>([&](auto I) {
+    constexpr accumulate_t<ArithmeticT> w =
+        std::is_same_v<FormationPol, formation_voigt> &&
+                decltype(I)::value >= n
+            ? 2
+            : 1;
+    s += w * a.value[I] * b.value[I];
+  });
+  return s;
+}
+
+/**
+ * \brief Double Contraction of Symmetric Rank-4 and Rank-2 Tensors
+ * \note  The rank-4 tensor is the packed upper triangle of an m x m matrix
+ *        with m = n(n+1)/2; Voigt strains carry the engineering factor 2 on
+ *        shear, Mandel strains and stiffnesses are already normalised
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+  requires symmetric_v<FormationPol>
+inline constexpr auto
+ddot(tensor<ArithmeticT, rank::tensor4, D, FormationPol> const& c,
+     tensor<ArithmeticT, rank::tensor2, D, FormationPol> const& e) {
+  constexpr std::size_t n = dimension_t(D);
+  constexpr std::size_t m = symmetric_t(rank::tensor2, D);
+
+  std::array<accumulate_t<ArithmeticT>, m> x{};
+  detail::unroll<m>([&](auto J) {
+    constexpr accumulate_t<ArithmeticT> w =
+        std::is_same_v<FormationPol, formation_voigt> &&
+                decltype(J)::value >= n
+            ? 2
+            : 1;
+    x[J] = w * e.value[J];
+  });
+
+  tensor<ArithmeticT, rank::tensor2, D, FormationPol> s;
+  detail::unroll<m>([&](auto I) {
+    accumulate_t<ArithmeticT> t{};
+    detail::unroll<m>([&](auto J) {
+      constexpr std::size_t IJ =
+          detail::packed_index(decltype(I)::value, decltype(J)::value, m);
+      t += c.value[IJ] * x[J];
+    });
+    s.value[I] = static_cast<ArithmeticT>(t);
+  });
+  return s;
+}
+
+// ================================
+
+/**
+ * \brief Conversion between Formation Policies
+ * \note  Converting to a symmetric policy keeps the symmetric part of a
+ *        rank-2 tensor and the canonical (i <= j, k <= l, IJ <= KL)
+ *        representative of a rank-4 tensor; scalars and vectors are copied
+ */
+
+template <class ToPol, arithmetical ArithmeticT, rank R, dimension D,
+          class FromPol>
+inline constexpr auto
+formation_cast(tensor<ArithmeticT, R, D, FromPol> const& a) {
+  constexpr std::size_t n = dimension_t(D);
+
+  if constexpr (std::is_same_v<ToPol, FromPol> || R == rank::scalar ||
+                R == rank::vector) {
+    tensor<ArithmeticT, R, D, ToPol> b;
+    detail::unroll<formation_t<ToPol>(R, D)>(
+        [&](auto i) { b.value[i] = a.value[i]; });
+    return b;
+  } else if constexpr (symmetric_v<ToPol> && symmetric_v<FromPol>) {
+    return formation_cast<ToPol>(formation_cast<formation_across>(a));
+  } else if constexpr (R == rank::tensor2 &&
+                       std::is_same_v<FromPol, formation_across>) {
+    tensor<ArithmeticT, R, D, ToPol> b;
+    detail::unroll<symmetric_t(R, D)>([&](auto I) {
+      constexpr auto ij = detail::voigt_pair(decltype(I)::value, D);
+      b.value[I] = detail::shear_weight<ToPol, ArithmeticT>(I, D) *
+                   (a.value[ij.first * n + ij.second] +
+                    a.value[ij.second * n + ij.first]) /
+                   2;
+    });
+    return b;
+  } else if constexpr (R == rank::tensor2) {
+    tensor<ArithmeticT, R, D, ToPol> b;
+    detail::unroll<n * n>([&](auto ij) {
+      constexpr std::size_t I = detail::voigt_index(
+          decltype(ij)::value / n, decltype(ij)::value % n, D);
+      b.value[ij] =
+          a.value[I] / detail::shear_weight<FromPol, ArithmeticT>(I, D);
+    });
+    return b;
+  } else if constexpr (std::is_same_v<FromPol, formation_across>) {
+    constexpr std::size_t m = symmetric_t(rank::tensor2, D);
+
+    tensor<ArithmeticT, R, D, ToPol> b;
+    detail::unroll<m>([&](auto i) {
+      constexpr std::size_t I = decltype(i)::value;
+      detail::unroll<m - I>([&](auto k) {
+        constexpr std::size_t K  = I + decltype(k)::value;
+        constexpr auto        ij = detail::voigt_pair(I, D);
+        constexpr auto        kl = detail::voigt_pair(K, D);
+        b.value[detail::packed_index(I, K, m)] =
+            detail::shear_weight<ToPol, ArithmeticT>(I, D) *
+            detail::shear_weight<ToPol, ArithmeticT>(K, D) *
+            a.value[(ij.first * n + ij.second) * n * n + kl.first * n +
+                    kl.second];
+      });
+    });
+    return b;
+  } else {
+    constexpr std::size_t m = symmetric_t(rank::tensor2, D);
+
+    tensor<ArithmeticT, R, D, ToPol> b;
+    detail::unroll<n * n>([&](auto ij) {
+      detail::unroll<n * n>([&](auto kl) {
+        constexpr std::size_t I = detail::voigt_index(
+            decltype(ij)::value / n, decltype(ij)::value % n, D);
+        constexpr std::size_t K = detail::voigt_index(
+            decltype(kl)::value / n, decltype(kl)::value % n, D);
+        b.value[ij * n * n + kl] =
+            a.value[detail::packed_index(I, K, m)] /
+            (detail::shear_weight<FromPol, ArithmeticT>(I, D) *
+             detail::shear_weight<FromPol, ArithmeticT>(K, D));
+      });
+    });
+    return b;
+  }
+}
+
+// ================================
+
+/**
+ * \brief Conversion between Storage Precisions (e.g. double <-> float)
+ */
+
+template <arithmetical ToT, arithmetical ArithmeticT, rank R, dimension D,
+          class FormationPol>
+inline constexpr auto
+precision_cast(tensor<ArithmeticT, R, D, FormationPol> const& a) {
+  tensor<ToT, R, D, FormationPol> b;
+  detail::unroll<formation_t<FormationPol>(R, D)>(
+      [&](auto i) { b.value[i] = static_cast<ToT>(a.value[i]); });
+  return b;
+}
+
+// ================================
+
 /**
  * \brief Template Specialisations
  * \todo  <unfinished>
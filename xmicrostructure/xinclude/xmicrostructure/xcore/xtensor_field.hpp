@@ -0,0 +1,365 @@
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \class tensor_field
+ * \brief Tensors of N Material Points in Component-Major (SoA) Layout
+ * \note  Component c of every point is contiguous, so bulk operators are
+ *        plain loops over points that the compiler vectorises; a
+ *        std::vector<tensor<...>> interleaves components instead
+ * \note  Each component row is padded to a multiple of lane points
+ * \note  tensor_field<float, ...> halves the state traffic; contractions
+ *        and reductions accumulate in accumulate_t<float> = double
+ */
+
+template <arithmetical ArithmeticT, rank R, dimension D,
+          class FormationPol = formation_across>
+class tensor_field {
+
+public:
+  using tensor_type = tensor<ArithmeticT, R, D, FormationPol>;
+  using field_type  = tensor_field<ArithmeticT, R, D, FormationPol>;
+  using value_type  = ArithmeticT;
+  using size_type   = std::size_t;
+
+  static constexpr std::size_t components = formation_t<FormationPol>(R, D);
+  static constexpr std::size_t lane       = 64 / sizeof(ArithmeticT);
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  tensor_field() = default;
+
+  explicit tensor_field(std::size_t a_points)
+      : points{a_points}, stride{(a_points + lane - 1) / lane * lane},
+        value(components * stride, ArithmeticT{}) {}
+
+  tensor_field(std::size_t a_points, tensor_type const& a_tensor)
+      : tensor_field(a_points) {
+    fill(a_tensor);
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return points; }
+
+  /** \brief Contiguous Values of Component c over all Points */
+  [[nodiscard]] std::span<ArithmeticT> component(std::size_t c) {
+    return {value.data() + c * stride, points};
+  }
+
+  [[nodiscard]] std::span<ArithmeticT const> component(std::size_t c) const {
+    return {value.data() + c * stride, points};
+  }
+
+  /** \brief Gather / Scatter a Single Point */
+  [[nodiscard]] tensor_type get(std::size_t p) const {
+    tensor_type t;
+    detail::unroll<components>(
+        [&](auto c) { t.value[c] = value[c * stride + p]; });
+    return t;
+  }
+
+  void set(std::size_t p, tensor_type const& a_tensor) {
+    detail::unroll<components>(
+        [&](auto c) { value[c * stride + p] = a_tensor.value[c]; });
+  }
+
+  void fill(tensor_type const& a_tensor) {
+    for (std::size_t c = 0; c < components; ++c)
+      std::fill_n(value.data() + c * stride, points, a_tensor.value[c]);
+  }
+
+  // --------------------------------
+
+public:
+  // ARITHMETIC OVERLOADS
+
+  field_type& operator+=(field_type const& rhs) {
+    assert(rhs.points == points);
+    ArithmeticT* const __restrict       x = value.data();
+    ArithmeticT const* const __restrict y = rhs.value.data();
+    for (std::size_t i = 0; i < value.size(); ++i)
+      x[i] += y[i];
+    return *this;
+  }
+
+  field_type& operator-=(field_type const& rhs) {
+    assert(rhs.points == points);
+    ArithmeticT* const __restrict       x = value.data();
+    ArithmeticT const* const __restrict y = rhs.value.data();
+    for (std::size_t i = 0; i < value.size(); ++i)
+      x[i] -= y[i];
+    return *this;
+  }
+
+  field_type& operator*=(ArithmeticT const& s) {
+    ArithmeticT* const __restrict x = value.data();
+    for (std::size_t i = 0; i < value.size(); ++i)
+      x[i] *= s;
+    return *this;
+  }
+
+  /** \brief this += a * rhs */
+  field_type& axpy(ArithmeticT const& a, field_type const& rhs) {
+    assert(rhs.points == points);
+    ArithmeticT* const __restrict       x = value.data();
+    ArithmeticT const* const __restrict y = rhs.value.data();
+    for (std::size_t i = 0; i < value.size(); ++i)
+      x[i] += a * y[i];
+    return *this;
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] ArithmeticT* data() { return value.data(); }
+  [[nodiscard]] ArithmeticT const* data() const { return value.data(); }
+  [[nodiscard]] std::size_t leading() const { return stride; }
+
+private:
+  std::size_t              points = 0;
+  std::size_t              stride = 0;
+  std::vector<ArithmeticT> value;
+};
+
+template <arithmetical ArithmeticT, rank R, dimension D, class FormationPol>
+inline auto operator+(tensor_field<ArithmeticT, R, D, FormationPol> lhs,
+                      tensor_field<ArithmeticT, R, D, FormationPol> const& rhs) {
+  lhs += rhs;
+  return lhs;
+}
+
+template <arithmetical ArithmeticT, rank R, dimension D, class FormationPol>
+inline auto operator-(tensor_field<ArithmeticT, R, D, FormationPol> lhs,
+                      tensor_field<ArithmeticT, R, D, FormationPol> const& rhs) {
+  lhs -= rhs;
+  return lhs;
+}
+
+template <arithmetical ArithmeticT, rank R, dimension D, class FormationPol>
+inline auto operator*(ArithmeticT const& s,
+                      tensor_field<ArithmeticT, R, D, FormationPol> rhs) {
+  rhs *= s;
+  return rhs;
+}
+
+// ================================
+
+namespace detail {
+
+/**
+ * \brief Dense m x m Operator of a Constant Rank-4 Tensor acting on the
+ *        Stored Rank-2 Components (Voigt shear weights folded in)
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+constexpr auto
+stiffness_matrix(tensor<ArithmeticT, rank::tensor4, D, FormationPol> const& c) {
+  constexpr std::size_t n = dimension_t(D);
+  constexpr std::size_t m = formation_t<FormationPol>(rank::tensor2, D);
+
+  std::array<ArithmeticT, m * m> k{};
+  for (std::size_t I = 0; I < m; ++I)
+    for (std::size_t J = 0; J < m; ++J) {
+      if constexpr (std::is_same_v<FormationPol, formation_across>)
+        k[I * m + J] = c.value[I * m + J];
+      else
+        k[I * m + J] =
+            c.value[packed_index(I, J, m)] *
+            (std::is_same_v<FormationPol, formation_voigt> && J >= n ? 2 : 1);
+    }
+  return k;
+}
+
+} // namespace detail
+
+/**
+ * \brief Pointwise Double Contraction with a Constant Rank-4 Tensor:
+ *        s(p) = C : e(p)
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+inline auto
+ddot(tensor<ArithmeticT, rank::tensor4, D, FormationPol> const&        c,
+     tensor_field<ArithmeticT, rank::tensor2, D, FormationPol> const& e) {
+  using accumulate_type    = accumulate_t<ArithmeticT>;
+  constexpr std::size_t m = formation_t<FormationPol>(rank::tensor2, D);
+
+  auto const  k = detail::stiffness_matrix(c);
+  auto        s = tensor_field<ArithmeticT, rank::tensor2, D, FormationPol>(e.size());
+  std::size_t const ld = e.leading();
+
+  for (std::size_t I = 0; I < m; ++I) {
+    ArithmeticT* const __restrict       y = s.data() + I * ld;
+    ArithmeticT const* const __restrict x = e.data();
+    for (std::size_t p = 0; p < e.size(); ++p) {
+      accumulate_type t{};
+      detail::unroll<m>([&](auto J) {
+        t += accumulate_type(k[I * m + J]) * x[J * ld + p];
+      });
+      y[p] = static_cast<ArithmeticT>(t);
+    }
+  }
+  return s;
+}
+
+/**
+ * \brief Pointwise Trace of a Rank-2 Field
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+inline auto
+trace(tensor_field<ArithmeticT, rank::tensor2, D, FormationPol> const& e) {
+  constexpr std::size_t n = dimension_t(D);
+
+  auto t = tensor_field<ArithmeticT, rank::scalar, D, FormationPol>(e.size());
+  ArithmeticT* const __restrict       y  = t.data();
+  ArithmeticT const* const __restrict x  = e.data();
+  std::size_t const                   ld = e.leading();
+  for (std::size_t p = 0; p < e.size(); ++p) {
+    accumulate_t<ArithmeticT> s{};
+    detail::unroll<n>([&](auto i) {
+      constexpr std::size_t c = std::is_same_v<FormationPol, formation_across>
+                                    ? decltype(i)::value * (n + 1)
+                                    : decltype(i)::value;
+      s += x[c * ld + p];
+    });
+    y[p] = static_cast<ArithmeticT>(s);
+  }
+  return t;
+}
+
+/**
+ * \brief Pointwise Deviator of a Rank-2 Field: e - tr(e) I / n
+ */
+
+template <arithmetical ArithmeticT, dimension D, class FormationPol>
+inline auto
+deviator(tensor_field<ArithmeticT, rank::tensor2, D, FormationPol> e) {
+  constexpr std::size_t n = dimension_t(D);
+
+  auto const        t = trace(e);
+  ArithmeticT const inv = ArithmeticT{1} / n;
+  ArithmeticT const* const __restrict x = t.data();
+  for (std::size_t i = 0; i < n; ++i) {
+    std::size_t const c =
+        std::is_same_v<FormationPol, formation_across> ? i * n + i : i;
+    ArithmeticT* const __restrict y = e.data() + c * e.leading();
+    for (std::size_t p = 0; p < e.size(); ++p)
+      y[p] -= inv * x[p];
+  }
+  return e;
+}
+
+// ================================
+
+namespace detail {
+
+/**
+ * \brief Sum of f(p) over [0, n) in accumulate_t with Independent Partial
+ *        Sums, so that the loop vectorises without reassociation flags
+ */
+
+template <arithmetical ArithmeticT, class FunctionF>
+inline accumulate_t<ArithmeticT> reduce(std::size_t n, FunctionF&& f) {
+  constexpr std::size_t lane = 8;
+
+  accumulate_t<ArithmeticT> part[lane] = {};
+  std::size_t const         full       = n - n % lane;
+  std::size_t               p          = 0;
+  for (; p < full; p += lane)
+    for (std::size_t q = 0; q < lane; ++q)
+      part[q] += f(p + q);
+  for (; p < n; ++p)
+    part[0] += f(p);
+
+  accumulate_t<ArithmeticT> s{};
+  for (std::size_t q = 0; q < lane; ++q)
+    s += part[q];
+  return s;
+}
+
+} // namespace detail
+
+/**
+ * \brief Sum and Mean over Points, Accumulated in accumulate_t
+ */
+
+template <arithmetical ArithmeticT, rank R, dimension D, class FormationPol>
+inline auto sum(tensor_field<ArithmeticT, R, D, FormationPol> const& a) {
+  using field_type = tensor_field<ArithmeticT, R, D, FormationPol>;
+
+  tensor<accumulate_t<ArithmeticT>, R, D, FormationPol> s;
+  for (std::size_t c = 0; c < field_type::components; ++c) {
+    ArithmeticT const* const __restrict x = a.data() + c * a.leading();
+    s.value[c] = detail::reduce<ArithmeticT>(
+        a.size(), [&](std::size_t p) { return x[p]; });
+  }
+  return s;
+}
+
+template <arithmetical ArithmeticT, rank R, dimension D, class FormationPol>
+inline auto mean(tensor_field<ArithmeticT, R, D, FormationPol> const& a) {
+  auto s = sum(a);
+  if (a.size() > 0)
+    s /= accumulate_t<ArithmeticT>(a.size());
+  return s;
+}
+
+/**
+ * \brief Field Inner Product sum_p a(p) : b(p), Accumulated in accumulate_t
+ * \note  Voigt rank-2 shear components are weighted by 2 as in ddot
+ */
+
+template <arithmetical ArithmeticT, rank R, dimension D, class FormationPol>
+  requires(R != rank::tensor4)
+inline auto inner(tensor_field<ArithmeticT, R, D, FormationPol> const& a,
+                  tensor_field<ArithmeticT, R, D, FormationPol> const& b) {
+  using field_type = tensor_field<ArithmeticT, R, D, FormationPol>;
+  assert(a.size() == b.size());
+
+  accumulate_t<ArithmeticT> s{};
+  for (std::size_t c = 0; c < field_type::components; ++c) {
+    accumulate_t<ArithmeticT> const w =
+        R == rank::tensor2 && std::is_same_v<FormationPol, formation_voigt> &&
+                c >= dimension_t(D)
+            ? 2
+            : 1;
+    ArithmeticT const* const __restrict x = a.data() + c * a.leading();
+    ArithmeticT const* const __restrict y = b.data() + c * b.leading();
+    s += w * detail::reduce<ArithmeticT>(a.size(), [&](std::size_t p) {
+           return accumulate_t<ArithmeticT>(x[p]) * y[p];
+         });
+  }
+  return s;
+}
+
+/**
+ * \brief Conversion between Storage Precisions (e.g. double <-> float)
+ */
+
+template <arithmetical ToT, arithmetical ArithmeticT, rank R, dimension D,
+          class FormationPol>
+inline auto
+precision_cast(tensor_field<ArithmeticT, R, D, FormationPol> const& a) {
+  using field_type = tensor_field<ArithmeticT, R, D, FormationPol>;
+
+  tensor_field<ToT, R, D, FormationPol> b(a.size());
+  for (std::size_t c = 0; c < field_type::components; ++c) {
+    ArithmeticT const* const __restrict x = a.data() + c * a.leading();
+    ToT* const __restrict               y = b.data() + c * b.leading();
+    for (std::size_t p = 0; p < a.size(); ++p)
+      y[p] = static_cast<ToT>(x[p]);
+  }
+  return b;
+}
+
+// ================================
+
+} // namespace xmicrostructure
@@ -10,18 +10,28 @@ X_MICROSTRUCTURE_NAMESPACE_BEGIN X_MICROSTRUCTURE_NAMESPACE_END
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 
 #include <algorithm>
 #include <array>
+#include <complex>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <bit>
 #include <concepts>
+#include <numbers>
 #include <ranges>
 #include <span>
 
@@ -35,6 +45,14 @@ X_MICROSTRUCTURE_NAMESPACE_BEGIN X_MICROSTRUCTURE_NAMESPACE_END
 	#include <fmt/os.h>
 #endif
 
+#ifndef X_MICROSTRUCTURE_SOLVER
+	#define X_MICROSTRUCTURE_SOLVER 0
+#endif
+
+#if X_MICROSTRUCTURE_SOLVER > 0
+	#include <solver/fourier.hpp>
+#endif
+
 #ifndef X_MICROSTRUCTURE_GNUPLOT
 	#define X_MICROSTRUCTURE_GNUPLOT 1
 #endif
@@ -49,14 +67,14 @@ X_MICROSTRUCTURE_NAMESPACE_BEGIN X_MICROSTRUCTURE_NAMESPACE_END
 // tools
 #include "../../xtools/xrandomiser/xrandomiser.hpp"
 
-// libraries
-#include "../../xlib/xlearner/xlearner.hpp"
-#include "../../xlib/xsolver/xsolver.hpp"
-
 // local
 
 // core
 #include "xcore/xcore.hpp"
 #include "xconstant/xconstant.hpp"
 #include "xsimulation/xsimulation.hpp"
-#include "xvisualisation/xvisualisation.hpp"
\ No newline at end of file
+#include "xvisualisation/xvisualisation.hpp"
+
+// libraries
+#include "../../xlib/xlearner/xlearner.hpp"
+#include "../../xlib/xsolver/xsolver.hpp"
\ No newline at end of file
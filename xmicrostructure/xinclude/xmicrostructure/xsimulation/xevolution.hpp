@@ -0,0 +1,1103 @@
+#pragma once
+
+namespace xmicrostructure {
+
+// ================================
+
+/**
+ * \class potts
+ * \brief Q-State Potts Monte Carlo Grain Growth on a Periodic Lattice
+ * \note  Sites interact with their 3^D - 1 Moore neighbours (J = 1). The
+ *        lattice is split into 2^D colours by coordinate parity; sites of
+ *        one colour share no neighbours, so each colour is swept by all
+ *        threads at once without locks. Extents must therefore be even
+ * \note  A trial spin is drawn only from the distinct neighbour spins, so
+ *        grain interiors cost no random numbers and no rejected flips
+ * \note  Each thread block owns a randomiser stream; results are
+ *        reproducible for a given seed and thread count
+ */
+
+template <std::size_t DimensionN>
+  requires(DimensionN == 2 || DimensionN == 3)
+class potts {
+
+public:
+  using spin_type  = std::uint32_t;
+  using index_type = std::array<std::size_t, DimensionN>;
+
+  static constexpr std::size_t stencil      = DimensionN == 2 ? 9 : 27;
+  static constexpr std::size_t coordination = stencil - 1;
+  static constexpr std::size_t colours      = std::size_t{1} << DimensionN;
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  potts(index_type a_extent, spin_type a_states, std::uint64_t a_seed = 0,
+        std::size_t a_threads = 0)
+      : extent{a_extent}, states{a_states},
+        blocks{detail::concurrency(a_threads)} {
+    assert(states > 0);
+
+    std::size_t n = 1;
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      assert(extent[a] >= 2 && extent[a] % 2 == 0);
+      stride[a] = n;
+      n *= extent[a];
+
+      minus[a].resize(extent[a]);
+      plus[a].resize(extent[a]);
+      for (std::size_t x = 0; x < extent[a]; ++x) {
+        minus[a][x] = (x == 0 ? extent[a] - 1 : x - 1) * stride[a];
+        plus[a][x]  = (x + 1 == extent[a] ? 0 : x + 1) * stride[a];
+      }
+    }
+    spin.resize(n);
+
+    for (std::size_t b = 0; b < blocks; ++b)
+      stream.emplace_back(a_seed, b);
+
+    detail::parallel_blocks(
+        n, blocks, [&](std::size_t b, std::size_t begin, std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i)
+            spin[i] = stream[b].below(states);
+        });
+  }
+
+  // --------------------------------
+
+public:
+  /**
+   * \brief One Monte Carlo Step: Every Site Visited once, Colour by Colour
+   * \param kT temperature in units of J; 0 accepts only non-increasing moves
+   */
+
+  void sweep(double kT = 0.) {
+    std::array<double, coordination + 1> boltzmann{};
+    for (std::size_t e = 0; e <= coordination; ++e)
+      boltzmann[e] = kT > 0. ? std::exp(-double(e) / kT) : 0.;
+
+    for (std::size_t c = 0; c < colours; ++c)
+      sweep_colour(c, boltzmann);
+    ++steps;
+  }
+
+  void sweep(std::size_t count, double kT) {
+    for (std::size_t s = 0; s < count; ++s)
+      sweep(kT);
+  }
+
+  /** \brief Number of Unlike Neighbour Pairs (Energy in Units of J) */
+  [[nodiscard]] std::size_t energy() const {
+    std::size_t unlike = 0;
+    for (std::size_t i = 0; i < spin.size(); ++i) {
+      std::array<std::size_t, stencil> nb;
+      neighbours(coordinates(i), nb);
+      // each pair once: the upper half of the stencil
+      for (std::size_t k = stencil / 2 + 1; k < stencil; ++k)
+        unlike += spin[nb[k]] != spin[i];
+    }
+    return unlike;
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return spin.size(); }
+  [[nodiscard]] index_type const& shape() const { return extent; }
+  [[nodiscard]] spin_type q() const { return states; }
+  [[nodiscard]] std::size_t time() const { return steps; }
+
+  [[nodiscard]] std::span<spin_type> spins() { return spin; }
+  [[nodiscard]] std::span<spin_type const> spins() const { return spin; }
+
+  [[nodiscard]] std::size_t index(index_type const& x) const {
+    std::size_t i = 0;
+    for (std::size_t a = 0; a < DimensionN; ++a)
+      i += x[a] * stride[a];
+    return i;
+  }
+
+  [[nodiscard]] index_type coordinates(std::size_t i) const {
+    index_type x;
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      x[a] = i % extent[a];
+      i /= extent[a];
+    }
+    return x;
+  }
+
+  // --------------------------------
+
+private:
+  /** \brief Flat Indices of the 3^D Stencil (Centre at stencil / 2) */
+  void neighbours(index_type const& x,
+                  std::array<std::size_t, stencil>& nb) const {
+    std::array<std::array<std::size_t, 3>, DimensionN> c;
+    for (std::size_t a = 0; a < DimensionN; ++a)
+      c[a] = {minus[a][x[a]], x[a] * stride[a], plus[a][x[a]]};
+
+    for (std::size_t k = 0; k < stencil; ++k) {
+      std::size_t i = 0, r = k;
+      for (std::size_t a = 0; a < DimensionN; ++a, r /= 3)
+        i += c[a][r % 3];
+      nb[k] = i;
+    }
+  }
+
+  void sweep_colour(std::size_t c,
+                    std::array<double, coordination + 1> const& boltzmann) {
+    // lines along axis 0 with the colour's parity in the other axes
+    std::size_t lines = 1;
+    for (std::size_t a = 1; a < DimensionN; ++a)
+      lines *= extent[a] / 2;
+
+    detail::parallel_blocks(
+        lines, blocks, [&](std::size_t b, std::size_t begin, std::size_t end) {
+          randomiser& rng = stream[b];
+          for (std::size_t l = begin; l < end; ++l) {
+            index_type x;
+            std::size_t r = l;
+            for (std::size_t a = 1; a < DimensionN; ++a) {
+              x[a] = ((c >> a) & 1) + 2 * (r % (extent[a] / 2));
+              r /= extent[a] / 2;
+            }
+            for (x[0] = c & 1; x[0] < extent[0]; x[0] += 2)
+              flip(x, rng, boltzmann);
+          }
+        });
+  }
+
+  void flip(index_type const& x, randomiser& rng,
+            std::array<double, coordination + 1> const& boltzmann) {
+    std::array<std::size_t, stencil> nb;
+    neighbours(x, nb);
+
+    std::size_t const i = nb[stencil / 2];
+    spin_type const   s = spin[i];
+
+    std::array<spin_type, coordination> other;
+    std::size_t                         distinct = 0;
+    for (std::size_t k = 0; k < stencil; ++k) {
+      spin_type const t = spin[nb[k]];
+      if (k == stencil / 2 || t == s)
+        continue;
+      bool seen = false;
+      for (std::size_t d = 0; d < distinct; ++d)
+        seen |= other[d] == t;
+      if (!seen)
+        other[distinct++] = t;
+    }
+    if (distinct == 0)
+      return; // grain interior
+
+    spin_type const t = other[distinct == 1 ? 0 : rng.below(distinct)];
+
+    std::ptrdiff_t gain = 0; // like bonds gained, i.e. -dE
+    for (std::size_t k = 0; k < stencil; ++k) {
+      spin_type const u = spin[nb[k]];
+      gain += (u == t) - (u == s && k != stencil / 2);
+    }
+
+    if (gain >= 0 || rng.uniform() < boltzmann[std::size_t(-gain)])
+      spin[i] = t;
+  }
+
+  // --------------------------------
+
+private:
+  index_type                                       extent;
+  index_type                                       stride{};
+  spin_type                                        states;
+  std::size_t                                      blocks;
+  std::size_t                                      steps = 0;
+  std::vector<spin_type>                           spin;
+  std::array<std::vector<std::size_t>, DimensionN> minus, plus;
+  std::vector<randomiser>                          stream;
+};
+
+// ================================
+
+/**
+ * \brief Conserved (Cahn-Hilliard) or Non-Conserved (Allen-Cahn) Dynamics
+ */
+
+enum class phase_field_model { allen_cahn, cahn_hilliard };
+
+/**
+ * \class phase_field
+ * \brief Semi-Implicit Fourier-Spectral Phase-Field Evolution (Periodic)
+ * \note  Allen-Cahn:    d(phi)/dt = -L (f'(phi) - kappa lap phi)
+ *        Cahn-Hilliard: d(phi)/dt =  M lap (f'(phi) - kappa lap phi)
+ *        The stiff gradient term is implicit, f' explicit, with an optional
+ *        stabiliser S added implicitly and subtracted explicitly; time steps
+ *        are then bounded by accuracy, not by dx^2 / kappa
+ * \note  phi and f'(phi) are real, so one complex transform of phi + i f'
+ *        yields both spectra: a step costs one forward and one inverse FFT
+ * \note  FourierT is pluggable: any plan with forward, inverse and
+ *        frequency over std::complex<double> spans of the grid; the
+ *        default is the solver library FFT when it is linked
+ */
+
+template <std::size_t DimensionN, class FourierT = fourier_t<DimensionN>>
+class phase_field {
+
+public:
+  using complex_type = std::complex<double>;
+  using index_type   = std::array<std::size_t, DimensionN>;
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  /**
+   * \param a_mobility L (Allen-Cahn) or M (Cahn-Hilliard)
+   * \param a_gradient kappa
+   * \param a_spacing  grid spacing, equal along every axis
+   */
+
+  phase_field(index_type a_extent, phase_field_model a_model,
+              double a_mobility, double a_gradient, double a_spacing = 1.,
+              std::size_t a_threads = 0)
+      : extent{a_extent}, model{a_model}, mobility{a_mobility},
+        gradient{a_gradient}, blocks{detail::concurrency(a_threads)},
+        plan{a_extent, a_threads} {
+    assert(mobility > 0. && gradient >= 0. && a_spacing > 0.);
+
+    std::size_t n = 1;
+    for (std::size_t a = 0; a < DimensionN; ++a)
+      n *= extent[a];
+    value.assign(n, 0.);
+    spectrum.resize(n);
+    wave.resize(n);
+    mirror.resize(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+      double      k2 = 0.;
+      std::size_t r = i, m = 0, s = 1;
+      for (std::size_t a = 0; a < DimensionN; ++a) {
+        std::size_t const x = r % extent[a];
+        r /= extent[a];
+        double const k = 2. * std::numbers::pi *
+                         double(plan.frequency(a, x)) /
+                         (double(extent[a]) * a_spacing);
+        k2 += k * k;
+        m += ((extent[a] - x) % extent[a]) * s;
+        s *= extent[a];
+      }
+      wave[i]   = k2;
+      mirror[i] = m;
+    }
+  }
+
+  // --------------------------------
+
+public:
+  /**
+   * \brief Advance by dt; derivative(phi) returns f'(phi)
+   */
+
+  template <std::invocable<double> DerivativeF>
+  void step(double dt, DerivativeF&& derivative) {
+    std::size_t const n = value.size();
+
+    detail::parallel_blocks(
+        n, blocks, [&](std::size_t, std::size_t begin, std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i)
+            spectrum[i] = {value[i], derivative(value[i])};
+        });
+    plan.forward(spectrum);
+
+    // untangle phi^ and f'^ at the pair (k, -k) owned by its lower index
+    double const ldt = dt * mobility, S = stabiliser;
+    detail::parallel_blocks(
+        n, blocks, [&](std::size_t, std::size_t begin, std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i) {
+            std::size_t const m = mirror[i];
+            if (m < i)
+              continue;
+            complex_type const zi = spectrum[i], zm = std::conj(spectrum[m]);
+            complex_type const phi = 0.5 * (zi + zm);
+            complex_type const df  = complex_type{0., -0.5} * (zi - zm);
+
+            double const k2 = wave[i];
+            double const c  = model == phase_field_model::allen_cahn ? 1. : k2;
+            complex_type const next =
+                ((1. + ldt * c * S) * phi - ldt * c * df) /
+                (1. + ldt * c * (gradient * k2 + S));
+            spectrum[i] = next;
+            spectrum[m] = std::conj(next);
+          }
+        });
+
+    plan.inverse(spectrum);
+    detail::parallel_blocks(
+        n, blocks, [&](std::size_t, std::size_t begin, std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i)
+            value[i] = spectrum[i].real();
+        });
+    clock += dt;
+  }
+
+  template <std::invocable<double> DerivativeF>
+  void step(std::size_t count, double dt, DerivativeF&& derivative) {
+    for (std::size_t s = 0; s < count; ++s)
+      step(dt, derivative);
+  }
+
+  /** \brief Double-Well f = (phi^2 - 1)^2 / 4, Minima at phi = +-1 */
+  void step(double dt) {
+    step(dt, [](double phi) { return phi * (phi * phi - 1.); });
+  }
+
+  void step(std::size_t count, double dt) {
+    for (std::size_t s = 0; s < count; ++s)
+      step(dt);
+  }
+
+  // --------------------------------
+
+public:
+  /** \brief Implicit Stabiliser S, Typically max |f''| / 2 */
+  void stabilise(double a_stabiliser) {
+    assert(a_stabiliser >= 0.);
+    stabiliser = a_stabiliser;
+  }
+
+  [[nodiscard]] double mean() const {
+    double s = 0.;
+    for (double const v : value)
+      s += v;
+    return s / double(value.size());
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return value.size(); }
+  [[nodiscard]] index_type const& shape() const { return extent; }
+  [[nodiscard]] double time() const { return clock; }
+
+  [[nodiscard]] std::span<double> values() { return value; }
+  [[nodiscard]] std::span<double const> values() const { return value; }
+
+  // --------------------------------
+
+private:
+  index_type                extent;
+  phase_field_model         model;
+  double                    mobility;
+  double                    gradient;
+  double                    stabiliser = 0.;
+  double                    clock      = 0.;
+  std::size_t               blocks;
+  FourierT                  plan;
+  std::vector<double>       value;
+  std::vector<complex_type> spectrum;
+  std::vector<double>       wave;
+  std::vector<std::size_t>  mirror;
+};
+
+// ================================
+
+/**
+ * \class multi_phase_field
+ * \brief Multi-Order-Parameter Grain Growth with Sparse Active Sets
+ * \note  Fan-Chen free energy with one order parameter eta_g per grain:
+ *        f = sum_g (-eta_g^2 / 2 + eta_g^4 / 4) + gamma sum_g<h eta_g^2 eta_h^2
+ *        and d(eta_g)/dt = -L (df/d(eta_g) - kappa lap eta_g)
+ * \note  Each site stores at most ActiveN (grain, eta) pairs; a step only
+ *        visits the grains active at a site or at its face neighbours and
+ *        drops values below the threshold, so memory and work scale with
+ *        the local grain count, never with the number of grains
+ * \note  Explicit Euler on the (2D + 1)-point Laplacian, double buffered
+ *        so sites update concurrently: dt < dx^2 / (2 D L kappa)
+ */
+
+template <std::size_t DimensionN, std::size_t ActiveN = 6>
+  requires((DimensionN == 2 || DimensionN == 3) && ActiveN > 0 && ActiveN < 256)
+class multi_phase_field {
+
+public:
+  using grain_type = std::uint32_t;
+  using index_type = std::array<std::size_t, DimensionN>;
+
+  static constexpr std::size_t capacity   = ActiveN;
+  static constexpr std::size_t neighbours = 2 * DimensionN;
+  static constexpr grain_type  none = std::numeric_limits<grain_type>::max();
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  multi_phase_field(index_type a_extent, double a_mobility, double a_gradient,
+                    double a_interaction = 1.5, double a_spacing = 1.,
+                    std::size_t a_threads = 0)
+      : extent{a_extent}, mobility{a_mobility}, gradient{a_gradient},
+        interaction{a_interaction}, spacing{a_spacing},
+        blocks{detail::concurrency(a_threads)} {
+    assert(mobility > 0. && gradient > 0. && interaction > 0.5);
+
+    std::size_t n = 1;
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      stride[a] = n;
+      n *= extent[a];
+    }
+    for (auto* s : {&now, &next}) {
+      s->id.assign(n * capacity, none);
+      s->eta.assign(n * capacity, 0.);
+      s->count.assign(n, 0);
+    }
+  }
+
+  // --------------------------------
+
+public:
+  /** \brief Single-Grain State eta = 1 at every Site from a Grain Map */
+  void assign(std::span<grain_type const> a_grain) {
+    assert(a_grain.size() == size());
+    for (std::size_t i = 0; i < size(); ++i) {
+      now.id[i * capacity]  = a_grain[i];
+      now.eta[i * capacity] = 1.;
+      now.count[i]          = 1;
+    }
+  }
+
+  void step(double dt) {
+    detail::parallel_blocks(
+        size(), blocks, [&](std::size_t, std::size_t begin, std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i)
+            update(i, dt);
+        });
+    std::swap(now, next);
+    clock += dt;
+  }
+
+  void step(std::size_t count, double dt) {
+    for (std::size_t s = 0; s < count; ++s)
+      step(dt);
+  }
+
+  /** \brief Order Parameters below the Threshold are Dropped */
+  void prune(double a_threshold) {
+    assert(a_threshold >= 0.);
+    threshold = a_threshold;
+  }
+
+  // --------------------------------
+
+public:
+  /** \brief Order Parameter of Grain g at Site i (0 if Inactive) */
+  [[nodiscard]] double value(std::size_t i, grain_type g) const {
+    return now.lookup(i, g);
+  }
+
+  /** \brief Number of Active Grains at Site i */
+  [[nodiscard]] std::size_t active(std::size_t i) const {
+    return now.count[i];
+  }
+
+  /** \brief Grain with the Largest Order Parameter at Site i */
+  [[nodiscard]] grain_type grain(std::size_t i) const {
+    grain_type g = none;
+    double     e = -std::numeric_limits<double>::infinity();
+    for (std::size_t k = 0; k < now.count[i]; ++k)
+      if (now.eta[i * capacity + k] > e) {
+        e = now.eta[i * capacity + k];
+        g = now.id[i * capacity + k];
+      }
+    return g;
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return now.count.size(); }
+  [[nodiscard]] index_type const& shape() const { return extent; }
+  [[nodiscard]] double time() const { return clock; }
+
+  [[nodiscard]] std::size_t index(index_type const& x) const {
+    std::size_t i = 0;
+    for (std::size_t a = 0; a < DimensionN; ++a)
+      i += x[a] * stride[a];
+    return i;
+  }
+
+  [[nodiscard]] index_type coordinates(std::size_t i) const {
+    index_type x;
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      x[a] = i % extent[a];
+      i /= extent[a];
+    }
+    return x;
+  }
+
+  // --------------------------------
+
+private:
+  /** \brief Fixed-Capacity Active Sets of every Site */
+  struct storage {
+    std::vector<grain_type>   id;
+    std::vector<double>       eta;
+    std::vector<std::uint8_t> count;
+
+    double lookup(std::size_t i, grain_type g) const {
+      for (std::size_t k = 0; k < count[i]; ++k)
+        if (id[i * capacity + k] == g)
+          return eta[i * capacity + k];
+      return 0.;
+    }
+  };
+
+  void update(std::size_t i, double dt) {
+    constexpr std::size_t candidates = (neighbours + 1) * capacity;
+
+    index_type const                  x = coordinates(i);
+    std::array<std::size_t, neighbours> nb;
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      std::size_t const s = stride[a];
+      nb[2 * a]     = i - x[a] * s + (x[a] == 0 ? extent[a] - 1 : x[a] - 1) * s;
+      nb[2 * a + 1] = i - x[a] * s + (x[a] + 1 == extent[a] ? 0 : x[a] + 1) * s;
+    }
+
+    // grains active at the site or a neighbour
+    std::array<grain_type, candidates> grain;
+    std::size_t                        distinct = 0;
+    auto const gather = [&](std::size_t j) {
+      for (std::size_t k = 0; k < now.count[j]; ++k) {
+        grain_type const g = now.id[j * capacity + k];
+        if (std::find(grain.begin(), grain.begin() + distinct, g) ==
+            grain.begin() + distinct)
+          grain[distinct++] = g;
+      }
+    };
+    gather(i);
+    for (std::size_t const j : nb)
+      gather(j);
+
+    double squares = 0.;
+    for (std::size_t k = 0; k < now.count[i]; ++k)
+      squares += now.eta[i * capacity + k] * now.eta[i * capacity + k];
+
+    double const h2 = spacing * spacing;
+
+    std::array<std::pair<double, grain_type>, candidates> kept;
+    std::size_t                                          keep = 0;
+    for (std::size_t c = 0; c < distinct; ++c) {
+      double const e = now.lookup(i, grain[c]);
+      double       lap = -double(neighbours) * e;
+      for (std::size_t const j : nb)
+        lap += now.lookup(j, grain[c]);
+      lap /= h2;
+
+      double const df =
+          -e + e * e * e + 2. * interaction * e * (squares - e * e);
+      double const updated = e - dt * mobility * (df - gradient * lap);
+      if (updated > threshold)
+        kept[keep++] = {updated, grain[c]};
+    }
+
+    // the largest capacity values survive
+    if (keep > capacity) {
+      std::partial_sort(kept.begin(), kept.begin() + capacity,
+                        kept.begin() + keep, std::greater<>{});
+      keep = capacity;
+    }
+    for (std::size_t k = 0; k < keep; ++k) {
+      next.eta[i * capacity + k] = kept[k].first;
+      next.id[i * capacity + k]  = kept[k].second;
+    }
+    next.count[i] = std::uint8_t(keep);
+  }
+
+  // --------------------------------
+
+private:
+  index_type  extent;
+  index_type  stride{};
+  double      mobility;
+  double      gradient;
+  double      interaction;
+  double      spacing;
+  double      threshold = 1e-3;
+  double      clock     = 0.;
+  std::size_t blocks;
+  storage     now, next;
+};
+
+// ================================
+
+/**
+ * \brief Right-Hand Side f(t, y, dydt) or Jacobian f(t, y, J) of y' = f(t, y)
+ * \note  J is row-major n x n, J[i n + j] = df_i / dy_j
+ */
+
+template <class FunctionF>
+concept ode_function =
+    std::invocable<FunctionF&, double, std::span<double const>,
+                   std::span<double>>;
+
+/** \brief Counters of an Adaptive Integration */
+struct integration_report {
+  std::size_t accepted    = 0;
+  std::size_t rejected    = 0;
+  std::size_t evaluations = 0;
+  bool        success     = false;
+};
+
+namespace detail {
+
+/** \brief RMS of e_i / (atol + rtol max(|y_i|, |z_i|)) */
+inline double error_norm(std::span<double const> e, std::span<double const> y,
+                         std::span<double const> z, double rtol, double atol) {
+  double s = 0.;
+  for (std::size_t i = 0; i < e.size(); ++i) {
+    double const w =
+        e[i] / (atol + rtol * std::max(std::abs(y[i]), std::abs(z[i])));
+    s += w * w;
+  }
+  return e.empty() ? 0. : std::sqrt(s / double(e.size()));
+}
+
+/** \brief Step Size Factor for an Error Estimate of Order (1 / exponent) */
+inline double step_factor(double error, double exponent) {
+  if (error == 0.)
+    return 5.;
+  return std::clamp(0.9 * std::pow(error, -exponent), 0.2, 5.);
+}
+
+/**
+ * \brief First Step 0.01 |y| / |f| in the Weighted Norm (Hairer et al.)
+ */
+
+inline double initial_step(std::span<double const> y,
+                           std::span<double const> f, double rtol,
+                           double atol, double span) {
+  double const d0 = error_norm(y, y, y, rtol, atol);
+  double const d1 = error_norm(f, y, y, rtol, atol);
+  double const h  = d0 < 1e-5 || d1 < 1e-5 ? 1e-6 : 0.01 * d0 / d1;
+  return std::min(h, span);
+}
+
+/** \brief In-Place LU with Partial Pivoting; false if Singular */
+inline bool lu_factor(std::span<double> a, std::span<std::size_t> pivot) {
+  std::size_t const n = pivot.size();
+  for (std::size_t k = 0; k < n; ++k) {
+    std::size_t p = k;
+    for (std::size_t i = k + 1; i < n; ++i)
+      if (std::abs(a[i * n + k]) > std::abs(a[p * n + k]))
+        p = i;
+    pivot[k] = p;
+    if (a[p * n + k] == 0.)
+      return false;
+    if (p != k)
+      std::swap_ranges(a.begin() + std::ptrdiff_t(k * n),
+                       a.begin() + std::ptrdiff_t(k * n + n),
+                       a.begin() + std::ptrdiff_t(p * n));
+    for (std::size_t i = k + 1; i < n; ++i) {
+      double const l = a[i * n + k] /= a[k * n + k];
+      for (std::size_t j = k + 1; j < n; ++j)
+        a[i * n + j] -= l * a[k * n + j];
+    }
+  }
+  return true;
+}
+
+inline void lu_solve(std::span<double const> a,
+                     std::span<std::size_t const> pivot, std::span<double> b) {
+  std::size_t const n = pivot.size();
+  for (std::size_t k = 0; k < n; ++k) {
+    std::swap(b[k], b[pivot[k]]);
+    for (std::size_t i = k + 1; i < n; ++i)
+      b[i] -= a[i * n + k] * b[k];
+  }
+  for (std::size_t k = n; k-- > 0;) {
+    for (std::size_t j = k + 1; j < n; ++j)
+      b[k] -= a[k * n + j] * b[j];
+    b[k] /= a[k * n + k];
+  }
+}
+
+} // namespace detail
+
+// ================================
+
+/**
+ * \class dormand_prince
+ * \brief Explicit Runge-Kutta 5(4) with Embedded Error Estimate
+ * \note  Seven stages, the last evaluated at the new solution and reused
+ *        as the first of the next step (FSAL): six evaluations per step
+ * \note  All stage storage is sized at construction; step and integrate
+ *        allocate nothing. The state is any contiguous span of doubles
+ */
+
+class dormand_prince {
+
+public:
+
+  // CONSTRUCTORS
+
+  explicit dormand_prince(std::size_t a_size, double a_relative = 1e-6,
+                          double a_absolute = 1e-9)
+      : n{a_size}, rtol{a_relative}, atol{a_absolute}, k(7 * a_size),
+        z(a_size), e(a_size) {
+    assert(rtol > 0. && atol > 0.);
+  }
+
+  // --------------------------------
+
+public:
+  /**
+   * \brief Attempt a Step of h from (t, y)
+   * \note  On acceptance t and y advance; h becomes the proposed next step
+   *        either way. The first stage is reused from the previous accepted
+   *        step at the same t: call reset() after editing y by hand
+   */
+
+  template <ode_function RhsF>
+  bool step(RhsF&& rhs, double& t, std::span<double> y, double& h) {
+    assert(y.size() == n);
+    static constexpr double a[6][6] = {
+        {1. / 5.},
+        {3. / 40., 9. / 40.},
+        {44. / 45., -56. / 15., 32. / 9.},
+        {19372. / 6561., -25360. / 2187., 64448. / 6561., -212. / 729.},
+        {9017. / 3168., -355. / 33., 46732. / 5247., 49. / 176.,
+         -5103. / 18656.},
+        {35. / 384., 0., 500. / 1113., 125. / 192., -2187. / 6784.,
+         11. / 84.}};
+    static constexpr double c[6] = {1. / 5., 3. / 10., 4. / 5., 8. / 9., 1.,
+                                    1.};
+    static constexpr double b[7] = {71. / 57600.,     0.,         -71. / 16695.,
+                                    71. / 1920.,      -17253. / 339200.,
+                                    22. / 525.,       -1. / 40.};
+
+    if (!(first && t == last)) {
+      rhs(t, std::span<double const>(y), stage(0));
+      ++evaluations;
+      first = true;
+      last  = t;
+    }
+    for (std::size_t s = 1; s < 7; ++s) {
+      for (std::size_t i = 0; i < n; ++i) {
+        double sum = 0.;
+        for (std::size_t j = 0; j < s; ++j)
+          sum += a[s - 1][j] * k[j * n + i];
+        z[i] = y[i] + h * sum;
+      }
+      rhs(t + c[s - 1] * h, std::span<double const>(z), stage(s));
+      ++evaluations;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      double sum = 0.;
+      for (std::size_t j = 0; j < 7; ++j)
+        sum += b[j] * k[j * n + i];
+      e[i] = h * sum;
+    }
+
+    double const error = detail::error_norm(e, y, z, rtol, atol);
+    bool const   accept = error <= 1.;
+    if (accept) {
+      std::copy(z.begin(), z.end(), y.begin());
+      std::copy(k.begin() + std::ptrdiff_t(6 * n), k.end(), k.begin());
+      t += h;
+      last = t;
+    }
+    double const factor = detail::step_factor(error, 1. / 5.);
+    h *= accept ? factor : std::min(factor, 1.);
+    return accept;
+  }
+
+  /**
+   * \brief Integrate y from t0 to t1 (t1 > t0)
+   * \param h first step; 0 chooses one from |y| and |f(t0, y)|
+   */
+
+  template <ode_function RhsF>
+  integration_report integrate(RhsF&& rhs, double t0, double t1,
+                               std::span<double> y, double h = 0.) {
+    assert(y.size() == n && t1 > t0);
+    reset();
+    evaluations = 0;
+    if (h <= 0.) {
+      rhs(t0, std::span<double const>(y), stage(0));
+      ++evaluations;
+      first = true;
+      last  = t0;
+      h     = detail::initial_step(y, stage(0), rtol, atol, t1 - t0);
+    }
+
+    integration_report report;
+    for (double t = t0; t < t1;) {
+      double const remaining = t1 - t;
+      double       trial     = std::min(h, remaining);
+      if (trial <= 16. * std::numeric_limits<double>::epsilon() *
+                       std::max(1., std::abs(t))) {
+        report.evaluations = evaluations;
+        return report;
+      }
+      bool const   clipped = trial < h;
+      double const taken   = trial; // step rescales trial to its proposal
+      bool const   ok      = step(rhs, t, y, trial);
+      ok ? ++report.accepted : ++report.rejected;
+      if (ok && taken >= remaining)
+        t = t1; // land exactly on t1
+      h = clipped && ok ? std::max(h, trial) : trial;
+    }
+    proposal           = h;
+    report.evaluations = evaluations;
+    report.success     = true;
+    return report;
+  }
+
+  /** \brief Forget the Cached First Stage */
+  void reset() { first = false; }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return n; }
+  /** \brief Step Size Proposed at the End of the Last integrate */
+  [[nodiscard]] double step_size() const { return proposal; }
+
+  // --------------------------------
+
+private:
+  std::span<double> stage(std::size_t s) { return {k.data() + s * n, n}; }
+
+  // --------------------------------
+
+private:
+  std::size_t         n;
+  double              rtol;
+  double              atol;
+  std::vector<double> k;
+  std::vector<double> z;
+  std::vector<double> e;
+  bool                first       = false;
+  double              last        = 0.;
+  double              proposal    = 0.;
+  std::size_t         evaluations = 0;
+};
+
+// ================================
+
+/**
+ * \class rosenbrock
+ * \brief Linearly Implicit Rosenbrock 2(3) Integrator for Stiff Systems
+ * \note  The L-stable scheme of MATLAB's ode23s (Shampine and Reichelt,
+ *        1997): one LU of W = I - h d J and three solves per step, no
+ *        Newton iteration. Step sizes follow accuracy, not the fastest
+ *        relaxation rate of the system
+ * \note  J comes from a user callable or from forward differences (n extra
+ *        evaluations); df/dt always from one forward difference. J is
+ *        reused across rejected attempts at the same point
+ * \note  Dense n x n storage sized at construction, no allocation per step:
+ *        meant for the tens to hundreds of coupled rate equations of
+ *        defect-density models, not for spatially resolved fields
+ */
+
+class rosenbrock {
+
+public:
+
+  // CONSTRUCTORS
+
+  explicit rosenbrock(std::size_t a_size, double a_relative = 1e-6,
+                      double a_absolute = 1e-9)
+      : n{a_size}, rtol{a_relative}, atol{a_absolute}, jacobian(n * n),
+        w(n * n), pivot(n), f0(n), f1(n), f2(n), k1(n), k2(n), k3(n), z(n),
+        dfdt(n) {
+    assert(rtol > 0. && atol > 0.);
+  }
+
+  // --------------------------------
+
+public:
+  /** \brief Attempt a Step with an Analytical Jacobian (see dormand_prince) */
+  template <ode_function RhsF, ode_function JacobianF>
+  bool step(RhsF&& rhs, JacobianF&& jac, double& t, std::span<double> y,
+            double& h) {
+    assert(y.size() == n);
+    constexpr double d   = 1. / (2. + std::numbers::sqrt2);
+    constexpr double e32 = 6. + std::numbers::sqrt2;
+
+    if (!(first && t == last)) {
+      rhs(t, std::span<double const>(y), std::span<double>(f0));
+      ++evaluations;
+      first   = true;
+      last    = t;
+      current = false;
+    }
+    if (!current) {
+      jac(t, std::span<double const>(y), std::span<double>(jacobian));
+      double const dt = std::sqrt(std::numeric_limits<double>::epsilon()) *
+                        std::max(1., std::abs(t));
+      rhs(t + dt, std::span<double const>(y), std::span<double>(f1));
+      ++evaluations;
+      for (std::size_t i = 0; i < n; ++i)
+        dfdt[i] = (f1[i] - f0[i]) / dt;
+      current = true;
+    }
+
+    for (std::size_t i = 0; i < n * n; ++i)
+      w[i] = -h * d * jacobian[i];
+    for (std::size_t i = 0; i < n; ++i)
+      w[i * n + i] += 1.;
+    if (!detail::lu_factor(w, pivot)) {
+      h *= 0.5;
+      return false;
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+      k1[i] = f0[i] + h * d * dfdt[i];
+    detail::lu_solve(w, pivot, k1);
+
+    for (std::size_t i = 0; i < n; ++i)
+      z[i] = y[i] + 0.5 * h * k1[i];
+    rhs(t + 0.5 * h, std::span<double const>(z), std::span<double>(f1));
+    for (std::size_t i = 0; i < n; ++i)
+      k2[i] = f1[i] - k1[i];
+    detail::lu_solve(w, pivot, k2);
+    for (std::size_t i = 0; i < n; ++i) {
+      k2[i] += k1[i];
+      z[i] = y[i] + h * k2[i];
+    }
+
+    rhs(t + h, std::span<double const>(z), std::span<double>(f2));
+    evaluations += 2;
+    for (std::size_t i = 0; i < n; ++i)
+      k3[i] = f2[i] - e32 * (k2[i] - f1[i]) - 2. * (k1[i] - f0[i]) +
+              h * d * dfdt[i];
+    detail::lu_solve(w, pivot, k3);
+
+    // error estimate h / 6 (k1 - 2 k2 + k3), kept in k3
+    for (std::size_t i = 0; i < n; ++i)
+      k3[i] = h / 6. * (k1[i] - 2. * k2[i] + k3[i]);
+
+    double const error  = detail::error_norm(k3, y, z, rtol, atol);
+    bool const   accept = error <= 1.;
+    if (accept) {
+      std::copy(z.begin(), z.end(), y.begin());
+      std::swap(f0, f2);
+      t += h;
+      last    = t;
+      current = false;
+    }
+    double const factor = detail::step_factor(error, 1. / 3.);
+    h *= accept ? factor : std::min(factor, 1.);
+    return accept;
+  }
+
+  /** \brief Attempt a Step with a Forward-Difference Jacobian */
+  template <ode_function RhsF>
+  bool step(RhsF&& rhs, double& t, std::span<double> y, double& h) {
+    return step(rhs, difference(rhs), t, y, h);
+  }
+
+  template <ode_function RhsF, ode_function JacobianF>
+  integration_report integrate(RhsF&& rhs, JacobianF&& jac, double t0,
+                               double t1, std::span<double> y, double h = 0.) {
+    assert(y.size() == n && t1 > t0);
+    reset();
+    evaluations = 0;
+    if (h <= 0.) {
+      rhs(t0, std::span<double const>(y), std::span<double>(f0));
+      ++evaluations;
+      first = true;
+      last  = t0;
+      h     = detail::initial_step(y, f0, rtol, atol, t1 - t0);
+    }
+
+    integration_report report;
+    for (double t = t0; t < t1;) {
+      double const remaining = t1 - t;
+      double       trial     = std::min(h, remaining);
+      if (trial <= 16. * std::numeric_limits<double>::epsilon() *
+                       std::max(1., std::abs(t))) {
+        report.evaluations = evaluations;
+        return report;
+      }
+      bool const   clipped = trial < h;
+      double const taken   = trial; // step rescales trial to its proposal
+      bool const   ok      = step(rhs, jac, t, y, trial);
+      ok ? ++report.accepted : ++report.rejected;
+      if (ok && taken >= remaining)
+        t = t1;
+      h = clipped && ok ? std::max(h, trial) : trial;
+    }
+    proposal           = h;
+    report.evaluations = evaluations;
+    report.success     = true;
+    return report;
+  }
+
+  template <ode_function RhsF>
+  integration_report integrate(RhsF&& rhs, double t0, double t1,
+                               std::span<double> y, double h = 0.) {
+    return integrate(rhs, difference(rhs), t0, t1, y, h);
+  }
+
+  void reset() {
+    first   = false;
+    current = false;
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] std::size_t size() const { return n; }
+  [[nodiscard]] double step_size() const { return proposal; }
+
+  // --------------------------------
+
+private:
+  /**
+   * \brief Forward-Difference Jacobian about f0 = f(t, y), Column by Column
+   *        through the Stage Buffer z
+   */
+
+  template <class RhsF>
+  auto difference(RhsF& rhs) {
+    return [this, &rhs](double t, std::span<double const> y,
+                        std::span<double> J) {
+      double const root = std::sqrt(std::numeric_limits<double>::epsilon());
+      std::copy(y.begin(), y.end(), z.begin());
+      for (std::size_t j = 0; j < n; ++j) {
+        double const dy = root * std::max(std::abs(y[j]), atol / rtol);
+        z[j]            = y[j] + dy;
+        rhs(t, std::span<double const>(z), std::span<double>(k1));
+        z[j] = y[j];
+        for (std::size_t i = 0; i < n; ++i)
+          J[i * n + j] = (k1[i] - f0[i]) / dy;
+      }
+      evaluations += n;
+    };
+  }
+
+  // --------------------------------
+
+private:
+  std::size_t              n;
+  double                   rtol;
+  double                   atol;
+  std::vector<double>      jacobian;
+  std::vector<double>      w;
+  std::vector<std::size_t> pivot;
+  std::vector<double>      f0, f1, f2, k1, k2, k3, z, dfdt;
+  bool                     first       = false;
+  bool                     current     = false;
+  double                   last        = 0.;
+  double                   proposal    = 0.;
+  std::size_t              evaluations = 0;
+};
+
+// ================================
+
+} // namespace xmicrostructure
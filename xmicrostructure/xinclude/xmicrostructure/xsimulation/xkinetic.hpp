@@ -0,0 +1,487 @@
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \class rate_tree
+ * \brief Rate Catalogue as an Implicit Binary Sum Tree
+ * \note  Leaves hold the event rates and every internal node the sum of its
+ *        children, so a rate update and an event selection both walk one
+ *        root-to-leaf path: O(log n). Parents are recomputed rather than
+ *        incremented, so the sums never drift
+ */
+
+class rate_tree {
+
+public:
+  explicit rate_tree(std::size_t a_events = 0) { resize(a_events); }
+
+  void resize(std::size_t a_events) {
+    events   = a_events;
+    capacity = std::bit_ceil(std::max<std::size_t>(a_events, 1));
+    node.assign(2 * capacity, 0.);
+  }
+
+  // --------------------------------
+
+public:
+  void set(std::size_t i, double r) {
+    assert(i < events && r >= 0.);
+    std::size_t k = capacity + i;
+    node[k]       = r;
+    for (k >>= 1; k > 0; k >>= 1)
+      node[k] = node[2 * k] + node[2 * k + 1];
+  }
+
+  /** \brief Event whose Cumulative Rate Interval Contains target */
+  [[nodiscard]] std::size_t select(double target) const {
+    std::size_t k = 1;
+    while (k < capacity) {
+      double const left = node[2 * k];
+      if (target < left || node[2 * k + 1] <= 0.) {
+        k = 2 * k;
+      } else {
+        target -= left;
+        k = 2 * k + 1;
+      }
+    }
+    return k - capacity;
+  }
+
+  [[nodiscard]] std::size_t select(randomiser& rng) const {
+    return select(rng.uniform() * total());
+  }
+
+  [[nodiscard]] double rate(std::size_t i) const { return node[capacity + i]; }
+  [[nodiscard]] double total() const { return node[1]; }
+  [[nodiscard]] std::size_t size() const { return events; }
+
+  // --------------------------------
+
+private:
+  std::size_t         events   = 0;
+  std::size_t         capacity = 1;
+  std::vector<double> node;
+};
+
+// ================================
+
+/**
+ * \class rate_groups
+ * \brief Composition-Rejection Rate Catalogue
+ * \note  Event i with rate r in [2^g, 2^(g+1)) belongs to group g. A group
+ *        is chosen from a rate_tree of group sums, then a member is drawn
+ *        uniformly and accepted with probability r / 2^(g+1) >= 1/2. Rates
+ *        spanning many decades cost O(log groups) per selection and O(1)
+ *        per update, independent of the number of events
+ * \note  Group sums are kept incrementally and recomputed from their
+ *        members after as many updates as the group holds (amortised O(1))
+ */
+
+class rate_groups {
+
+public:
+  static constexpr int lowest = std::numeric_limits<double>::min_exponent -
+                                std::numeric_limits<double>::digits - 1;
+  static constexpr int highest = std::numeric_limits<double>::max_exponent;
+
+  explicit rate_groups(std::size_t a_events = 0) { resize(a_events); }
+
+  void resize(std::size_t a_events) {
+    value.assign(a_events, 0.);
+    group.assign(a_events, none);
+    slot.assign(a_events, 0);
+    member.assign(highest - lowest + 1, {});
+    sum.assign(member.size(), 0.);
+    updates.assign(member.size(), 0);
+    tree.resize(member.size());
+  }
+
+  // --------------------------------
+
+public:
+  void set(std::size_t i, double r) {
+    assert(i < value.size() && r >= 0.);
+
+    std::size_t const to =
+        r > 0. ? std::size_t(std::ilogb(r) - lowest) : none;
+    if (to == group[i]) {
+      double const old = value[i];
+      value[i]         = r;
+      if (to != none)
+        adjust(to, r - old);
+      return;
+    }
+
+    if (group[i] != none) {
+      std::size_t const g    = group[i];
+      auto&             list = member[g];
+      list[slot[i]]          = list.back();
+      slot[list.back()]      = slot[i];
+      list.pop_back();
+      adjust(g, -value[i]);
+    }
+
+    value[i] = r;
+    group[i] = to;
+    if (to != none) {
+      slot[i] = member[to].size();
+      member[to].push_back(i);
+      adjust(to, r);
+    }
+  }
+
+  [[nodiscard]] std::size_t select(randomiser& rng) const {
+    std::size_t const g     = tree.select(rng);
+    auto const&       list  = member[g];
+    double const      bound = std::ldexp(1., int(g) + lowest + 1);
+    for (;;) {
+      std::size_t const j = list[std::min(
+          list.size() - 1, std::size_t(rng.uniform() * double(list.size())))];
+      if (rng.uniform() * bound < value[j])
+        return j;
+    }
+  }
+
+  [[nodiscard]] double rate(std::size_t i) const { return value[i]; }
+  [[nodiscard]] double total() const { return tree.total(); }
+  [[nodiscard]] std::size_t size() const { return value.size(); }
+
+  // --------------------------------
+
+private:
+  void adjust(std::size_t g, double delta) {
+    if (member[g].empty()) {
+      sum[g]     = 0.;
+      updates[g] = 0;
+    } else if (++updates[g] > member[g].size()) {
+      sum[g] = 0.;
+      for (std::size_t const j : member[g])
+        sum[g] += value[j];
+      updates[g] = 0;
+    } else {
+      sum[g] += delta;
+    }
+    tree.set(g, std::max(sum[g], 0.));
+  }
+
+  static constexpr std::size_t none = ~std::size_t{0};
+
+  std::vector<double>                   value;
+  std::vector<std::size_t>              group;
+  std::vector<std::size_t>              slot;
+  std::vector<std::vector<std::size_t>> member;
+  std::vector<double>                   sum;
+  std::vector<std::size_t>              updates;
+  rate_tree                             tree;
+};
+
+// ================================
+
+/**
+ * \class kinetic
+ * \brief Rejection-Free (BKL / n-fold way) Kinetic Monte Carlo
+ * \note  Each step draws an event with probability rate / total from the
+ *        catalogue and advances time by an exponential waiting time; the
+ *        caller executes the event and updates only the rates it changes
+ */
+
+template <class CatalogueT = rate_tree>
+class kinetic {
+
+public:
+  explicit kinetic(std::size_t a_events, std::uint64_t a_seed = 0)
+      : catalogue(a_events), rng(a_seed) {}
+
+  // --------------------------------
+
+public:
+  void set(std::size_t i, double r) { catalogue.set(i, r); }
+
+  /**
+   * \brief Select the Next Event and Advance the Clock
+   * \return the event index, or size() when every rate is zero
+   */
+
+  std::size_t step() {
+    double const total = catalogue.total();
+    if (!(total > 0.))
+      return catalogue.size();
+
+    std::size_t const e = catalogue.select(rng);
+    clock -= std::log1p(-rng.uniform()) / total;
+    ++count;
+    return e;
+  }
+
+  /**
+   * \brief Perform up to n Events, Calling execute(event) after each
+   * \return the number of events performed
+   */
+
+  template <std::invocable<std::size_t> ExecuteF>
+  std::size_t run(std::size_t n, ExecuteF&& execute) {
+    for (std::size_t s = 0; s < n; ++s) {
+      std::size_t const e = step();
+      if (e == catalogue.size())
+        return s;
+      execute(e);
+    }
+    return n;
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] CatalogueT& rates() { return catalogue; }
+  [[nodiscard]] CatalogueT const& rates() const { return catalogue; }
+  [[nodiscard]] double time() const { return clock; }
+  [[nodiscard]] std::size_t steps() const { return count; }
+  [[nodiscard]] std::size_t size() const { return catalogue.size(); }
+
+  // --------------------------------
+
+private:
+  CatalogueT  catalogue;
+  randomiser  rng;
+  double      clock = 0.;
+  std::size_t count = 0;
+};
+
+// ================================
+
+/**
+ * \class sublattice_kinetic
+ * \brief Synchronous Sublattice Parallel Kinetic Monte Carlo on a Lattice
+ * \note  The periodic lattice is cut into one slab per thread along the
+ *        last axis and every slab into two sectors. In each time window all
+ *        threads run rejection-free KMC concurrently inside their sector of
+ *        the same index; active sectors are a whole sector apart, so they
+ *        never touch the same sites. The window's overshooting event is
+ *        discarded (exact by memorylessness), and time advances by one
+ *        window once every sector has been processed
+ * \note  Boundary reconciliation: every sector keeps its own rate catalogue
+ *        across windows. When it becomes active it re-reads only the rows
+ *        within range of its two boundaries, the only rates its neighbours
+ *        can have changed, so a window costs O(events fired + boundary),
+ *        not O(sector). The first window, and the first after refresh(),
+ *        reads every rate
+ * \note  The slab workers are started once and reused for every window
+ * \note  Contract on range: execute(i, e, rng) writes, and rate(j, e)
+ *        reads, only sites within range of i and j respectively, and an
+ *        event at i changes only rates of sites within range of i. Sectors
+ *        must be at least 2 * range thick
+ */
+
+template <std::size_t DimensionN>
+  requires(DimensionN == 2 || DimensionN == 3)
+class sublattice_kinetic {
+
+public:
+  using index_type = std::array<std::size_t, DimensionN>;
+
+  static constexpr std::size_t sectors = 2;
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  sublattice_kinetic(index_type a_extent, std::size_t a_events,
+                     std::size_t a_range, double a_window,
+                     std::uint64_t a_seed = 0, std::size_t a_threads = 0)
+      : extent{a_extent}, events{a_events}, range{a_range},
+        window{a_window} {
+    assert(events > 0 && window > 0.);
+
+    plane = 1;
+    for (std::size_t a = 0; a + 1 < DimensionN; ++a)
+      plane *= extent[a];
+    std::size_t const rows = extent[DimensionN - 1];
+
+    std::size_t const thick = std::max<std::size_t>(2 * range, 1);
+    std::size_t const slabs = std::max<std::size_t>(
+        1, std::min(detail::concurrency(a_threads), rows / (sectors * thick)));
+    assert(rows >= sectors * thick);
+
+    for (std::size_t b = 0; b <= slabs; ++b)
+      boundary.push_back(b * rows / slabs);
+
+    for (std::size_t b = 0; b < slabs; ++b) {
+      stream.emplace_back(a_seed, b);
+      for (std::size_t s = 0; s < sectors; ++s) {
+        auto const [first, last] = sector(b, s);
+        catalogue.emplace_back((last - first) * plane * events);
+      }
+    }
+    stale.assign(catalogue.size(), 1);
+    workers = std::make_unique<detail::worker_pool>(slabs);
+  }
+
+  // --------------------------------
+
+public:
+  /**
+   * \brief Advance whole Windows until time() >= until
+   * \return the number of events performed
+   */
+
+  template <class RateF, class ExecuteF>
+  std::size_t advance(double until, RateF&& rate, ExecuteF&& execute) {
+    std::vector<std::size_t> performed(slabs());
+    while (clock < until) {
+      for (std::size_t s = 0; s < sectors; ++s)
+        workers->run([&](std::size_t b) {
+          performed[b] += run_sector(b, s, rate, execute);
+        });
+      clock += window;
+    }
+
+    std::size_t total = 0;
+    for (std::size_t const p : performed)
+      total += p;
+    count += total;
+    return total;
+  }
+
+  /**
+   * \brief Re-Read every Rate on the next Activation of each Sector
+   * \note  Needed after the lattice was changed outside advance()
+   */
+
+  void refresh() { stale.assign(stale.size(), 1); }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] double time() const { return clock; }
+  [[nodiscard]] std::size_t steps() const { return count; }
+  [[nodiscard]] std::size_t slabs() const { return boundary.size() - 1; }
+  [[nodiscard]] std::size_t size() const {
+    return plane * extent[DimensionN - 1];
+  }
+
+  [[nodiscard]] std::size_t index(index_type const& x) const {
+    std::size_t i = 0;
+    for (std::size_t a = DimensionN; a-- > 0;)
+      i = i * extent[a] + x[a];
+    return i;
+  }
+
+  [[nodiscard]] index_type coordinates(std::size_t i) const {
+    index_type x;
+    for (std::size_t a = 0; a < DimensionN; ++a) {
+      x[a] = i % extent[a];
+      i /= extent[a];
+    }
+    return x;
+  }
+
+  // --------------------------------
+
+private:
+  template <class RateF, class ExecuteF>
+  std::size_t run_sector(std::size_t b, std::size_t s, RateF& rate,
+                         ExecuteF& execute) {
+    auto const [first, last] = sector(b, s);
+
+    rate_tree&  tree = catalogue[b * sectors + s];
+    randomiser& rng  = stream[b];
+
+    auto const reread = [&](std::size_t from, std::size_t to) {
+      for (std::size_t l = (from - first) * plane; l < (to - first) * plane;
+           ++l)
+        for (std::size_t e = 0; e < events; ++e)
+          tree.set(l * events + e, rate(first * plane + l, e));
+    };
+
+    // reconcile: neighbours only change rates within range of the boundary
+    if (stale[b * sectors + s]) {
+      reread(first, last);
+      stale[b * sectors + s] = 0;
+    } else {
+      std::size_t const low  = std::min(first + range, last);
+      std::size_t const high = std::max(low, last - std::min(range, last));
+      reread(first, low);
+      reread(high, last);
+    }
+
+    std::size_t performed = 0;
+    for (double t = 0.;;) {
+      double const total = tree.total();
+      if (!(total > 0.))
+        break;
+      t -= std::log1p(-rng.uniform()) / total;
+      if (t > window)
+        break;
+
+      std::size_t const k    = tree.select(rng);
+      std::size_t const site = first * plane + k / events;
+      execute(site, k % events, rng);
+      ++performed;
+
+      for_each_near(site, [&](std::size_t j) {
+        std::size_t const row = j / plane;
+        if (row < first || row >= last)
+          return;
+        std::size_t const l = j - first * plane;
+        for (std::size_t e = 0; e < events; ++e)
+          tree.set(l * events + e, rate(j, e));
+      });
+    }
+    return performed;
+  }
+
+  /** \brief Rows [first, last) of Sector s of Slab b */
+  [[nodiscard]] std::pair<std::size_t, std::size_t>
+  sector(std::size_t b, std::size_t s) const {
+    std::size_t const mid = (boundary[b] + boundary[b + 1]) / 2;
+    return s == 0 ? std::pair{boundary[b], mid}
+                  : std::pair{mid, boundary[b + 1]};
+  }
+
+  /** \brief Visit every Site within Chebyshev Distance range (Periodic) */
+  template <class FunctionF>
+  void for_each_near(std::size_t i, FunctionF&& f) const {
+    index_type const x = coordinates(i);
+    index_type       o{};
+    std::size_t const width = 2 * range + 1;
+
+    std::size_t combinations = 1;
+    for (std::size_t a = 0; a < DimensionN; ++a)
+      combinations *= std::min(width, extent[a]);
+
+    for (std::size_t k = 0; k < combinations; ++k) {
+      std::size_t r = k;
+      for (std::size_t a = 0; a < DimensionN; ++a) {
+        std::size_t const w = std::min(width, extent[a]);
+        std::size_t const d = r % w;
+        r /= w;
+        // offsets -range..range, or every coordinate on a narrow axis
+        o[a] = w < width ? d : (x[a] + extent[a] - range + d) % extent[a];
+      }
+      f(index(o));
+    }
+  }
+
+  // --------------------------------
+
+private:
+  index_type                           extent;
+  std::size_t                          events;
+  std::size_t                          range;
+  double                               window;
+  std::size_t                          plane = 1;
+  double                               clock = 0.;
+  std::size_t                          count = 0;
+  std::vector<std::size_t>             boundary;
+  std::vector<rate_tree>               catalogue; // one per slab and sector
+  std::vector<std::uint8_t>            stale;     // written by slab threads
+  std::vector<randomiser>              stream;
+  std::unique_ptr<detail::worker_pool> workers;
+};
+
+// ================================
+
+} // namespace xmicrostructure
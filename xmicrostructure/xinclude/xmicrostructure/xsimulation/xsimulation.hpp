@@ -1 +1,4 @@
-#pragma once
\ No newline at end of file
+#pragma once
+
+#include "xevolution.hpp"
+#include "xkinetic.hpp"
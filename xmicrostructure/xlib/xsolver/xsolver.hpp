@@ -1 +1,371 @@
-#pragma once
\ No newline at end of file
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \brief FFT-Based Full-Field Elasticity on Periodic Voxel Grids
+ * \note  Lippmann-Schwinger formulation with an isotropic reference medium
+ *        C0 = c0 I (Mandel form, lambda0 = 0, 2 mu0 = c0); its Green
+ *        operator is G / c0, G the orthogonal projection onto compatible
+ *        zero-mean strains:
+ *        G(t)_kh = (xi_h (t xi)_k + xi_k (t xi)_h) / |xi|^2
+ *                  - xi_k xi_h (xi . t . xi) / |xi|^4
+ * \note  basic: Moulinec-Suquet fixed point e <- e - G(C : e) / c0 with
+ *        c0 = (c_min + c_max) / 2 of the grain stiffness spectra
+ *        conjugate_gradient: CG on G(C : e~) = -G(C : E) over compatible
+ *        fluctuations e~ (Zeman et al.), iterations ~ sqrt(contrast)
+ * \note  Both stop on the equilibrium residual |G(s)| / (sqrt(N) |<s>|)
+ */
+
+enum class elasticity_scheme { basic, conjugate_gradient };
+
+namespace detail {
+
+/**
+ * \brief Extreme Eigenvalues of a Symmetric m x m Matrix (Cyclic Jacobi)
+ */
+
+template <std::size_t M>
+inline std::pair<double, double> extreme_eigenvalues(std::array<double, M * M> a) {
+  for (std::size_t sweep = 0; sweep < 50; ++sweep) {
+    double off = 0., diagonal = 0.;
+    for (std::size_t p = 0; p < M; ++p) {
+      diagonal += a[p * M + p] * a[p * M + p];
+      for (std::size_t q = p + 1; q < M; ++q)
+        off += a[p * M + q] * a[p * M + q];
+    }
+    if (off <= 1e-30 * diagonal)
+      break;
+
+    for (std::size_t p = 0; p < M; ++p)
+      for (std::size_t q = p + 1; q < M; ++q) {
+        double const apq = a[p * M + q];
+        if (apq == 0.)
+          continue;
+        double const theta = (a[q * M + q] - a[p * M + p]) / (2. * apq);
+        double const t     = std::copysign(1., theta) /
+                         (std::abs(theta) + std::sqrt(theta * theta + 1.));
+        double const c = 1. / std::sqrt(t * t + 1.), s = t * c;
+        for (std::size_t k = 0; k < M; ++k) {
+          double const akp = a[k * M + p], akq = a[k * M + q];
+          a[k * M + p] = c * akp - s * akq;
+          a[k * M + q] = s * akp + c * akq;
+        }
+        for (std::size_t k = 0; k < M; ++k) {
+          double const apk = a[p * M + k], aqk = a[q * M + k];
+          a[p * M + k] = c * apk - s * aqk;
+          a[q * M + k] = s * apk + c * aqk;
+        }
+      }
+  }
+
+  double low = a[0], high = a[0];
+  for (std::size_t p = 1; p < M; ++p) {
+    low  = std::min(low, a[p * M + p]);
+    high = std::max(high, a[p * M + p]);
+  }
+  return {low, high};
+}
+
+} // namespace detail
+
+// ================================
+
+/**
+ * \class elasticity
+ * \brief Periodic Voxel Microstructure with one Stiffness per Grain
+ * \note  Strains and stresses are Mandel tensor_fields; in 2-D the
+ *        problem is plane strain
+ * \note  FourierT is pluggable as in phase_field; the default is the
+ *        solver library FFT when it is linked
+ */
+
+template <dimension D, class FourierT = fourier_t<dimension_t(D)>>
+class elasticity {
+
+public:
+  using grain_type   = std::uint32_t;
+  using complex_type = std::complex<double>;
+  using index_type   = std::array<std::size_t, dimension_t(D)>;
+  using tensor_type  = tensor<double, rank::tensor2, D, formation_mandel>;
+  using field_type   = tensor_field<double, rank::tensor2, D, formation_mandel>;
+
+  static constexpr std::size_t n     = dimension_t(D);
+  static constexpr std::size_t m     = symmetric_t(rank::tensor2, D);
+  static constexpr std::size_t packs = (m + 1) / 2;
+
+  /** \brief Iterations Spent, Final Residual and whether it met tolerance */
+  struct outcome {
+    std::size_t iterations = 0;
+    double      residual   = 0.;
+    bool        converged  = false;
+  };
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  template <class FormationPol>
+  elasticity(index_type a_extent, std::span<grain_type const> a_grain,
+             std::span<tensor<double, rank::tensor4, D, FormationPol> const>
+                 a_stiffness,
+             std::size_t a_threads = 0)
+      : extent{a_extent}, grain(a_grain.begin(), a_grain.end()),
+        blocks{detail::concurrency(a_threads)}, plan{a_extent, a_threads} {
+    std::size_t const np = plan.size();
+    assert(grain.size() == np && !a_stiffness.empty());
+
+    double low = std::numeric_limits<double>::infinity(), high = 0.;
+    for (auto const& c : a_stiffness) {
+      stiffness.push_back(detail::mandel_matrix(c));
+      auto const [l, h] = detail::extreme_eigenvalues<m>(stiffness.back());
+      assert(l > 0.);
+      low  = std::min(low, l);
+      high = std::max(high, h);
+    }
+    for (grain_type const g : grain)
+      assert(g < stiffness.size());
+    reference = 0.5 * (low + high);
+
+    spectrum.assign(packs, std::vector<complex_type>(np));
+    xi.resize(np);
+    mirror.resize(np);
+    for (std::size_t i = 0; i < np; ++i) {
+      std::size_t r = i, k = 0, s = 1;
+      for (std::size_t a = 0; a < n; ++a) {
+        std::size_t const x = r % extent[a];
+        r /= extent[a];
+        xi[i][a] = double(plan.frequency(a, x)) / double(extent[a]);
+        k += ((extent[a] - x) % extent[a]) * s;
+        s *= extent[a];
+      }
+      mirror[i] = k;
+    }
+
+    strain_field = field_type(np);
+    stress_field = field_type(np);
+  }
+
+  // --------------------------------
+
+public:
+  /**
+   * \brief Equilibrium under the Prescribed Mean Strain
+   * \param a_tolerance   on |G(s)| / (sqrt(N) |<s>|)
+   * \param a_iterations  upper bound on iterations
+   */
+
+  outcome solve(tensor_type const& a_macro,
+                elasticity_scheme  a_scheme     = elasticity_scheme::conjugate_gradient,
+                double             a_tolerance  = 1e-8,
+                std::size_t        a_iterations = 1000) {
+    strain_field.fill(a_macro);
+    return a_scheme == elasticity_scheme::basic
+               ? basic(a_tolerance, a_iterations)
+               : conjugate_gradient(a_macro, a_tolerance, a_iterations);
+  }
+
+  // --------------------------------
+
+public:
+  [[nodiscard]] field_type const& strain() const { return strain_field; }
+  [[nodiscard]] field_type const& stress() const { return stress_field; }
+  [[nodiscard]] auto mean_stress() const { return mean(stress_field); }
+  [[nodiscard]] std::size_t size() const { return plan.size(); }
+  [[nodiscard]] index_type const& shape() const { return extent; }
+
+  // --------------------------------
+
+private:
+  outcome basic(double tolerance, std::size_t iterations) {
+    field_type r(size());
+    outcome    o;
+    for (;; ++o.iterations) {
+      constitutive(strain_field, stress_field);
+      r = stress_field;
+      project(r);
+      o.residual = residual(r, stress_field);
+      if (o.residual <= tolerance || o.iterations == iterations)
+        break;
+      strain_field.axpy(-1. / reference, r);
+    }
+    o.converged = o.residual <= tolerance;
+    return o;
+  }
+
+  outcome conjugate_gradient(tensor_type const& macro, double tolerance,
+                             std::size_t iterations) {
+    field_type x(size()), r(size()), p(size()), q(size()), cp(size());
+
+    constitutive(strain_field, stress_field);
+    r = stress_field;
+    project(r);
+    r *= -1.;
+
+    outcome o;
+    o.residual = residual(r, stress_field);
+    double rr  = inner(r, r);
+    p          = r;
+    while (o.residual > tolerance && o.iterations < iterations) {
+      constitutive(p, q);
+      cp = q;
+      project(q);
+
+      double const alpha = rr / inner(p, q);
+      x.axpy(alpha, p);
+      r.axpy(-alpha, q);
+      stress_field.axpy(alpha, cp);
+      ++o.iterations;
+
+      double const next = inner(r, r);
+      o.residual        = residual(r, stress_field);
+      p *= next / rr;
+      p += r;
+      rr = next;
+    }
+
+    strain_field.fill(macro);
+    strain_field += x;
+    constitutive(strain_field, stress_field);
+    o.converged = o.residual <= tolerance;
+    return o;
+  }
+
+  /** \brief s = C_g : e, Pointwise */
+  void constitutive(field_type const& e, field_type& s) const {
+    std::size_t const le = e.leading(), ls = s.leading();
+    detail::parallel_blocks(
+        size(), blocks, [&](std::size_t, std::size_t begin, std::size_t end) {
+          double const* const x = e.data();
+          double* const       y = s.data();
+          for (std::size_t p = begin; p < end; ++p) {
+            auto const& k = stiffness[grain[p]];
+            for (std::size_t I = 0; I < m; ++I) {
+              double t = 0.;
+              for (std::size_t J = 0; J < m; ++J)
+                t += k[I * m + J] * x[J * le + p];
+              y[I * ls + p] = t;
+            }
+          }
+        });
+  }
+
+  /**
+   * \brief x <- G(x) in Place
+   * \note  Mandel components are paired into complex transforms; each
+   *        pair is untangled at (k, -k), where G is real and even
+   */
+
+  void project(field_type& a) {
+    std::size_t const np = size(), la = a.leading();
+    double* const     x  = a.data();
+
+    for (std::size_t k = 0; k < packs; ++k) {
+      auto& z = spectrum[k];
+      for (std::size_t p = 0; p < np; ++p)
+        z[p] = {x[2 * k * la + p], 2 * k + 1 < m ? x[(2 * k + 1) * la + p] : 0.};
+      plan.forward(z);
+    }
+
+    detail::parallel_blocks(
+        np, blocks, [&](std::size_t, std::size_t begin, std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i) {
+            std::size_t const j = mirror[i];
+            if (j < i)
+              continue;
+
+            std::array<complex_type, m> t;
+            for (std::size_t k = 0; k < packs; ++k) {
+              complex_type const zi = spectrum[k][i];
+              complex_type const zj = std::conj(spectrum[k][j]);
+              t[2 * k] = 0.5 * (zi + zj);
+              if (2 * k + 1 < m)
+                t[2 * k + 1] = complex_type{0., -0.5} * (zi - zj);
+            }
+
+            std::array<complex_type, m> e = gamma(xi[i], t);
+            for (std::size_t k = 0; k < packs; ++k) {
+              complex_type const y =
+                  e[2 * k] + (2 * k + 1 < m ? complex_type{0., 1.} * e[2 * k + 1]
+                                            : complex_type{});
+              spectrum[k][i] = y;
+              spectrum[k][j] =
+                  std::conj(e[2 * k]) +
+                  (2 * k + 1 < m ? complex_type{0., 1.} * std::conj(e[2 * k + 1])
+                                 : complex_type{});
+            }
+          }
+        });
+
+    for (std::size_t k = 0; k < packs; ++k) {
+      auto& z = spectrum[k];
+      plan.inverse(z);
+      for (std::size_t p = 0; p < np; ++p) {
+        x[2 * k * la + p] = z[p].real();
+        if (2 * k + 1 < m)
+          x[(2 * k + 1) * la + p] = z[p].imag();
+      }
+    }
+  }
+
+  /** \brief Compatibility Projection of one Mandel Spectrum (0 at xi = 0) */
+  static std::array<complex_type, m>
+  gamma(std::array<double, n> const& q, std::array<complex_type, m> const& t) {
+    std::array<complex_type, m> e{};
+    double                      q2 = 0.;
+    for (std::size_t a = 0; a < n; ++a)
+      q2 += q[a] * q[a];
+    if (q2 == 0.)
+      return e;
+
+    // full symmetric tensor, then t xi and xi . t . xi
+    std::array<complex_type, n * n> s;
+    for (std::size_t I = 0; I < m; ++I) {
+      auto const [i, j] = detail::voigt_pair(I, D);
+      complex_type const v =
+          t[I] / detail::shear_weight<formation_mandel, double>(I, D);
+      s[i * n + j] = s[j * n + i] = v;
+    }
+    std::array<complex_type, n> v{};
+    complex_type                w{};
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = 0; j < n; ++j)
+        v[i] += s[i * n + j] * q[j];
+      w += q[i] * v[i];
+    }
+
+    for (std::size_t I = 0; I < m; ++I) {
+      auto const [k, h] = detail::voigt_pair(I, D);
+      e[I] = detail::shear_weight<formation_mandel, double>(I, D) *
+             ((q[h] * v[k] + q[k] * v[h]) / q2 - q[k] * q[h] * w / (q2 * q2));
+    }
+    return e;
+  }
+
+  double residual(field_type const& r, field_type const& s) const {
+    auto const   average = mean(s);
+    double const scale   = std::sqrt(double(size()) * ddot(average, average));
+    return scale > 0. ? std::sqrt(inner(r, r)) / scale : std::sqrt(inner(r, r));
+  }
+
+  // --------------------------------
+
+private:
+  index_type                                    extent;
+  std::vector<grain_type>                       grain;
+  std::vector<std::array<double, m * m>>        stiffness;
+  double                                        reference = 1.;
+  std::size_t                                   blocks;
+  FourierT                                      plan;
+  std::vector<std::vector<complex_type>>        spectrum;
+  std::vector<std::array<double, n>>            xi;
+  std::vector<std::size_t>                      mirror;
+  field_type                                    strain_field;
+  field_type                                    stress_field;
+};
+
+// ================================
+
+} // namespace xmicrostructure
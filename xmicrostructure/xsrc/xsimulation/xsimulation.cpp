@@ -1 +1,3 @@
-#include "xsimulation/xsimulation.hpp"
\ No newline at end of file
+#include "xforward.hpp"
+
+#include "xsimulation/xsimulation.hpp"
@@ -17,6 +17,1006 @@ int xmicrostructure_test() {
 	std::cout << distortion << '\n';
   }
 
+  {
+    using strain = xmicrostructure::tensor<double, xmicrostructure::rank::tensor2,
+                                           xmicrostructure::dimension::three>;
+    using stiffness =
+        xmicrostructure::tensor<double, xmicrostructure::rank::tensor4,
+                                xmicrostructure::dimension::three>;
+
+    constexpr strain a{{1., 2., 3., 4., 5., 6., 7., 8., 9.}};
+    constexpr strain b{{9., 8., 7., 6., 5., 4., 3., 2., 1.}};
+
+    constexpr auto sum = a + b;
+    static_assert(sum[0] == 10. && sum[8] == 10.);
+    static_assert((sum - b)[4] == a[4]);
+    static_assert((2. * a / 2.)[7] == a[7]);
+
+    auto c = a;
+    c += b;
+    c -= a;
+    c *= 3.;
+    c /= 3.;
+    for (std::size_t i = 0; i < 9; ++i)
+      assert(c[i] == b[i]);
+
+    // A_ik B_kj and A_ij B_ij
+    constexpr auto ab = xmicrostructure::dot(a, b);
+    static_assert(ab[0] == 1. * 9. + 2. * 6. + 3. * 3.);
+    static_assert(ab[5] == 4. * 7. + 5. * 4. + 6. * 1.);
+    static_assert(xmicrostructure::ddot(a, b) == 165.);
+
+    // isotropic stiffness: C_ijkl = lambda d_ij d_kl + mu (d_ik d_jl + d_il d_jk)
+    constexpr double lambda = 2., mu = 3.;
+    stiffness         C;
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        for (std::size_t k = 0; k < 3; ++k)
+          for (std::size_t l = 0; l < 3; ++l)
+            C[((i * 3 + j) * 3 + k) * 3 + l] =
+                lambda * (i == j) * (k == l) +
+                mu * ((i == k) * (j == l) + (i == l) * (j == k));
+
+    strain const e{{1., 2., 0., 2., -1., 0., 0., 0., 4.}};
+    auto const   s = xmicrostructure::ddot(C, e);
+    for (std::size_t i = 0; i < 9; ++i)
+      assert(s[i] == lambda * 4. * (i % 4 == 0) + 2. * mu * e[i]);
+  }
+
+  // ================================
+  // Voigt and Mandel symmetric storage
+  {
+    using xmicrostructure::dimension;
+    using xmicrostructure::formation_across;
+    using xmicrostructure::formation_mandel;
+    using xmicrostructure::formation_voigt;
+    using xmicrostructure::rank;
+
+    static_assert(xmicrostructure::symmetric_t(rank::tensor2, dimension::three) == 6);
+    static_assert(xmicrostructure::symmetric_t(rank::tensor4, dimension::three) == 21);
+    static_assert(xmicrostructure::symmetric_t(rank::tensor4, dimension::two) == 6);
+    static_assert(sizeof(xmicrostructure::tensor<double, rank::tensor4, dimension::three, formation_voigt>) ==
+                  21 * sizeof(double));
+
+    constexpr double lambda = 2., mu = 3.;
+    xmicrostructure::tensor<double, rank::tensor4, dimension::three, formation_across> C;
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        for (std::size_t k = 0; k < 3; ++k)
+          for (std::size_t l = 0; l < 3; ++l)
+            C[((i * 3 + j) * 3 + k) * 3 + l] =
+                lambda * (i == j) * (k == l) +
+                mu * ((i == k) * (j == l) + (i == l) * (j == k)) +
+                (i + j + k + l) * 0.25; // keeps full symmetry, breaks isotropy
+
+    xmicrostructure::tensor<double, rank::tensor2, dimension::three, formation_across> const e{
+        {1., 2., -3., 2., -1., 0.5, -3., 0.5, 4.}};
+    auto const s = xmicrostructure::ddot(C, e);
+
+    auto const close = [](double x, double y) { return std::abs(x - y) < 1e-12; };
+
+    auto const sv = xmicrostructure::ddot(xmicrostructure::formation_cast<formation_voigt>(C),
+                                          xmicrostructure::formation_cast<formation_voigt>(e));
+    auto const sm = xmicrostructure::ddot(xmicrostructure::formation_cast<formation_mandel>(C),
+                                          xmicrostructure::formation_cast<formation_mandel>(e));
+    auto const sv_across = xmicrostructure::formation_cast<formation_across>(sv);
+    auto const sm_across = xmicrostructure::formation_cast<formation_across>(sm);
+    for (std::size_t i = 0; i < 9; ++i) {
+      assert(close(sv_across[i], s[i]));
+      assert(close(sm_across[i], s[i]));
+    }
+
+    // energy density e:C:e is policy independent
+    auto const ev = xmicrostructure::formation_cast<formation_voigt>(e);
+    auto const em = xmicrostructure::formation_cast<formation_mandel>(e);
+    assert(close(xmicrostructure::ddot(sv, ev), xmicrostructure::ddot(s, e)));
+    assert(close(xmicrostructure::ddot(sm, em), xmicrostructure::ddot(s, e)));
+
+    // round trips
+    auto const Cm = xmicrostructure::formation_cast<formation_mandel>(C);
+    auto const Cv = xmicrostructure::formation_cast<formation_voigt>(Cm);
+    auto const Ca = xmicrostructure::formation_cast<formation_across>(Cv);
+    for (std::size_t i = 0; i < 81; ++i)
+      assert(close(Ca[i], C[i]));
+
+    // 2-D ordering: 11, 22, 12
+    xmicrostructure::tensor<double, rank::tensor2, dimension::two, formation_across> const f{{1., 5., 5., 2.}};
+    auto const fm = xmicrostructure::formation_cast<formation_mandel>(f);
+    assert(fm[0] == 1. && fm[1] == 2. && close(fm[2], 5. * std::numbers::sqrt2));
+  }
+
+  // ================================
+  // tensor_field: component-major bulk operators
+  {
+    using xmicrostructure::dimension;
+    using xmicrostructure::formation_across;
+    using xmicrostructure::formation_mandel;
+    using xmicrostructure::rank;
+    using strain  = xmicrostructure::tensor<double, rank::tensor2, dimension::three>;
+    using field   = xmicrostructure::tensor_field<double, rank::tensor2, dimension::three>;
+    using stiffness = xmicrostructure::tensor<double, rank::tensor4, dimension::three>;
+
+    auto const close = [](double x, double y) { return std::abs(x - y) < 1e-12; };
+
+    constexpr std::size_t points = 37; // not a multiple of the padding lane
+    field e(points);
+    for (std::size_t p = 0; p < points; ++p) {
+      strain t;
+      for (std::size_t i = 0; i < 3; ++i)
+        for (std::size_t j = i; j < 3; ++j)
+          t[i * 3 + j] = t[j * 3 + i] = std::sin(double(p + 1) * double(i * 3 + j + 1));
+      e.set(p, t);
+    }
+    assert(e.component(4).size() == points && e.component(4)[5] == e.get(5)[4]);
+
+    constexpr double lambda = 2., mu = 3.;
+    stiffness C;
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        for (std::size_t k = 0; k < 3; ++k)
+          for (std::size_t l = 0; l < 3; ++l)
+            C[((i * 3 + j) * 3 + k) * 3 + l] =
+                lambda * (i == j) * (k == l) +
+                mu * ((i == k) * (j == l) + (i == l) * (j == k));
+
+    auto const s   = xmicrostructure::ddot(C, e);
+    auto const tr  = xmicrostructure::trace(e);
+    auto const dev = xmicrostructure::deviator(e);
+    auto       sum = e + s;
+    sum *= 2.;
+    sum.axpy(-2., s);
+    for (std::size_t p = 0; p < points; ++p) {
+      auto const ep = e.get(p);
+      auto const sp = xmicrostructure::ddot(C, ep);
+      auto const tp = ep[0] + ep[4] + ep[8];
+      assert(close(tr.get(p)[0], tp));
+      for (std::size_t i = 0; i < 9; ++i) {
+        assert(close(s.get(p)[i], sp[i]));
+        assert(close(dev.get(p)[i], ep[i] - (i % 4 == 0) * tp / 3.));
+        assert(close(sum.get(p)[i], 2. * ep[i]));
+      }
+    }
+
+    // Mandel fields contract with the packed stiffness
+    xmicrostructure::tensor_field<double, rank::tensor2, dimension::three, formation_mandel> em(points);
+    for (std::size_t p = 0; p < points; ++p)
+      em.set(p, xmicrostructure::formation_cast<formation_mandel>(e.get(p)));
+    auto const sm = xmicrostructure::ddot(xmicrostructure::formation_cast<formation_mandel>(C), em);
+    for (std::size_t p = 0; p < points; ++p) {
+      auto const sa = xmicrostructure::formation_cast<formation_across>(sm.get(p));
+      for (std::size_t i = 0; i < 9; ++i)
+        assert(close(sa[i], s.get(p)[i]));
+    }
+  }
+
+  // ================================
+  // batched closed-form eigen-decomposition
+  {
+    using xmicrostructure::dimension;
+    using xmicrostructure::formation_across;
+    using xmicrostructure::formation_mandel;
+    using xmicrostructure::rank;
+    using stress = xmicrostructure::tensor<double, rank::tensor2, dimension::three>;
+
+    auto const close = [](double x, double y) { return std::abs(x - y) < 1e-9 * (1. + std::abs(y)); };
+
+    // random symmetric tensors followed by (near-)repeated spectra R diag R^T
+    constexpr std::size_t points = 64;
+    xmicrostructure::tensor_field<double, rank::tensor2, dimension::three> a(points);
+    for (std::size_t p = 0; p < points; ++p) {
+      stress t;
+      if (p < 48) {
+        for (std::size_t i = 0; i < 3; ++i)
+          for (std::size_t j = i; j < 3; ++j)
+            t[i * 3 + j] = t[j * 3 + i] = std::sin(double(7 * p + 3 * i + j + 1));
+      } else {
+        double const d[3] = {1., 1. + (p % 4 == 0 ? 0. : 1e-10), p % 3 == 0 ? 1. : -2.};
+        double const c = std::cos(double(p)), s = std::sin(double(p));
+        double const R[9] = {c, -s, 0., s * c, c * c, -s, s * s, c * s, c};
+        for (std::size_t i = 0; i < 3; ++i)
+          for (std::size_t j = 0; j < 3; ++j)
+            for (std::size_t k = 0; k < 3; ++k)
+              t[i * 3 + j] += R[i * 3 + k] * d[k] * R[j * 3 + k];
+      }
+      a.set(p, t);
+    }
+
+    xmicrostructure::tensor_field<double, rank::vector, dimension::three> l;
+    xmicrostructure::tensor_field<double, rank::tensor2, dimension::three> v;
+    xmicrostructure::eigen(a, l, v);
+    auto const l_only = xmicrostructure::eigenvalues(a);
+    auto const vm     = xmicrostructure::von_mises(a);
+    auto const dev    = xmicrostructure::deviator(a);
+
+    for (std::size_t p = 0; p < points; ++p) {
+      auto const ap = a.get(p), vp = v.get(p);
+      auto const lp = l.get(p);
+      assert(lp[0] >= lp[1] && lp[1] >= lp[2]);
+      for (std::size_t k = 0; k < 3; ++k) {
+        assert(std::abs(l_only.get(p)[k] - lp[k]) < 1e-7); // acos near +-1 loses sqrt(eps)
+        for (std::size_t i = 0; i < 3; ++i) {
+          double av = 0.;
+          for (std::size_t j = 0; j < 3; ++j)
+            av += ap[i * 3 + j] * vp[j * 3 + k];
+          assert(std::abs(av - lp[k] * vp[i * 3 + k]) < 1e-8);
+        }
+        for (std::size_t m = 0; m < 3; ++m) {
+          double vv = 0.;
+          for (std::size_t i = 0; i < 3; ++i)
+            vv += vp[i * 3 + k] * vp[i * 3 + m];
+          assert(std::abs(vv - (k == m)) < 1e-8);
+        }
+      }
+      auto const sp = dev.get(p);
+      assert(close(vm.get(p)[0], std::sqrt(1.5 * xmicrostructure::ddot(sp, sp))));
+
+      // single-point and Mandel paths agree with the batch
+      xmicrostructure::tensor<double, rank::vector, dimension::three, formation_mandel> lm;
+      xmicrostructure::tensor<double, rank::tensor2, dimension::three, formation_across> vm_;
+      xmicrostructure::eigen(xmicrostructure::formation_cast<formation_mandel>(ap), lm, vm_);
+      for (std::size_t k = 0; k < 3; ++k)
+        assert(close(lm[k], lp[k]));
+    }
+
+    // a large hydrostatic part over a well-separated deviator stays closed form
+    {
+      double e[3], w[9];
+      assert(xmicrostructure::detail::eigen3(1e4 + .3, 1e4 - .1, 1e4 - .2, .05, -.02, .1, e, w));
+      double const m[9] = {1e4 + .3, .1, -.02, .1, 1e4 - .1, .05, -.02, .05, 1e4 - .2};
+      for (std::size_t k = 0; k < 3; ++k)
+        for (std::size_t i = 0; i < 3; ++i) {
+          double av = 0.;
+          for (std::size_t j = 0; j < 3; ++j)
+            av += m[i * 3 + j] * w[j * 3 + k];
+          assert(std::abs(av - e[k] * w[i * 3 + k]) < 1e-8 * 1e4);
+        }
+      // a repeated root still falls back
+      assert(!xmicrostructure::detail::eigen3(1e4 + 1., 1e4 + 1., 1e4 - 2., 0., 0., 0., e, w));
+    }
+
+    // 2-D: half-angle closed form
+    xmicrostructure::tensor_field<double, rank::tensor2, dimension::two> b(5);
+    for (std::size_t p = 0; p < 5; ++p)
+      b.set(p, xmicrostructure::tensor<double, rank::tensor2, dimension::two>{
+                   {double(p), 1. - double(p), 1. - double(p), -2.}});
+    xmicrostructure::tensor_field<double, rank::vector, dimension::two> l2;
+    xmicrostructure::tensor_field<double, rank::tensor2, dimension::two> v2;
+    xmicrostructure::eigen(b, l2, v2);
+    for (std::size_t p = 0; p < 5; ++p) {
+      auto const bp = b.get(p), vp = v2.get(p);
+      auto const lp = l2.get(p);
+      assert(lp[0] >= lp[1]);
+      for (std::size_t k = 0; k < 2; ++k)
+        for (std::size_t i = 0; i < 2; ++i)
+          assert(std::abs(bp[i * 2] * vp[k] + bp[i * 2 + 1] * vp[2 + k] - lp[k] * vp[i * 2 + k]) < 1e-12);
+    }
+  }
+
+  // ================================
+  // batched rank-4 rotation through Bond matrices
+  {
+    using xmicrostructure::dimension;
+    using xmicrostructure::formation_across;
+    using xmicrostructure::formation_mandel;
+    using xmicrostructure::formation_voigt;
+    using xmicrostructure::rank;
+    using rotation  = xmicrostructure::tensor<double, rank::tensor2, dimension::three>;
+    using stiffness = xmicrostructure::tensor<double, rank::tensor4, dimension::three>;
+
+    // cubic reference stiffness
+    constexpr double c11 = 168., c12 = 121., c44 = 75.;
+    stiffness C;
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j)
+        for (std::size_t k = 0; k < 3; ++k)
+          for (std::size_t l = 0; l < 3; ++l)
+            C[((i * 3 + j) * 3 + k) * 3 + l] =
+                c12 * (i == j) * (k == l) + c44 * ((i == k) * (j == l) + (i == l) * (j == k)) +
+                (c11 - c12 - 2. * c44) * (i == j && j == k && k == l);
+
+    constexpr std::size_t grains = 100; // spans two blocks
+    xmicrostructure::tensor_field<double, rank::tensor2, dimension::three> R(grains);
+    for (std::size_t g = 0; g < grains; ++g)
+      R.set(g, xmicrostructure::bunge(0.1 * double(g), 0.37 * double(g), 1. - 0.05 * double(g)));
+
+    auto const Cv = xmicrostructure::rotate<formation_voigt>(xmicrostructure::formation_cast<formation_voigt>(C), R);
+    auto const Cm = xmicrostructure::rotate<formation_mandel>(C, R);
+
+    for (std::size_t g = 0; g < grains; ++g) {
+      rotation const r = R.get(g);
+      stiffness      naive;
+      for (std::size_t i = 0; i < 81; ++i)
+        for (std::size_t j = 0; j < 81; ++j) {
+          std::size_t const a[4] = {i / 27, i / 9 % 3, i / 3 % 3, i % 3};
+          std::size_t const b[4] = {j / 27, j / 9 % 3, j / 3 % 3, j % 3};
+          naive[i] += r[a[0] * 3 + b[0]] * r[a[1] * 3 + b[1]] * r[a[2] * 3 + b[2]] * r[a[3] * 3 + b[3]] * C[j];
+        }
+
+      auto const single = xmicrostructure::rotate(C, r);
+      auto const fromv  = xmicrostructure::formation_cast<formation_across>(Cv.get(g));
+      auto const fromm  = xmicrostructure::formation_cast<formation_across>(Cm.get(g));
+      for (std::size_t i = 0; i < 81; ++i) {
+        assert(std::abs(single[i] - naive[i]) < 1e-10);
+        assert(std::abs(fromv[i] - naive[i]) < 1e-10);
+        assert(std::abs(fromm[i] - naive[i]) < 1e-10);
+      }
+    }
+
+    // rank-2 rotation and the 2-D Bond matrix
+    rotation const r = R.get(7);
+    rotation const e{{1., 2., 3., 2., 4., 5., 3., 5., 6.}};
+    auto const     er = xmicrostructure::rotate(e, r);
+    for (std::size_t i = 0; i < 3; ++i)
+      for (std::size_t j = 0; j < 3; ++j) {
+        double x = 0.;
+        for (std::size_t k = 0; k < 3; ++k)
+          for (std::size_t l = 0; l < 3; ++l)
+            x += r[i * 3 + k] * r[j * 3 + l] * e[k * 3 + l];
+        assert(std::abs(er[i * 3 + j] - x) < 1e-12);
+      }
+
+    xmicrostructure::tensor<double, rank::tensor4, dimension::two, formation_mandel> C2;
+    for (std::size_t i = 0; i < 6; ++i)
+      C2[i] = double(i + 1);
+    double const t = 0.3;
+    xmicrostructure::tensor<double, rank::tensor2, dimension::two> const r2{
+        {std::cos(t), -std::sin(t), std::sin(t), std::cos(t)}};
+    auto const C2r = xmicrostructure::rotate(xmicrostructure::rotate(C2, r2),
+                                             xmicrostructure::tensor<double, rank::tensor2, dimension::two>{
+                                                 {r2[0], r2[2], r2[1], r2[3]}});
+    for (std::size_t i = 0; i < 6; ++i)
+      assert(std::abs(C2r[i] - C2[i]) < 1e-12);
+  }
+
+  // ================================
+  // compile-time index contraction
+  {
+    using xmicrostructure::contract;
+    using xmicrostructure::dimension;
+    using xmicrostructure::rank;
+    using vector2 = xmicrostructure::tensor<double, rank::vector, dimension::two>;
+    using tensor2 = xmicrostructure::tensor<double, rank::tensor2, dimension::three>;
+    using tensor4 = xmicrostructure::tensor<double, rank::tensor4, dimension::three>;
+
+    constexpr tensor2 a{{1., 2., 3., 4., 5., 6., 7., 8., 9.}};
+    constexpr tensor2 b{{9., 8., 7., 6., 5., 4., 3., 2., 1.}};
+
+    // agrees with the hand-written kernels, also in constant evaluation
+    static_assert(contract<"ik,kj->ij">(a, b)[5] == xmicrostructure::dot(a, b)[5]);
+    static_assert(contract<"ij,ij->">(a, b) == xmicrostructure::ddot(a, b));
+    static_assert(contract<"ii->">(a) == 15.);
+    static_assert(contract<"ij->ji">(a)[1] == 4.);
+    static_assert(contract<"i,j->ij">(vector2{{1., 2.}}, vector2{{3., 4.}})[2] == 6.);
+
+    tensor4 C;
+    for (std::size_t i = 0; i < 81; ++i)
+      C[i] = std::cos(double(i));
+    auto const s = contract<"ijkl,kl->ij">(C, a);
+    auto const t = xmicrostructure::ddot(C, a);
+    for (std::size_t i = 0; i < 9; ++i)
+      assert(std::abs(s[i] - t[i]) < 1e-12);
+
+    // three operands: (A B A)_ij
+    auto const abc = contract<"ik,kl,lj->ij">(a, b, a);
+    auto const ref = xmicrostructure::dot(xmicrostructure::dot(a, b), a);
+    for (std::size_t i = 0; i < 9; ++i)
+      assert(abc[i] == ref[i]);
+
+    auto const cc = contract<"ijkl,klmn->ijmn">(C, C);
+    double     x  = 0.;
+    for (std::size_t k = 0; k < 9; ++k)
+      x += C[1 * 9 + k] * C[k * 9 + 7];
+    assert(std::abs(cc[1 * 9 + 7] - x) < 1e-12);
+
+    // float operands still sum every output entry in double
+    using tensorf = xmicrostructure::tensor<float, rank::tensor2, dimension::three>;
+    using vectorf = xmicrostructure::tensor<float, rank::vector, dimension::three>;
+    constexpr tensorf m{{1e8f, 1.f, -1e8f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f}};
+    static_assert(contract<"ij,j->i">(m, vectorf{{1.f, 1.f, 1.f}})[0] == 1.f);
+  }
+
+  // ================================
+  // mixed precision: float storage, double accumulation
+  {
+    using xmicrostructure::dimension;
+    using xmicrostructure::formation_mandel;
+    using xmicrostructure::rank;
+
+    static_assert(std::is_same_v<xmicrostructure::accumulate_t<float>, double>);
+    static_assert(std::is_same_v<xmicrostructure::accumulate_t<double>, double>);
+
+    using field_d = xmicrostructure::tensor_field<double, rank::tensor2, dimension::three, formation_mandel>;
+
+    constexpr std::size_t points = 1 << 20;
+    field_d               ed(points);
+    for (std::size_t p = 0; p < points; ++p) {
+      xmicrostructure::tensor<double, rank::tensor2, dimension::three, formation_mandel> t;
+      for (std::size_t c = 0; c < 6; ++c)
+        t[c] = 0.1 + 1e-3 * std::sin(double(p * 6 + c));
+      ed.set(p, t);
+    }
+
+    auto const ef = xmicrostructure::precision_cast<float>(ed);
+    static_assert(std::is_same_v<decltype(ef)::value_type, float>);
+    assert(sizeof(*ef.data()) * 2 == sizeof(*ed.data()));
+
+    // reductions over 10^6 float values keep double accuracy
+    auto const md = xmicrostructure::mean(ed);
+    auto const mf = xmicrostructure::mean(ef);
+    static_assert(std::is_same_v<decltype(mf)::value_type, double>);
+    for (std::size_t c = 0; c < 6; ++c) {
+      long double reference = 0.l;
+      for (std::size_t p = 0; p < points; ++p)
+        reference += ef.component(c)[p];
+      reference /= points;
+      assert(std::abs(mf[c] - double(reference)) < 1e-12);
+      assert(std::abs(mf[c] - md[c]) < 1e-8);
+    }
+    assert(std::abs(xmicrostructure::inner(ef, ef) - xmicrostructure::inner(ed, ed)) <
+           1e-7 * xmicrostructure::inner(ed, ed));
+
+    // contraction with a constant stiffness agrees to float rounding
+    xmicrostructure::tensor<double, rank::tensor4, dimension::three, formation_mandel> C;
+    for (std::size_t i = 0; i < 21; ++i)
+      C[i] = 100. + double(i);
+    auto const sd = xmicrostructure::ddot(C, ed);
+    auto const sf = xmicrostructure::ddot(xmicrostructure::precision_cast<float>(C), ef);
+    for (std::size_t p = 0; p < points; p += 4099)
+      for (std::size_t c = 0; c < 6; ++c)
+        assert(std::abs(sf.get(p)[c] - sd.get(p)[c]) < 1e-6 * std::abs(sd.get(p)[c]));
+  }
+
+  // ================================
+  // Potts grain growth with checkerboard colouring
+  {
+    // per-stream generators are reproducible and distinct
+    xmicrostructure::randomiser r0(7, 0), r1(7, 1), r0b(7, 0);
+    assert(r0() == r0b() && r0() != r1());
+    for (int k = 0; k < 1000; ++k) {
+      double const u = r0.uniform();
+      assert(u >= 0. && u < 1. && r0.below(5) < 5);
+    }
+
+    // energy stays consistent with a brute-force count and drops under coarsening
+    auto const brute = [](auto const& model) {
+      std::size_t unlike = 0;
+      auto const& n      = model.shape();
+      for (std::size_t y = 0; y < n[1]; ++y)
+        for (std::size_t x = 0; x < n[0]; ++x)
+          for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx) {
+              std::size_t const xs = (x + n[0] + dx) % n[0], ys = (y + n[1] + dy) % n[1];
+              unlike += model.spins()[model.index({x, y})] != model.spins()[model.index({xs, ys})];
+            }
+      return unlike / 2;
+    };
+
+    for (std::size_t threads : {std::size_t{1}, std::size_t{4}}) {
+      xmicrostructure::potts<2> model({64, 48}, 100, 11, threads);
+      std::size_t const         e0 = model.energy();
+      assert(e0 == brute(model));
+      model.sweep(30, 0.);
+      assert(model.time() == 30);
+      assert(model.energy() == brute(model));
+      assert(model.energy() * 3 < e0);
+
+      xmicrostructure::potts<2> again({64, 48}, 100, 11, threads);
+      again.sweep(30, 0.);
+      assert(std::ranges::equal(model.spins(), again.spins()));
+    }
+
+    // finite temperature keeps spins in range, 3-D runs on the 8-colour split
+    xmicrostructure::potts<3> cube({16, 16, 16}, 50, 3, 3);
+    std::size_t const         e0 = cube.energy();
+    cube.sweep(10, 0.5);
+    assert(cube.energy() < e0);
+    for (auto const s : cube.spins())
+      assert(s < 50);
+  }
+
+  // ================================
+  // kinetic Monte Carlo: sum tree and composition-rejection catalogues
+  {
+    auto const check = [](auto catalogue_tag) {
+      using catalogue = decltype(catalogue_tag);
+
+      // rates spanning twelve decades, then a local update
+      std::vector<double> rate = {1e-6, 3e-6, 1., 2., 5e5, 1e6, 0., 7.};
+      xmicrostructure::kinetic<catalogue> engine(rate.size(), 5);
+      for (std::size_t i = 0; i < rate.size(); ++i)
+        engine.set(i, rate[i]);
+      engine.set(5, rate[5] = 0.);
+      engine.set(4, rate[4] = 3.);
+
+      double total = 0.;
+      for (double r : rate)
+        total += r;
+      assert(std::abs(engine.rates().total() - total) < 1e-12 * total);
+
+      std::vector<std::size_t> hits(rate.size());
+      std::size_t const        n = 200000;
+      assert(engine.run(n, [&](std::size_t e) { ++hits[e]; }) == n);
+      for (std::size_t i = 0; i < rate.size(); ++i) {
+        double const expect = double(n) * rate[i] / total;
+        assert(std::abs(double(hits[i]) - expect) < 5. * std::sqrt(expect) + 1.);
+      }
+      assert(hits[6] == 0);
+      // mean waiting time 1 / total
+      assert(std::abs(engine.time() * total / double(n) - 1.) < 0.02);
+
+      // all rates zero: nothing to do
+      for (std::size_t i = 0; i < rate.size(); ++i)
+        engine.set(i, 0.);
+      assert(engine.step() == engine.size());
+    };
+    check(xmicrostructure::rate_tree{});
+    check(xmicrostructure::rate_groups{});
+
+    // 1-D vacancy hop on a ring: only the two neighbouring rates change per event
+    constexpr std::size_t sites = 1000;
+    xmicrostructure::kinetic<xmicrostructure::rate_groups> walk(2 * sites, 9);
+    std::size_t vacancy = 0;
+    auto const  place   = [&](std::size_t v, double r) {
+      walk.set(2 * v, r);
+      walk.set(2 * v + 1, r * 0.5);
+    };
+    place(vacancy, 1.);
+    walk.run(100000, [&](std::size_t e) {
+      place(vacancy, 0.);
+      vacancy = (e % 2 == 0) ? (vacancy + 1) % sites : (vacancy + sites - 1) % sites;
+      place(vacancy, 1.);
+    });
+    assert(walk.steps() == 100000 && std::abs(walk.time() * 1.5 / 100000. - 1.) < 0.02);
+  }
+
+  // ================================
+  // sublattice kinetic monte carlo: lattice gas random walk
+
+  {
+    using engine_type = xmicrostructure::sublattice_kinetic<2>;
+    constexpr std::size_t L = 128;
+
+    auto const simulate = [&](std::size_t threads, std::vector<int>& id,
+                              std::vector<std::array<long, 2>>& shift,
+                              bool reread = false) {
+      engine_type engine({L, L}, 4, 2, 0.25, 3, threads);
+
+      // 4 % coverage on a regular grid
+      id.assign(L * L, -1);
+      shift.clear();
+      for (std::size_t y = 0; y < L; y += 5)
+        for (std::size_t x = 0; x < L; x += 5) {
+          id[engine.index({x, y})] = int(shift.size());
+          shift.push_back({0, 0});
+        }
+
+      auto const target = [&](std::size_t i, std::size_t e) {
+        auto x = engine.coordinates(i);
+        std::size_t const a = e / 2;
+        x[a] = (x[a] + (e % 2 == 0 ? 1 : L - 1)) % L;
+        return engine.index(x);
+      };
+      auto const rate = [&](std::size_t i, std::size_t e) {
+        return id[i] >= 0 && id[target(i, e)] < 0 ? 1. : 0.;
+      };
+      auto const execute = [&](std::size_t i, std::size_t e,
+                               xmicrostructure::randomiser&) {
+        std::size_t const j = target(i, e);
+        assert(id[i] >= 0 && id[j] < 0);
+        shift[std::size_t(id[i])][e / 2] += e % 2 == 0 ? 1 : -1;
+        std::swap(id[i], id[j]);
+      };
+
+      std::size_t performed = 0;
+      if (reread) // every rate re-read in every window
+        while (engine.time() < 50.) {
+          engine.refresh();
+          performed += engine.advance(engine.time() + 0.25, rate, execute);
+        }
+      else
+        performed = engine.advance(50., rate, execute);
+      assert(engine.steps() == performed && engine.time() >= 50.);
+      return engine;
+    };
+
+    std::vector<int>                 id1, id4, again;
+    std::vector<std::array<long, 2>> shift1, shift4, shift_again;
+    auto const one  = simulate(1, id1, shift1);
+    auto const four = simulate(4, id4, shift4);
+    simulate(4, again, shift_again);
+    assert(four.slabs() == 4 && one.slabs() == 1);
+    assert(id4 == again && shift4 == shift_again);
+
+    // boundary-only reconciliation matches re-reading every rate
+    simulate(4, again, shift_again, true);
+    assert(id4 == again && shift4 == shift_again);
+
+    // particles conserved; dilute walkers: <r^2> slightly below 4 t
+    for (auto const* id : {&id1, &id4}) {
+      std::size_t particles = 0;
+      for (int const k : *id)
+        particles += k >= 0;
+      assert(particles == shift1.size());
+    }
+    for (auto const* shift : {&shift1, &shift4}) {
+      double msd = 0.;
+      for (auto const& d : *shift)
+        msd += double(d[0] * d[0] + d[1] * d[1]);
+      msd /= double(shift->size());
+      double const ratio = msd / (4. * one.time());
+      assert(ratio > 0.8 && ratio < 1.1);
+    }
+  }
+
+  // ================================
+  // fourier: mixed-radix transform against the direct sum
+
+  {
+    auto const check = [](auto plan) {
+      using complex = std::complex<double>;
+      auto const  extent = plan.shape();
+      std::size_t const n = plan.size();
+
+      xmicrostructure::randomiser rng(21);
+      std::vector<complex>        x(n);
+      for (complex& z : x)
+        z = {rng.uniform() - 0.5, rng.uniform() - 0.5};
+
+      std::vector<complex> y = x;
+      plan.forward(y);
+
+      double energy = 0., spectral = 0., error = 0.;
+      for (std::size_t k = 0; k < n; ++k) {
+        complex sum{};
+        for (std::size_t i = 0; i < n; ++i) {
+          double      phase = 0.;
+          std::size_t ri = i, rk = k;
+          for (std::size_t a = 0; a < extent.size(); ++a) {
+            phase += double((ri % extent[a]) * (rk % extent[a]) % extent[a]) /
+                     double(extent[a]);
+            ri /= extent[a];
+            rk /= extent[a];
+          }
+          sum += x[i] * std::polar(1., -2. * std::numbers::pi * phase);
+        }
+        error = std::max(error, std::abs(sum - y[k]));
+        energy += std::norm(x[k]);
+        spectral += std::norm(y[k]);
+      }
+      assert(error < 1e-10);
+      assert(std::abs(spectral / double(n) - energy) < 1e-10 * energy);
+
+      plan.inverse(y);
+      for (std::size_t i = 0; i < n; ++i)
+        assert(std::abs(y[i] - x[i]) < 1e-13);
+    };
+    check(xmicrostructure::fourier<2>({16, 9}, 3));
+    check(xmicrostructure::fourier<3>({6, 10, 7}, 2));
+    check(xmicrostructure::fourier<3>({25, 1, 11}, 1));
+#if X_MICROSTRUCTURE_SOLVER > 0
+    check(xmicrostructure::solver_fourier<2>({16, 9}, 3));
+    check(xmicrostructure::solver_fourier<3>({6, 10, 7}, 2));
+    check(xmicrostructure::solver_fourier<3>({25, 1, 11}, 1));
+#endif
+  }
+
+  // ================================
+  // phase field: allen-cahn interface profile, cahn-hilliard conservation
+
+  {
+    using xmicrostructure::phase_field_model;
+
+    // two flat interfaces relax to phi = tanh(x / sqrt(2 kappa)) with
+    // steps far above the explicit limit dx^2 / (4 kappa) = 1 / 16
+    constexpr std::size_t L     = 128;
+    double const          kappa = 4.;
+    xmicrostructure::phase_field<2> ac({L, 4}, phase_field_model::allen_cahn,
+                                       1., kappa, 1., 2);
+    auto phi = ac.values();
+    for (std::size_t i = 0; i < phi.size(); ++i) {
+      std::size_t const x = i % L;
+      phi[i] = x >= L / 4 && x < 3 * L / 4 ? 1. : -1.;
+    }
+    ac.stabilise(1.);
+    ac.step(400, 0.5);
+    assert(std::abs(ac.time() - 200.) < 1e-9);
+
+    double error = 0.;
+    for (std::size_t i = 0; i < phi.size(); ++i) {
+      double const x = double(i % L);
+      double const exact =
+          std::tanh((x - (L / 4 - 0.5)) / std::sqrt(2. * kappa)) *
+          std::tanh((3 * L / 4 - 0.5 - x) / std::sqrt(2. * kappa));
+      error = std::max(error, std::abs(phi[i] - exact));
+    }
+    assert(error < 1e-3);
+
+    // spinodal decomposition from small noise: mass conserved, phases form
+    xmicrostructure::phase_field<2> ch({48, 40}, phase_field_model::cahn_hilliard,
+                                       1., 1., 1.);
+    xmicrostructure::randomiser rng(8);
+    for (double& c : ch.values())
+      c = 0.1 + 0.05 * (rng.uniform() - 0.5);
+    double const mass = ch.mean();
+    ch.stabilise(1.);
+    ch.step(500, 0.5);
+
+    double low = 1., high = -1.;
+    for (double const c : ch.values()) {
+      low  = std::min(low, c);
+      high = std::max(high, c);
+    }
+    assert(std::abs(ch.mean() - mass) < 1e-12);
+    assert(low < -0.9 && high > 0.9);
+  }
+
+  // ================================
+  // multi phase field: curvature-driven shrinkage, sparse active sets
+
+  {
+    using engine_type = xmicrostructure::multi_phase_field<2>;
+    using grain_type  = engine_type::grain_type;
+
+    // circular grain in a matrix: dA/dt = -2 pi L kappa, linear in time
+    constexpr std::size_t L = 96;
+    engine_type           circle({L, L}, 1., 1., 1.5, 1., 2);
+    std::vector<grain_type> map(L * L);
+    for (std::size_t i = 0; i < map.size(); ++i) {
+      double const x = double(i % L) - 47.5, y = double(i / L) - 47.5;
+      map[i] = x * x + y * y < 30. * 30. ? 1 : 70000;
+    }
+    circle.assign(map);
+
+    auto const area = [&] {
+      std::size_t a = 0;
+      for (std::size_t i = 0; i < circle.size(); ++i)
+        a += circle.grain(i) == 1;
+      return double(a);
+    };
+    double const a0 = area();
+    circle.step(500, 0.2);
+    double const a1 = area();
+    circle.step(500, 0.2);
+    double const a2 = area();
+    assert(a1 < a0 && a2 < a1);
+    assert(std::abs((a1 - a2) / (a0 - a1) - 1.) < 0.2);
+    assert(std::abs((a0 - a2) / (2. * std::numbers::pi * circle.time()) - 1.) < 0.15);
+
+    // a bulk site carries its own grain alone
+    std::size_t const centre = circle.index({48, 48});
+    assert(circle.active(centre) == 1 && std::abs(circle.value(centre, 1) - 1.) < 1e-6);
+
+    // polycrystal: 300 grains with ids up to 10^6 in a fixed-capacity store
+    constexpr std::size_t P = 64;
+    engine_type           poly({P, P}, 1., 0.5, 1.5, 1., 3);
+    xmicrostructure::randomiser rng(4);
+    std::vector<std::array<double, 2>> seed(300);
+    std::vector<grain_type>            id(seed.size());
+    for (std::size_t s = 0; s < seed.size(); ++s) {
+      seed[s] = {rng.uniform() * P, rng.uniform() * P};
+      id[s]   = rng.below(1000000);
+    }
+    std::vector<grain_type> voronoi(P * P);
+    for (std::size_t i = 0; i < voronoi.size(); ++i) {
+      double best = 1e9;
+      for (std::size_t s = 0; s < seed.size(); ++s) {
+        double dx = std::abs(double(i % P) - seed[s][0]);
+        double dy = std::abs(double(i / P) - seed[s][1]);
+        dx = std::min(dx, P - dx);
+        dy = std::min(dy, P - dy);
+        if (dx * dx + dy * dy < best) {
+          best       = dx * dx + dy * dy;
+          voronoi[i] = id[s];
+        }
+      }
+    }
+    poly.assign(voronoi);
+
+    auto const grains = [&] {
+      std::vector<grain_type> g(poly.size());
+      for (std::size_t i = 0; i < g.size(); ++i)
+        g[i] = poly.grain(i);
+      std::sort(g.begin(), g.end());
+      return std::size_t(std::unique(g.begin(), g.end()) - g.begin());
+    };
+    std::size_t const before = grains();
+    poly.step(400, 0.2);
+
+    std::size_t most = 0, sum = 0;
+    for (std::size_t i = 0; i < poly.size(); ++i) {
+      most = std::max(most, poly.active(i));
+      sum += poly.active(i);
+    }
+    assert(grains() < before && most <= engine_type::capacity);
+    assert(double(sum) / double(poly.size()) < 4.);
+  }
+
+  // ================================
+  // fft elasticity: homogeneous medium, laminate tractions, scheme agreement
+
+  {
+    using xmicrostructure::dimension;
+    using xmicrostructure::rank;
+
+    auto const isotropic = []<xmicrostructure::dimension D>(
+                               std::integral_constant<xmicrostructure::dimension, D>,
+                               double lambda, double mu) {
+      constexpr std::size_t n = xmicrostructure::dimension_t(D);
+      xmicrostructure::tensor<double, rank::tensor4, D> c;
+      for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+          for (std::size_t k = 0; k < n; ++k)
+            for (std::size_t l = 0; l < n; ++l)
+              c.value[((i * n + j) * n + k) * n + l] =
+                  lambda * (i == j) * (k == l) + mu * ((i == k) * (j == l) + (i == l) * (j == k));
+      return c;
+    };
+    using xmicrostructure::elasticity_scheme;
+    using d3 = std::integral_constant<xmicrostructure::dimension, dimension::three>;
+    using d2 = std::integral_constant<xmicrostructure::dimension, dimension::two>;
+
+    // 3-D laminate normal to x: tractions s_11, s_12, s_13 and strains
+    // e_22, e_33, e_23 are uniform; contrast 50
+    {
+      using solver_type = xmicrostructure::elasticity<dimension::three>;
+      std::array stiffness{isotropic(d3{}, 1., 1.), isotropic(d3{}, 50., 50.)};
+      std::vector<solver_type::grain_type> grain(12 * 4 * 6);
+      for (std::size_t i = 0; i < grain.size(); ++i)
+        grain[i] = i % 12 < 5 ? 0 : 1;
+
+      solver_type::tensor_type macro;
+      macro.value = {0.01, -0.002, 0.003, 0.004 * std::sqrt(2.), 0.001 * std::sqrt(2.),
+                     0.005 * std::sqrt(2.)};
+
+      solver_type basic({12, 4, 6}, grain, std::span<decltype(stiffness)::value_type const>(stiffness), 2);
+      solver_type cg({12, 4, 6}, grain, std::span<decltype(stiffness)::value_type const>(stiffness), 2);
+      auto const ob = basic.solve(macro, elasticity_scheme::basic, 1e-9, 5000);
+      auto const oc = cg.solve(macro, elasticity_scheme::conjugate_gradient, 1e-9);
+      assert(ob.converged && oc.converged && oc.iterations * 4 < ob.iterations);
+
+      for (auto const* s : {&basic, &cg}) {
+        // Mandel order 11 22 33 23 13 12
+        for (std::size_t c : {0u, 4u, 5u}) {
+          auto const row = s->stress().component(c);
+          auto const [lo, hi] = std::minmax_element(row.begin(), row.end());
+          assert(*hi - *lo < 1e-6 * std::abs(*hi) + 1e-9);
+        }
+        for (std::size_t c : {1u, 2u, 3u}) {
+          auto const row = s->strain().component(c);
+          for (double const e : row)
+            assert(std::abs(e - macro.value[c]) < 1e-8);
+        }
+        // the mean strain is prescribed
+        auto const e = xmicrostructure::mean(s->strain());
+        for (std::size_t c = 0; c < 6; ++c)
+          assert(std::abs(e[c] - macro.value[c]) < 1e-12);
+      }
+      auto const sb = basic.mean_stress(), sc = cg.mean_stress();
+      for (std::size_t c = 0; c < 6; ++c)
+        assert(std::abs(sb[c] - sc[c]) < 1e-6 * std::abs(sc[0]));
+    }
+
+    // 2-D homogeneous medium: exact after one evaluation
+    {
+      using solver_type = xmicrostructure::elasticity<dimension::two>;
+      std::array stiffness{isotropic(d2{}, 2., 3.), isotropic(d2{}, 2., 3.)};
+      std::vector<solver_type::grain_type> grain(10 * 9);
+      for (std::size_t i = 0; i < grain.size(); ++i)
+        grain[i] = i % 3 == 0;
+      solver_type homogeneous({10, 9}, grain,
+                              std::span<decltype(stiffness)::value_type const>(stiffness), 1);
+      solver_type::tensor_type macro;
+      macro.value = {0.01, 0.02, 0.03};
+      auto const o = homogeneous.solve(macro, elasticity_scheme::basic);
+      assert(o.converged && o.iterations == 0);
+      auto const s = homogeneous.mean_stress();
+      assert(std::abs(s[0] - (2. * 0.03 + 6. * 0.01)) < 1e-12);
+      assert(std::abs(s[2] - 6. * 0.03) < 1e-12);
+
+      // random two-phase blocks, contrast 100: schemes agree, CG is faster
+      std::array contrast{isotropic(d2{}, 1., 1.), isotropic(d2{}, 100., 100.)};
+      std::vector<solver_type::grain_type> blocks(32 * 32);
+      xmicrostructure::randomiser rng(12);
+      std::array<solver_type::grain_type, 64> phase;
+      for (auto& p : phase)
+        p = rng.below(2);
+      for (std::size_t i = 0; i < blocks.size(); ++i)
+        blocks[i] = phase[(i % 32) / 4 + 8 * ((i / 32) / 4)];
+
+      auto const span = std::span<decltype(contrast)::value_type const>(contrast);
+      solver_type basic({32, 32}, blocks, span, 2), cg({32, 32}, blocks, span, 2);
+      auto const ob = basic.solve(macro, elasticity_scheme::basic, 1e-7, 20000);
+      auto const oc = cg.solve(macro, elasticity_scheme::conjugate_gradient, 1e-7);
+      assert(ob.converged && oc.converged && oc.iterations * 3 < ob.iterations);
+      auto const sb = basic.mean_stress(), sc = cg.mean_stress();
+      for (std::size_t c = 0; c < 3; ++c)
+        assert(std::abs(sb[c] - sc[c]) < 1e-4 * std::abs(sc[1]));
+    }
+  }
+
+  // ================================
+  // ode integrators: dormand-prince accuracy, rosenbrock on a stiff system
+
+  {
+    // harmonic oscillator: y = (cos t, -sin t)
+    auto const oscillator = [](double, std::span<double const> y,
+                               std::span<double> f) {
+      f[0] = y[1];
+      f[1] = -y[0];
+    };
+    xmicrostructure::dormand_prince dp(2, 1e-9, 1e-12);
+    std::array<double, 2>           y{1., 0.};
+    auto const report = dp.integrate(oscillator, 0., 10., y);
+    assert(report.success && report.accepted > 10);
+    assert(std::abs(y[0] - std::cos(10.)) < 1e-7);
+    assert(std::abs(y[1] + std::sin(10.)) < 1e-7);
+    // six evaluations per attempt after the first (FSAL)
+    assert(report.evaluations <= 6 * (report.accepted + report.rejected) + 2);
+
+    // step by step, continuing from the proposed step size
+    double t = 0., h = 0.1;
+    y        = {1., 0.};
+    dp.reset();
+    while (t < 1.) {
+      double trial = std::min(h, 1. - t);
+      dp.step(oscillator, t, y, trial);
+      h = trial;
+    }
+    assert(std::abs(t - 1.) < 1e-12 && std::abs(y[0] - std::cos(1.)) < 1e-8);
+
+    // Robertson kinetics: rates spanning nine decades
+    auto const robertson = [](double, std::span<double const> y,
+                              std::span<double> f) {
+      f[0] = -0.04 * y[0] + 1e4 * y[1] * y[2];
+      f[2] = 3e7 * y[1] * y[1];
+      f[1] = -f[0] - f[2];
+    };
+    auto const jacobian = [](double, std::span<double const> y,
+                             std::span<double> J) {
+      J[0] = -0.04, J[1] = 1e4 * y[2], J[2] = 1e4 * y[1];
+      J[6] = 0., J[7] = 6e7 * y[1], J[8] = 0.;
+      for (std::size_t j = 0; j < 3; ++j)
+        J[3 + j] = -J[j] - J[6 + j];
+    };
+
+    xmicrostructure::rosenbrock stiff(3, 1e-4, 1e-10);
+    std::array<double, 3>       u{1., 0., 0.}, v{1., 0., 0.};
+    auto const analytic = stiff.integrate(robertson, jacobian, 0., 40., u);
+    auto const numeric  = stiff.integrate(robertson, 0., 40., v);
+    assert(analytic.success && numeric.success);
+    for (auto const& s : {u, v}) {
+      assert(std::abs(s[0] - 0.7158270687) < 2e-4);
+      assert(std::abs(s[1] / 9.185534764e-6 - 1.) < 2e-3);
+      assert(std::abs(s[0] + s[1] + s[2] - 1.) < 1e-12);
+    }
+    assert(analytic.accepted < 200);
+    assert(numeric.evaluations > analytic.evaluations);
+
+    // the explicit scheme is stability-bound: more steps for 1/40 of the span
+    std::array<double, 3> w{1., 0., 0.};
+    auto const explicit_run =
+        xmicrostructure::dormand_prince(3, 1e-4, 1e-10)
+            .integrate(robertson, 0., 1., w);
+    assert(explicit_run.success);
+    assert(explicit_run.accepted > 4 * analytic.accepted);
+
+    // an accepted last step that ends within rounding of t1 reaches t1, even
+    // when the step proposed after it is shorter than the one taken
+    auto const decay = [](double, std::span<double const> y,
+                          std::span<double> f) { f[0] = -3. * y[0]; };
+    auto const decay_jacobian = [](double, std::span<double const>,
+                                   std::span<double> J) { J[0] = -3.; };
+    double const t0 = 0.1180799059133742, t1 = 0.8703491968556812;
+    std::array<double, 1> d{1.};
+    auto const last = xmicrostructure::dormand_prince(1, .07, .07)
+                          .integrate(decay, t0, t1, d, 10.);
+    assert(last.success && last.accepted == 1 && last.rejected == 0);
+    d = {1.};
+    auto const stiff_last = xmicrostructure::rosenbrock(1, .07, .07)
+                                .integrate(decay, decay_jacobian, t0, t1, d, 10.);
+    assert(stiff_last.success);
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,74 @@
+#pragma once
+
+namespace xmicrostructure {
+
+/**
+ * \class randomiser
+ * \brief xoshiro256** Generator with Independent Seeded Streams
+ * \note  Each (seed, stream) pair is expanded through splitmix64, so every
+ *        thread or block can own a reproducible, uncorrelated stream
+ * \note  Satisfies UniformRandomBitGenerator for use with <random>
+ */
+
+class randomiser {
+
+public:
+  using result_type = std::uint64_t;
+
+  // --------------------------------
+
+public:
+
+  // CONSTRUCTORS
+
+  explicit randomiser(std::uint64_t a_seed = 0, std::uint64_t a_stream = 0) {
+    std::uint64_t x = a_seed ^ (a_stream * 0xd1b54a32d192ed03ull);
+    for (auto& s : state)
+      s = splitmix(x);
+  }
+
+  // --------------------------------
+
+public:
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~result_type{0}; }
+
+  result_type operator()() {
+    result_type const r = rotl(state[1] * 5, 7) * 9;
+    result_type const t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return r;
+  }
+
+  /** \brief Uniform Double in [0, 1) from the Upper 53 Bits */
+  double uniform() { return double((*this)() >> 11) * 0x1.0p-53; }
+
+  /** \brief Uniform Integer in [0, n) (Lemire's Multiply-Shift) */
+  std::uint32_t below(std::uint32_t n) {
+    return std::uint32_t(((*this)() >> 32) * n >> 32);
+  }
+
+  // --------------------------------
+
+private:
+  static constexpr result_type rotl(result_type x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  static constexpr result_type splitmix(std::uint64_t& x) {
+    result_type z = (x += 0x9e3779b97f4a7c15ull);
+    z             = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z             = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  std::array<result_type, 4> state;
+};
+
+} // namespace xmicrostructure
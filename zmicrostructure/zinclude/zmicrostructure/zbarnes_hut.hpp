@@ -0,0 +1,429 @@
+/*******************************************************************************
+ * ZBARNES_HUT
+ * -----------------------------------------------------------------------------
+ *
+ * \file       zbarnes_hut.hpp
+ * \brief      Barnes-Hut Cauchy Sums on a Morton-Sorted Linear Quadtree
+ *
+ * \code       HTTPS://GITHUB.COM/M1TE5H/MICROSTRUCTURE
+ *
+ * \author     M1TE5H
+ * \date       2022-12-31
+ * \copyright  COPYRIGHT (C) 2022--PRESENT BY M1TE5H
+ * \link       HTTPS://WWW.M1TE5H.COM
+ *
+ * \version    0.0.0
+ *
+ * =============================================================================
+ * @details Design Rationale
+ *
+ * Exploratory runs do not need the accuracy of the \b zfmm but move every
+ * defect every step, so the tree is rebuilt each time. The \b zbarnes_hut
+ * gives the same sums f = sum q / (z - z_j) and f' at every defect with an
+ * adaptive tree that is cheap to build, and trades accuracy for speed
+ * through the opening angle.
+ *
+ * - Build: Morton codes (31 bits per axis) sorted with zparallel_sort; the
+ *   tree is then split level by level, a node's quadrants found by binary
+ *   search on the sorted codes, all nodes of a level in parallel. Nodes are
+ *   stored level by level and siblings are contiguous (a linear tree)
+ * - Nodes: a contiguous range of the sorted defects and a multipole expansion
+ *   of low order about the cell centre, computed straight from the defects
+ *   (no M2M, so every node is independent)
+ * - Opening Angle: a cell of width w at distance d from the target is used
+ *   as a whole if w < angle d, otherwise its children are visited; leaves
+ *   that are too close are summed directly
+ * - Traversal: one target per iteration, targets in Morton order so that
+ *   neighbouring targets take similar paths; blocks of targets per thread
+ * - Accuracy: at angle 0.5 the monopole alone gives about 1e-2 relative
+ *   error and order 6 about 1e-5; angle 0 is direct summation. For very large
+ *   counts at high accuracy the zfmm is faster
+ *
+ * =============================================================================
+ * @example User Guide
+ *
+ * zbarnes_hut tree{.6};
+ *
+ * for (auto step = 0; step < steps; ++step) {
+ *   tree.build(std::span{line});
+ *   zedge_field(tree, std::span{burgers}, zedge_stress{xx, yy, xy, zz},
+ *               medium);
+ *   // move the lines ...
+ * }
+ *
+ ******************************************************************************/
+
+#ifndef __Z_MICROSTRUCTURE_Z_BARNES_HUT_HPP__
+#define __Z_MICROSTRUCTURE_Z_BARNES_HUT_HPP__
+
+#pragma once
+
+// =============================================================================
+
+/// @note not standard/common use but convenient in this isolation code
+#ifdef Z_MICROSTRUCTURE_NAMESPACE
+
+#define Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE(TOGGLE)                        \
+  Z_MICROSTRUCTURE_NAMESPACE(TOGGLE)
+
+#else
+
+#define Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE_NAME() zmicrostructure
+#define Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE_BEGIN()                        \
+  namespace Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE_NAME() {
+#define Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE_END() }
+#define Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE(TOGGLE)                        \
+  Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE_##TOGGLE()
+
+#endif
+
+// =============================================================================
+
+// C Headers
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// C++98/03/11/14/17 Headers
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// C++20/23 Headers
+#include <span>
+
+#include "zparallel.hpp"
+#include "zspatial.hpp"
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE(BEGIN)
+// =============================================================================
+// =============================================================================
+
+// =============================================================================
+/// zbarnes_hut
+// =============================================================================
+
+/// @class  zbarnes_hut
+/// @brief  Barnes-Hut Sums of the Cauchy Kernel over a Set of Defects
+/// @note   Values are returned at the defects themselves; a defect omits its
+///         own term and those of defects at exactly the same location
+class zbarnes_hut {
+public:
+  using size_type    = std::size_t;
+  using complex_type = std::complex<double>;
+
+  /// @brief Morton Bits per Axis, also the Deepest Level
+  static constexpr size_type k_depth = 31;
+
+  /// @brief Cell of the Linear Tree
+  struct znode {
+    size_type    begin{0}, end{0};
+    size_type    child{0}, children{0};
+    size_type    level{0};
+    complex_type centre{};
+    double       width{0.};
+  };
+
+public:
+  /// @brief Constructor
+  /// @param i_angle: opening angle (cell width over distance)
+  /// @param i_order: multipole terms per cell (1 is the classic monopole)
+  /// @param i_leaf: largest number of defects in a leaf
+  explicit zbarnes_hut(double i_angle = .5, size_type i_order = 6,
+                       size_type i_leaf = 16)
+      : m_angle{i_angle}, m_order{std::max<size_type>(1, i_order)},
+        m_leaf{std::max<size_type>(1, i_leaf)} {
+    assert(i_angle >= 0. && i_angle <= 1.);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief (Re)Build the Tree over the Defect Locations
+  /// @param i_threads: worker count (0 selects the hardware concurrency)
+  template <zdetail::zspatial LocationT>
+  auto build(std::span<LocationT const> i_location, size_type i_threads = 0)
+      -> void {
+    auto const n = i_location.size();
+    m_location.resize(n);
+    auto const blocks = zdetail::zblocks(n, i_threads);
+    std::vector<std::pair<complex_type, complex_type>> bounds(
+        blocks, {complex_type{std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::max()},
+                 complex_type{std::numeric_limits<double>::lowest(),
+                              std::numeric_limits<double>::lowest()}});
+    zdetail::zparallel_for(
+        n, i_threads, [&](size_type b, size_type begin, size_type end) {
+          auto& [lower, upper] = bounds[b];
+          for (auto i = begin; i < end; ++i) {
+            auto const z = complex_type{
+                static_cast<double>(zdetail::zcoordinate(i_location[i], 0)),
+                static_cast<double>(zdetail::zcoordinate(i_location[i], 1))};
+            m_location[i] = z;
+            lower = {std::min(lower.real(), z.real()),
+                     std::min(lower.imag(), z.imag())};
+            upper = {std::max(upper.real(), z.real()),
+                     std::max(upper.imag(), z.imag())};
+          }
+        });
+    auto [lower, upper] = bounds[0];
+    for (auto const& [l, u] : bounds) {
+      lower = {std::min(lower.real(), l.real()),
+               std::min(lower.imag(), l.imag())};
+      upper = {std::max(upper.real(), u.real()),
+               std::max(upper.imag(), u.imag())};
+    }
+    m_lower = n > 0 ? lower : complex_type{};
+    m_width = n > 0 ? std::max(upper.real() - lower.real(),
+                               upper.imag() - lower.imag())
+                    : 0.;
+    m_width = m_width > 0. ? m_width * (1. + 1e-12) : 1.;
+
+    // Morton codes, sorted with the build order as tie break
+    auto const side = static_cast<double>(std::uint64_t{1} << k_depth);
+    auto const top =
+        static_cast<std::uint32_t>((std::uint64_t{1} << k_depth) - 1);
+    std::vector<std::pair<std::uint64_t, size_type>> key(n);
+    zdetail::zparallel_for(
+        n, i_threads, [&](size_type, size_type begin, size_type end) {
+          for (auto i = begin; i < end; ++i) {
+            auto const d  = (m_location[i] - m_lower) * (side / m_width);
+            auto const ix = std::min(top, static_cast<std::uint32_t>(d.real()));
+            auto const iy = std::min(top, static_cast<std::uint32_t>(d.imag()));
+            key[i]        = {zdetail::zmorton(ix, iy), i};
+          }
+        });
+    zdetail::zparallel_sort(key.begin(), key.end(), i_threads);
+
+    m_code.resize(n);
+    m_index.resize(n);
+    m_point.resize(n);
+    zdetail::zparallel_for(
+        n, i_threads, [&](size_type, size_type begin, size_type end) {
+          for (auto s = begin; s < end; ++s) {
+            m_code[s]  = key[s].first;
+            m_index[s] = key[s].second;
+            m_point[s] = m_location[key[s].second];
+          }
+        });
+
+    // split level by level; the children of a level form the next level
+    m_node.assign(1, node(0, n, 0));
+    std::vector<std::array<size_type, 5>> split;
+    std::vector<size_type>                first;
+    for (size_type begin = 0, end = 1; begin < end;
+         begin = end, end = m_node.size()) {
+      split.assign(end - begin, {});
+      zdetail::zparallel_for(
+          end - begin, i_threads,
+          [&](size_type, size_type lo, size_type hi) {
+            for (auto k = lo; k < hi; ++k)
+              split[k] = quadrants(m_node[begin + k]);
+          });
+
+      first.assign(end - begin + 1, m_node.size());
+      for (size_type k = 0; k < end - begin; ++k) {
+        size_type children{0};
+        for (size_type q = 0; q < 4; ++q)
+          children += split[k][q] < split[k][q + 1];
+        first[k + 1] = first[k] + children;
+      }
+      m_node.resize(first.back());
+      zdetail::zparallel_for(
+          end - begin, i_threads,
+          [&](size_type, size_type lo, size_type hi) {
+            for (auto k = lo; k < hi; ++k) {
+              auto& parent    = m_node[begin + k];
+              parent.child    = first[k];
+              parent.children = first[k + 1] - first[k];
+              auto c          = first[k];
+              for (size_type q = 0; q < 4; ++q)
+                if (split[k][q] < split[k][q + 1])
+                  m_node[c++] =
+                      node(split[k][q], split[k][q + 1], parent.level + 1);
+            }
+          });
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief  f and f' at every Defect for Complex Charges q (Build Order)
+  /// @param  o_field: f(z_i) = sum_j q_j / (z_i - z_j)
+  /// @param  o_gradient: f'(z_i) = -sum_j q_j / (z_i - z_j)^2 (may be empty)
+  /// @param  i_threads: worker count (0 selects the hardware concurrency)
+  auto evaluate(std::span<complex_type const> i_charge,
+                std::span<complex_type>       o_field,
+                std::span<complex_type>       o_gradient = {},
+                size_type i_threads = 0) const -> void {
+    auto const n = m_point.size();
+    auto const p = m_order;
+    assert(i_charge.size() == n && o_field.size() >= n);
+    assert(o_gradient.empty() || o_gradient.size() >= n);
+
+    std::vector<complex_type> charge(n);
+    zdetail::zparallel_for(
+        n, i_threads, [&](size_type, size_type begin, size_type end) {
+          for (auto s = begin; s < end; ++s)
+            charge[s] = i_charge[m_index[s]];
+        });
+
+    // multipoles a_k = sum q ((z - c) / w)^k, straight from the defects
+    std::vector<complex_type> multipole(m_node.size() * p);
+    zdetail::zparallel_for(
+        m_node.size(), i_threads,
+        [&](size_type, size_type begin, size_type end) {
+          for (auto k = begin; k < end; ++k) {
+            auto const& cell  = m_node[k];
+            auto*       alpha = multipole.data() + k * p;
+            for (auto s = cell.begin; s < cell.end; ++s) {
+              auto const w  = (m_point[s] - cell.centre) / cell.width;
+              auto       pw = charge[s];
+              for (size_type m = 0; m < p; ++m, pw *= w)
+                alpha[m] += pw;
+            }
+          }
+        });
+
+    zdetail::zparallel_for(
+        n, i_threads, [&](size_type, size_type begin, size_type end) {
+          std::array<size_type, 4 * (k_depth + 1)> stack;
+          for (auto s = begin; s < end; ++s) {
+            auto const   z = m_point[s];
+            complex_type f{}, g{};
+            size_type    top{0};
+            if (!m_node.empty())
+              stack[top++] = 0;
+
+            while (top > 0) {
+              auto const  k    = stack[--top];
+              auto const& cell = m_node[k];
+              auto const  d    = z - cell.centre;
+
+              if (cell.width < m_angle * std::abs(d)) {
+                auto const* alpha = multipole.data() + k * p;
+                auto const  u     = cell.width / d;
+                complex_type a{}, b{};
+                for (auto m = p; m-- > 0;) {
+                  a = a * u + alpha[m];
+                  b = b * u + static_cast<double>(m + 1) * alpha[m];
+                }
+                f += a / d;
+                g -= b / (d * d);
+              } else if (cell.children == 0) {
+                double fr{0.}, fi{0.}, gr{0.}, gi{0.};
+                for (auto j = cell.begin; j < cell.end; ++j) {
+                  auto const dx = z.real() - m_point[j].real();
+                  auto const dy = z.imag() - m_point[j].imag();
+                  auto const r2 = dx * dx + dy * dy;
+                  if (r2 == 0.)
+                    continue;
+                  auto const ir = dx / r2, ii = -dy / r2;
+                  auto const qr = charge[j].real(), qi = charge[j].imag();
+                  auto const vr = qr * ir - qi * ii, vi = qr * ii + qi * ir;
+                  fr += vr;
+                  fi += vi;
+                  gr -= vr * ir - vi * ii;
+                  gi -= vr * ii + vi * ir;
+                }
+                f += complex_type{fr, fi};
+                g += complex_type{gr, gi};
+              } else {
+                for (auto c = cell.child; c < cell.child + cell.children; ++c)
+                  stack[top++] = c;
+              }
+            }
+
+            o_field[m_index[s]] = f;
+            if (!o_gradient.empty())
+              o_gradient[m_index[s]] = g;
+          }
+        });
+  }
+
+  // ---------------------------------------------------------------------------
+
+  [[nodiscard]] auto angle() const noexcept -> double { return m_angle; }
+  auto               angle(double i_angle) -> void {
+    assert(i_angle >= 0. && i_angle <= 1.);
+    m_angle = i_angle;
+  }
+  [[nodiscard]] auto order() const noexcept -> size_type { return m_order; }
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_location.size();
+  }
+  /// @brief Cells of the Tree, Level by Level (the Root First)
+  [[nodiscard]] auto nodes() const noexcept -> std::span<znode const> {
+    return m_node;
+  }
+  /// @brief Defect Locations x + iy in Build Order
+  [[nodiscard]] auto location() const noexcept
+      -> std::span<complex_type const> {
+    return m_location;
+  }
+
+private:
+  /// @brief Cell of the Sorted Range [begin, end) at a Level
+  [[nodiscard]] auto node(size_type i_begin, size_type i_end,
+                          size_type i_level) const -> znode {
+    znode cell{i_begin, i_end, 0, 0, i_level, m_lower, m_width};
+    if (i_begin == i_end)
+      return cell;
+    auto const prefix = m_code[i_begin] >> (2 * (k_depth - i_level));
+    auto const w = m_width / static_cast<double>(std::uint64_t{1} << i_level);
+    cell.width   = w;
+    cell.centre +=
+        complex_type{(zdetail::zmorton_compact(prefix) + .5) * w,
+                     (zdetail::zmorton_compact(prefix >> 1) + .5) * w};
+    return cell;
+  }
+
+  /// @brief  Bounds of the Four Quadrants of a Cell in the Sorted Codes
+  /// @note   Leaves (few defects or the deepest level) return empty quadrants
+  [[nodiscard]] auto quadrants(znode const& i_cell) const
+      -> std::array<size_type, 5> {
+    std::array<size_type, 5> bound;
+    bound.fill(i_cell.begin);
+    if (i_cell.end - i_cell.begin <= m_leaf || i_cell.level >= k_depth)
+      return bound;
+
+    auto const shift = 2 * (k_depth - i_cell.level - 1);
+    auto const lo = m_code.begin() + static_cast<std::ptrdiff_t>(i_cell.begin);
+    auto const hi = m_code.begin() + static_cast<std::ptrdiff_t>(i_cell.end);
+    for (std::uint64_t q = 1; q < 4; ++q)
+      bound[q] = static_cast<size_type>(
+          std::partition_point(lo, hi, [&](std::uint64_t c) {
+            return ((c >> shift) & 3) < q;
+          }) -
+          m_code.begin());
+    bound[4] = i_cell.end;
+    return bound;
+  }
+
+private:
+  double    m_angle;
+  size_type m_order;
+  size_type m_leaf;
+
+  complex_type m_lower{};
+  double       m_width{1.};
+
+  std::vector<complex_type>  m_location;
+  std::vector<complex_type>  m_point;
+  std::vector<std::uint64_t> m_code;
+  std::vector<size_type>     m_index;
+  std::vector<znode>         m_node;
+};
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_BARNES_HUT_NAMESPACE(END)
+// =============================================================================
+// =============================================================================
+
+#endif // !__Z_MICROSTRUCTURE_Z_BARNES_HUT_HPP__
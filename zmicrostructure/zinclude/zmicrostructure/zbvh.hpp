@@ -0,0 +1,759 @@
+/*******************************************************************************
+ * ZBVH
+ * -----------------------------------------------------------------------------
+ *
+ * \file       zbvh.hpp
+ * \brief      Bounding Volume Hierarchy over Line Segments and Polylines
+ *
+ * \code       HTTPS://GITHUB.COM/M1TE5H/MICROSTRUCTURE
+ *
+ * \author     M1TE5H
+ * \date       2022-12-31
+ * \copyright  COPYRIGHT (C) 2022--PRESENT BY M1TE5H
+ * \link       HTTPS://WWW.M1TE5H.COM
+ *
+ * \version    0.0.0
+ *
+ * =============================================================================
+ * @details Design Rationale
+ *
+ * Grain-boundary edges and dislocation lines are polylines. Junction
+ * detection, boundary pinning and line-of-sight checks reduce to segment
+ * queries that the \b zbvh answers without testing every segment against
+ * every other.
+ *
+ * - Build: top-down binned surface area heuristic (SAH) over segment centroids
+ * - Layout: depth-first flattened nodes, the left child directly follows its
+ *   parent and segments are stored in leaf order
+ * - Queries: segment-segment intersection (exact orientation predicates in two
+ *   dimensions, closest approach within a tolerance otherwise), nearest
+ *   segment to a point (best-first), ray casting (two dimensions)
+ *
+ * =============================================================================
+ * @example User Guide
+ *
+ * // boundary network: vertices and polyline offsets (CSR)
+ * std::vector<point>       vertex { ... };
+ * std::vector<std::size_t> offset { 0, 12, 30, ... };
+ *
+ * zbvh<point> boundary;
+ * boundary.build(vertex, offset);
+ *
+ * auto junction = boundary.intersections();         // crossing pairs
+ * auto closest  = boundary.nearest(point{.5f, .5f});
+ * auto hit      = boundary.raycast({0.f, 0.f}, {1.f, 0.f});
+ *
+ ******************************************************************************/
+
+#ifndef __Z_MICROSTRUCTURE_Z_BVH_HPP__
+#define __Z_MICROSTRUCTURE_Z_BVH_HPP__
+
+#pragma once
+
+// =============================================================================
+
+/// @note not standard/common use but convenient in this isolation code
+#ifdef Z_MICROSTRUCTURE_NAMESPACE
+
+#define Z_MICROSTRUCTURE_Z_BVH_NAMESPACE(TOGGLE)                               \
+  Z_MICROSTRUCTURE_NAMESPACE(TOGGLE)
+
+#else
+
+#define Z_MICROSTRUCTURE_Z_BVH_NAMESPACE_NAME() zmicrostructure
+#define Z_MICROSTRUCTURE_Z_BVH_NAMESPACE_BEGIN()                               \
+  namespace Z_MICROSTRUCTURE_Z_BVH_NAMESPACE_NAME() {
+#define Z_MICROSTRUCTURE_Z_BVH_NAMESPACE_END() }
+#define Z_MICROSTRUCTURE_Z_BVH_NAMESPACE(TOGGLE)                               \
+  Z_MICROSTRUCTURE_Z_BVH_NAMESPACE_##TOGGLE()
+
+#endif
+
+// =============================================================================
+
+// C Headers
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// C++98/03/11/14/17 Headers
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// C++20/23 Headers
+#include <concepts>
+#include <span>
+
+#include "zparallel.hpp"
+#include "zspatial.hpp"
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_BVH_NAMESPACE(BEGIN)
+// =============================================================================
+// =============================================================================
+
+/// @brief Ray Hit: Segment Index and Ray Parameter (origin + t * direction)
+template <typename MeasureT> struct zray_hit {
+  std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+  MeasureT      parameter{std::numeric_limits<MeasureT>::max()};
+
+  [[nodiscard]] constexpr auto valid() const noexcept -> bool {
+    return index != std::numeric_limits<std::uint32_t>::max();
+  }
+};
+
+// =============================================================================
+/// zbvh
+// =============================================================================
+
+/// @class  zbvh
+/// @brief  Static Bounding Volume Hierarchy over Line Segments
+/// @tparam LocationT: zspatial location (zlocation, vlocation, std::array)
+/// @tparam DimensionN: number of coordinates (deduced where possible)
+/// @note   Segment indices follow input order: for polylines, segment k joins
+///         vertex k + p and k + p + 1 of polyline p
+template <zdetail::zspatial LocationT,
+          std::size_t      DimensionN = zdetail::zdimension_v<LocationT>>
+class zbvh {
+public:
+  using location_type  = LocationT;
+  using value_type     = zdetail::zcoordinate_t<LocationT>;
+  using size_type      = std::size_t;
+  using index_type     = std::uint32_t;
+  using point_type     = std::array<value_type, DimensionN>;
+  using segment_type   = std::array<point_type, 2>;
+  using neighbour_type = zneighbour<value_type>;
+  using hit_type       = zray_hit<value_type>;
+  using pair_type      = std::pair<index_type, index_type>;
+
+  static constexpr size_type k_leaf = 4;
+  static constexpr size_type k_bins = 16;
+
+  static constexpr index_type k_none = std::numeric_limits<index_type>::max();
+
+private:
+  /// @brief Leaf if count > 0 (segments [offset, offset + count)), otherwise
+  ///        interior with left child at this + 1 and right child at offset
+  struct node {
+    point_type lower;
+    point_type upper;
+    index_type offset{0};
+    index_type count{0};
+  };
+
+public:
+  zbvh() = default;
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Build over Independent Segments (pairs of end points)
+  auto build(std::span<std::pair<LocationT, LocationT> const> i_segment)
+      -> void {
+    std::vector<segment_type> segment(i_segment.size());
+    for (size_type s = 0; s < i_segment.size(); ++s)
+      segment[s] = {point_of(i_segment[s].first),
+                    point_of(i_segment[s].second)};
+
+    m_polyline.assign(segment.size(), k_none);
+    assemble(std::move(segment));
+  }
+
+  /// @brief Build over Polylines
+  /// @param i_vertex: vertices of all polylines, one after the other
+  /// @param i_offset: polyline p owns i_vertex[i_offset[p]] to
+  ///                  i_vertex[i_offset[p + 1]] (exclusive)
+  auto build(std::span<LocationT const> i_vertex,
+             std::span<size_type const> i_offset) -> void {
+    std::vector<segment_type> segment;
+    m_polyline.clear();
+
+    for (size_type p = 0; p + 1 < i_offset.size(); ++p) {
+      for (size_type v = i_offset[p]; v + 1 < i_offset[p + 1]; ++v) {
+        segment.push_back({point_of(i_vertex[v]), point_of(i_vertex[v + 1])});
+        m_polyline.push_back(static_cast<index_type>(p));
+      }
+    }
+
+    assemble(std::move(segment));
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Nearest Segment to a Point (best-first traversal)
+  template <zdetail::zspatial QueryT>
+  [[nodiscard]] auto nearest(QueryT const& i_query) const -> neighbour_type {
+    neighbour_type best;
+    if (m_node.empty())
+      return best;
+
+    auto const q = point_of(i_query);
+
+    using entry = std::pair<value_type, index_type>;
+    std::priority_queue<entry, std::vector<entry>, std::greater<>> open;
+    open.emplace(box_distance_squared(m_node[0], q), 0);
+
+    while (!open.empty()) {
+      auto const [bound, n] = open.top();
+      open.pop();
+
+      if (bound >= best.distance_squared)
+        break;
+
+      auto const& here = m_node[n];
+      if (here.count > 0) {
+        for (index_type s = here.offset; s < here.offset + here.count; ++s) {
+          auto const d2 = point_segment_squared(q, m_segment[s]);
+          if (d2 < best.distance_squared)
+            best = {m_index[s], d2};
+        }
+      } else {
+        open.emplace(box_distance_squared(m_node[n + 1], q), n + 1);
+        open.emplace(box_distance_squared(m_node[here.offset], q),
+                     here.offset);
+      }
+    }
+
+    return best;
+  }
+
+  /// @brief Batched Nearest Segment across Threads
+  template <zdetail::zspatial QueryT>
+  auto nearest(std::span<QueryT const>   i_query,
+               std::span<neighbour_type> o_neighbour,
+               size_type                 i_threads = 0) const -> void {
+    assert(o_neighbour.size() >= i_query.size());
+
+    zdetail::zparallel_for(i_query.size(), i_threads,
+                           [&](size_type, size_type begin, size_type end) {
+                             for (size_type q = begin; q < end; ++q)
+                               o_neighbour[q] = nearest(i_query[q]);
+                           });
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Visit each Segment Intersecting [a, b]: f(index)
+  /// @param i_tolerance: closest approach counted as contact
+  template <zdetail::zspatial QueryT, std::invocable<index_type> FunctionF>
+  auto intersect(QueryT const& a, QueryT const& b, FunctionF&& i_function,
+                 value_type i_tolerance = value_type{0}) const -> void {
+    segment_type const query{point_of(a), point_of(b)};
+    overlap(query, i_tolerance, [&](index_type s) {
+      if (touches(query, m_segment[s], i_tolerance))
+        i_function(m_index[s]);
+    });
+  }
+
+  /// @brief  All Intersecting Pairs (i < j) within the Indexed Segments
+  /// @note   Segments of the same polyline sharing a vertex (consecutive or
+  ///         closing a loop) are not reported; shared vertices between
+  ///         different polylines (junctions) are
+  [[nodiscard]] auto intersections(value_type i_tolerance = value_type{0},
+                                   size_type  i_threads   = 0) const
+      -> std::vector<pair_type> {
+    auto const n      = m_segment.size();
+    auto const blocks = zdetail::zblocks(n, i_threads);
+
+    std::vector<std::vector<pair_type>> found(blocks);
+
+    zdetail::zparallel_for(
+        n, i_threads, [&](size_type block, size_type begin, size_type end) {
+          for (size_type s = begin; s < end; ++s) {
+            auto const i = m_index[s];
+            overlap(m_segment[s], i_tolerance, [&](index_type t) {
+              auto const j = m_index[t];
+              if (j <= i || adjacent(s, t))
+                return;
+              if (touches(m_segment[s], m_segment[t], i_tolerance))
+                found[block].emplace_back(i, j);
+            });
+          }
+        });
+
+    std::vector<pair_type> pair;
+    for (auto const& f : found)
+      pair.insert(pair.end(), f.begin(), f.end());
+    std::ranges::sort(pair);
+
+    return pair;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief First Segment Hit by the Ray origin + t * direction, t in [0, t_max]
+  template <zdetail::zspatial QueryT>
+    requires(DimensionN == 2)
+  [[nodiscard]] auto raycast(QueryT const& i_origin, QueryT const& i_direction,
+                             value_type i_maximum =
+                                 std::numeric_limits<value_type>::max()) const
+      -> hit_type {
+    hit_type hit;
+    hit.parameter = i_maximum;
+
+    if (m_node.empty())
+      return hit;
+
+    auto const o = point_of(i_origin);
+    auto const r = point_of(i_direction);
+
+    point_type inverse;
+    for (size_type d = 0; d < DimensionN; ++d)
+      inverse[d] = value_type{1} / r[d];
+
+    std::vector<index_type> stack{0};
+    while (!stack.empty()) {
+      auto const n = stack.back();
+      stack.pop_back();
+
+      auto const& here = m_node[n];
+      if (!slab(here, o, inverse, hit.parameter))
+        continue;
+
+      if (here.count > 0) {
+        for (index_type s = here.offset; s < here.offset + here.count; ++s) {
+          auto const t = ray_segment(o, r, m_segment[s]);
+          if (t >= value_type{0} && t <= hit.parameter)
+            hit = {m_index[s], t};
+        }
+      } else {
+        stack.push_back(here.offset);
+        stack.push_back(n + 1);
+      }
+    }
+
+    return hit;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_segment.size();
+  }
+
+  [[nodiscard]] auto nodes() const noexcept -> size_type {
+    return m_node.size();
+  }
+
+  /// @brief Polyline Owning a Segment (k_none for independent segments)
+  [[nodiscard]] auto polyline(index_type i_segment) const -> index_type {
+    return m_polyline[i_segment];
+  }
+
+private:
+  template <zdetail::zspatial QueryT>
+  [[nodiscard]] static auto point_of(QueryT const& i_query) -> point_type {
+    point_type p;
+    for (size_type d = 0; d < DimensionN; ++d)
+      p[d] = static_cast<value_type>(zdetail::zcoordinate(i_query, d));
+    return p;
+  }
+
+  [[nodiscard]] static auto dot(point_type const& a, point_type const& b)
+      -> value_type {
+    value_type s{0};
+    for (size_type d = 0; d < DimensionN; ++d)
+      s += a[d] * b[d];
+    return s;
+  }
+
+  [[nodiscard]] static auto difference(point_type const& a,
+                                       point_type const& b) -> point_type {
+    point_type c;
+    for (size_type d = 0; d < DimensionN; ++d)
+      c[d] = a[d] - b[d];
+    return c;
+  }
+
+  /// @brief Surface Measure of a Box (half perimeter in two dimensions)
+  [[nodiscard]] static auto surface(point_type const& i_lower,
+                                    point_type const& i_upper) -> value_type {
+    if constexpr (DimensionN == 1)
+      return i_upper[0] - i_lower[0];
+
+    value_type area{0};
+    for (size_type d = 0; d < DimensionN; ++d) {
+      value_type face{1};
+      for (size_type e = 0; e < DimensionN; ++e)
+        if (e != d)
+          face *= std::max(value_type{0}, i_upper[e] - i_lower[e]);
+      area += face;
+    }
+    return area;
+  }
+
+  static auto enclose(point_type& io_lower, point_type& io_upper,
+                      point_type const& i_point) -> void {
+    for (size_type d = 0; d < DimensionN; ++d) {
+      io_lower[d] = std::min(io_lower[d], i_point[d]);
+      io_upper[d] = std::max(io_upper[d], i_point[d]);
+    }
+  }
+
+  static auto empty_box(point_type& o_lower, point_type& o_upper) -> void {
+    o_lower.fill(std::numeric_limits<value_type>::max());
+    o_upper.fill(std::numeric_limits<value_type>::lowest());
+  }
+
+  // ---------------------------------------------------------------------------
+
+  auto assemble(std::vector<segment_type> i_segment) -> void {
+    assert(i_segment.size() < k_none);
+
+    auto const n = i_segment.size();
+
+    m_index.resize(n);
+    for (size_type s = 0; s < n; ++s)
+      m_index[s] = static_cast<index_type>(s);
+
+    m_centre.resize(n);
+    for (size_type s = 0; s < n; ++s)
+      for (size_type d = 0; d < DimensionN; ++d)
+        m_centre[s][d] = (i_segment[s][0][d] + i_segment[s][1][d]) / 2;
+
+    m_node.clear();
+    m_node.reserve(n > 0 ? 2 * n : 0);
+    if (n > 0)
+      subdivide(i_segment, 0, n);
+
+    m_segment.resize(n);
+    for (size_type s = 0; s < n; ++s)
+      m_segment[s] = i_segment[m_index[s]];
+
+    m_centre.clear();
+    m_centre.shrink_to_fit();
+  }
+
+  /// @brief Binned SAH Split of m_index[begin, end) (returns node index)
+  auto subdivide(std::vector<segment_type> const& i_segment, size_type begin,
+                 size_type end) -> index_type {
+    auto const n = static_cast<index_type>(m_node.size());
+    m_node.emplace_back();
+
+    point_type lower, upper, centre_lower, centre_upper;
+    empty_box(lower, upper);
+    empty_box(centre_lower, centre_upper);
+
+    for (size_type i = begin; i < end; ++i) {
+      enclose(lower, upper, i_segment[m_index[i]][0]);
+      enclose(lower, upper, i_segment[m_index[i]][1]);
+      enclose(centre_lower, centre_upper, m_centre[m_index[i]]);
+    }
+
+    m_node[n].lower = lower;
+    m_node[n].upper = upper;
+
+    auto const count = end - begin;
+
+    size_type axis{0};
+    for (size_type d = 1; d < DimensionN; ++d)
+      if (centre_upper[d] - centre_lower[d] >
+          centre_upper[axis] - centre_lower[axis])
+        axis = d;
+
+    auto const spread = centre_upper[axis] - centre_lower[axis];
+
+    auto const make_leaf = [&] {
+      m_node[n].offset = static_cast<index_type>(begin);
+      m_node[n].count  = static_cast<index_type>(count);
+      return n;
+    };
+
+    if (count <= k_leaf || !(spread > value_type{0}))
+      return make_leaf();
+
+    // bin centroids along the axis and sweep for the cheapest split
+    auto const bin_of = [&](index_type s) {
+      auto const b = static_cast<size_type>(
+          (m_centre[s][axis] - centre_lower[axis]) / spread * k_bins);
+      return std::min(b, k_bins - 1);
+    };
+
+    std::array<size_type, k_bins>  bin_count{};
+    std::array<point_type, k_bins> bin_lower, bin_upper;
+    for (size_type b = 0; b < k_bins; ++b)
+      empty_box(bin_lower[b], bin_upper[b]);
+
+    for (size_type i = begin; i < end; ++i) {
+      auto const s = m_index[i];
+      auto const b = bin_of(s);
+      ++bin_count[b];
+      enclose(bin_lower[b], bin_upper[b], i_segment[s][0]);
+      enclose(bin_lower[b], bin_upper[b], i_segment[s][1]);
+    }
+
+    std::array<value_type, k_bins - 1> left_cost;
+    {
+      point_type l, u;
+      empty_box(l, u);
+      size_type c{0};
+      for (size_type b = 0; b + 1 < k_bins; ++b) {
+        c += bin_count[b];
+        if (bin_count[b] > 0) {
+          enclose(l, u, bin_lower[b]);
+          enclose(l, u, bin_upper[b]);
+        }
+        left_cost[b] = c > 0 ? surface(l, u) * static_cast<value_type>(c)
+                             : value_type{0};
+      }
+    }
+
+    size_type  split{0};
+    value_type best = std::numeric_limits<value_type>::max();
+    {
+      point_type l, u;
+      empty_box(l, u);
+      size_type c{0};
+      for (size_type b = k_bins - 1; b > 0; --b) {
+        c += bin_count[b];
+        if (bin_count[b] > 0) {
+          enclose(l, u, bin_lower[b]);
+          enclose(l, u, bin_upper[b]);
+        }
+        auto const cost =
+            left_cost[b - 1] +
+            (c > 0 ? surface(l, u) * static_cast<value_type>(c) : value_type{0});
+        if (cost < best) {
+          best  = cost;
+          split = b;
+        }
+      }
+    }
+
+    auto const middle = std::partition(
+        m_index.begin() + begin, m_index.begin() + end,
+        [&](index_type s) { return bin_of(s) < split; });
+
+    auto mid = static_cast<size_type>(middle - m_index.begin());
+    if (mid == begin || mid == end) {
+      mid = begin + count / 2;
+      std::nth_element(m_index.begin() + begin, m_index.begin() + mid,
+                       m_index.begin() + end, [&](index_type a, index_type b) {
+                         return m_centre[a][axis] < m_centre[b][axis];
+                       });
+    }
+
+    subdivide(i_segment, begin, mid);
+    auto const right = subdivide(i_segment, mid, end);
+    m_node[n].offset = right;
+    m_node[n].count  = 0;
+
+    return n;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  [[nodiscard]] static auto box_distance_squared(node const&       i_node,
+                                                 point_type const& q)
+      -> value_type {
+    value_type r2{0};
+    for (size_type d = 0; d < DimensionN; ++d) {
+      auto const e = std::max({i_node.lower[d] - q[d], value_type{0},
+                               q[d] - i_node.upper[d]});
+      r2 += e * e;
+    }
+    return r2;
+  }
+
+  /// @brief Visit each Stored Segment whose Box Overlaps the Segment's Box
+  template <typename FunctionF>
+  auto overlap(segment_type const& i_query, value_type i_tolerance,
+               FunctionF&& i_function) const -> void {
+    if (m_node.empty())
+      return;
+
+    point_type lower, upper;
+    empty_box(lower, upper);
+    enclose(lower, upper, i_query[0]);
+    enclose(lower, upper, i_query[1]);
+    for (size_type d = 0; d < DimensionN; ++d) {
+      lower[d] -= i_tolerance;
+      upper[d] += i_tolerance;
+    }
+
+    auto const disjoint = [&](node const& i_node) {
+      for (size_type d = 0; d < DimensionN; ++d)
+        if (i_node.upper[d] < lower[d] || i_node.lower[d] > upper[d])
+          return true;
+      return false;
+    };
+
+    std::vector<index_type> stack{0};
+    while (!stack.empty()) {
+      auto const n = stack.back();
+      stack.pop_back();
+
+      auto const& here = m_node[n];
+      if (disjoint(here))
+        continue;
+
+      if (here.count > 0) {
+        for (index_type s = here.offset; s < here.offset + here.count; ++s)
+          i_function(s);
+      } else {
+        stack.push_back(here.offset);
+        stack.push_back(n + 1);
+      }
+    }
+  }
+
+  /// @brief Segments of one Polyline Sharing a Vertex (stored positions)
+  [[nodiscard]] auto adjacent(index_type s, index_type t) const -> bool {
+    auto const p = m_polyline[m_index[s]];
+    if (p == k_none || p != m_polyline[m_index[t]])
+      return false;
+
+    auto const& a = m_segment[s];
+    auto const& b = m_segment[t];
+    return a[0] == b[0] || a[0] == b[1] || a[1] == b[0] || a[1] == b[1];
+  }
+
+  // ---------------------------------------------------------------------------
+
+  [[nodiscard]] static auto point_segment_squared(point_type const&   q,
+                                                  segment_type const& s)
+      -> value_type {
+    auto const ab = difference(s[1], s[0]);
+    auto const aq = difference(q, s[0]);
+    auto const l2 = dot(ab, ab);
+
+    auto t = l2 > value_type{0} ? dot(aq, ab) / l2 : value_type{0};
+    t      = std::clamp(t, value_type{0}, value_type{1});
+
+    value_type r2{0};
+    for (size_type d = 0; d < DimensionN; ++d) {
+      auto const e = aq[d] - t * ab[d];
+      r2 += e * e;
+    }
+    return r2;
+  }
+
+  /// @brief Squared Closest Approach of two Segments (any dimension)
+  [[nodiscard]] static auto segment_segment_squared(segment_type const& a,
+                                                    segment_type const& b)
+      -> value_type {
+    auto const u  = difference(a[1], a[0]);
+    auto const v  = difference(b[1], b[0]);
+    auto const w  = difference(a[0], b[0]);
+    auto const uu = dot(u, u), uv = dot(u, v), vv = dot(v, v);
+    auto const uw = dot(u, w), vw = dot(v, w);
+
+    value_type s{0}, t{0};
+    auto const det = uu * vv - uv * uv;
+
+    if (det > std::numeric_limits<value_type>::epsilon() * uu * vv)
+      s = std::clamp((uv * vw - vv * uw) / det, value_type{0}, value_type{1});
+
+    t = vv > value_type{0} ? (uv * s + vw) / vv : value_type{0};
+    if (t < value_type{0} || t > value_type{1}) {
+      t = std::clamp(t, value_type{0}, value_type{1});
+      s = uu > value_type{0}
+              ? std::clamp((uv * t - uw) / uu, value_type{0}, value_type{1})
+              : value_type{0};
+    }
+
+    value_type r2{0};
+    for (size_type d = 0; d < DimensionN; ++d) {
+      auto const e = w[d] + s * u[d] - t * v[d];
+      r2 += e * e;
+    }
+    return r2;
+  }
+
+  [[nodiscard]] static auto orientation(point_type const& a,
+                                        point_type const& b,
+                                        point_type const& c) -> value_type {
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+  }
+
+  [[nodiscard]] static auto within(point_type const& a, point_type const& b,
+                                   point_type const& c) -> bool {
+    return std::min(a[0], b[0]) <= c[0] && c[0] <= std::max(a[0], b[0]) &&
+           std::min(a[1], b[1]) <= c[1] && c[1] <= std::max(a[1], b[1]);
+  }
+
+  /// @brief Contact Test: exact predicates in two dimensions without tolerance
+  [[nodiscard]] static auto touches(segment_type const& a,
+                                    segment_type const& b,
+                                    value_type          i_tolerance) -> bool {
+    if constexpr (DimensionN == 2) {
+      if (i_tolerance == value_type{0}) {
+        auto const o1 = orientation(a[0], a[1], b[0]);
+        auto const o2 = orientation(a[0], a[1], b[1]);
+        auto const o3 = orientation(b[0], b[1], a[0]);
+        auto const o4 = orientation(b[0], b[1], a[1]);
+
+        auto const sign = [](value_type x) {
+          return (x > value_type{0}) - (x < value_type{0});
+        };
+
+        if (sign(o1) * sign(o2) < 0 && sign(o3) * sign(o4) < 0)
+          return true;
+
+        return (o1 == value_type{0} && within(a[0], a[1], b[0])) ||
+               (o2 == value_type{0} && within(a[0], a[1], b[1])) ||
+               (o3 == value_type{0} && within(b[0], b[1], a[0])) ||
+               (o4 == value_type{0} && within(b[0], b[1], a[1]));
+      }
+    }
+    return segment_segment_squared(a, b) <= i_tolerance * i_tolerance;
+  }
+
+  /// @brief Slab Test of a Ray against a Node Box up to t_max
+  [[nodiscard]] static auto slab(node const& i_node, point_type const& o,
+                                 point_type const& i_inverse,
+                                 value_type        i_maximum) -> bool {
+    value_type enter{0}, leave{i_maximum};
+    for (size_type d = 0; d < DimensionN; ++d) {
+      auto t0 = (i_node.lower[d] - o[d]) * i_inverse[d];
+      auto t1 = (i_node.upper[d] - o[d]) * i_inverse[d];
+      if (t0 > t1)
+        std::swap(t0, t1);
+      /// @note NaN (zero direction on a box face) keeps the current bounds
+      enter = t0 > enter ? t0 : enter;
+      leave = t1 < leave ? t1 : leave;
+      if (enter > leave)
+        return false;
+    }
+    return true;
+  }
+
+  /// @brief Ray Parameter of the Crossing with a Segment (-1 if none)
+  [[nodiscard]] static auto ray_segment(point_type const&   o,
+                                        point_type const&   r,
+                                        segment_type const& s) -> value_type {
+    auto const e     = difference(s[1], s[0]);
+    auto const w     = difference(s[0], o);
+    auto const cross = r[0] * e[1] - r[1] * e[0];
+
+    if (cross == value_type{0})
+      return value_type{-1};
+
+    auto const t = (w[0] * e[1] - w[1] * e[0]) / cross;
+    auto const u = (w[0] * r[1] - w[1] * r[0]) / cross;
+
+    if (u < value_type{0} || u > value_type{1})
+      return value_type{-1};
+    return t;
+  }
+
+private:
+  std::vector<node>         m_node;
+  std::vector<segment_type> m_segment;
+  std::vector<index_type>   m_index;
+  std::vector<index_type>   m_polyline;
+  std::vector<point_type>   m_centre;
+};
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_BVH_NAMESPACE(END)
+// =============================================================================
+// =============================================================================
+
+#endif // !__Z_MICROSTRUCTURE_Z_BVH_HPP__
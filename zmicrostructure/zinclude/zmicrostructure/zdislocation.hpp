@@ -0,0 +1,455 @@
+/*******************************************************************************
+ * ZDISLOCATION
+ * -----------------------------------------------------------------------------
+ *
+ * \file       zdislocation.hpp
+ * \brief      Batched Stress Fields of Straight Edge and Screw Dislocations
+ *
+ * \code       HTTPS://GITHUB.COM/M1TE5H/MICROSTRUCTURE
+ *
+ * \author     M1TE5H
+ * \date       2022-12-31
+ * \copyright  COPYRIGHT (C) 2022--PRESENT BY M1TE5H
+ * \link       HTTPS://WWW.M1TE5H.COM
+ *
+ * \version    0.0.0
+ *
+ * =============================================================================
+ * @details Design Rationale
+ *
+ * Two-dimensional dislocation dynamics moves M straight lines (parallel to z)
+ * under the superposed stress of all the others, so every step evaluates
+ * closed-form isotropic fields of M lines at N points. The kernels here do
+ * exactly that sum, M x N, without building any tree.
+ *
+ * - Complex Form: with z = (x - x0) + i (y - y0) both characters reduce to
+ *   the sums T1 = sum 1/z and T2 = sum Im(z) / z^2 over a line and its
+ *   images; the Burgers vector only scales T1 and T2
+ * - Periodic Images: along x a whole row of images is summed in closed form
+ *   (T1 = k cot(k z), T2 = Im(z) k^2 / sin^2(k z), k = pi / L); along y the
+ *   rows of 2 shells + 1 nearest cells are added explicitly. Row fields decay
+ *   exponentially, each shell gains a factor exp(-2 pi length_y / length_x)
+ * - Layout: sources are gathered to structure-of-arrays, field points go in
+ *   tiles of k_field_tile; the inner loop runs over the tile with one source
+ *   broadcast, so it vectorises without reassociating sums
+ * - Threads: field points are split in contiguous blocks (zparallel_for) and
+ *   the result does not depend on the thread count
+ * - Self Term: a field point exactly on a line omits that line (its images
+ *   are kept), so the kernels also give the stress acting on each line
+ * - Interaction Fields: for 1e5 lines and more the stress at the lines comes
+ *   from a fast evaluator of the Cauchy sums (zfmm, zbarnes_hut) instead;
+ *   the same overloads also give the stress of centres of dilatation
+ *
+ * =============================================================================
+ * @example User Guide
+ *
+ * std::vector<point>                 line    { ... };
+ * std::vector<std::array<double, 2>> burgers { ... }; // edge: (bx, by)
+ * std::vector<point>                 sample  { ... };
+ *
+ * std::vector<double> xx(n), yy(n), xy(n), zz(n);
+ *
+ * // periodic 2 x 1 cell, shear modulus 1, Poisson ratio 0.3, all cores
+ * zedge_field(std::span{line}, std::span{burgers}, std::span{sample},
+ *             zedge_stress{xx, yy, xy, zz}, zisotropic{1., .3},
+ *             zperiodic_cell{2., 1., 3});
+ *
+ ******************************************************************************/
+
+#ifndef __Z_MICROSTRUCTURE_Z_DISLOCATION_HPP__
+#define __Z_MICROSTRUCTURE_Z_DISLOCATION_HPP__
+
+#pragma once
+
+// =============================================================================
+
+/// @note not standard/common use but convenient in this isolation code
+#ifdef Z_MICROSTRUCTURE_NAMESPACE
+
+#define Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE(TOGGLE)                       \
+  Z_MICROSTRUCTURE_NAMESPACE(TOGGLE)
+
+#else
+
+#define Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE_NAME() zmicrostructure
+#define Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE_BEGIN()                       \
+  namespace Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE_NAME() {
+#define Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE_END() }
+#define Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE(TOGGLE)                       \
+  Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE_##TOGGLE()
+
+#endif
+
+// =============================================================================
+
+// C Headers
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+// C++98/03/11/14/17 Headers
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <vector>
+
+// C++20/23 Headers
+#include <concepts>
+#include <numbers>
+#include <span>
+
+#include "zparallel.hpp"
+#include "zspatial.hpp"
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE(BEGIN)
+// =============================================================================
+// =============================================================================
+
+/// @brief Isotropic Elastic Medium
+struct zisotropic {
+  double shear_modulus{1.};
+  double poisson_ratio{.3};
+};
+
+/// @brief  Periodic Cell [0, length_x) x [0, length_y)
+/// @note   length_x = 0 is an infinite medium; length_y = 0 with length_x > 0
+///         is a single periodic row (a wall along x). Image rows along y are
+///         summed symmetrically over the nearest 2 shells + 1 cells
+struct zperiodic_cell {
+  double      length_x{0.};
+  double      length_y{0.};
+  std::size_t shells{4};
+};
+
+/// @brief Plane-Strain Stress of Edge Lines, One Entry per Field Point
+struct zedge_stress {
+  std::span<double> xx, yy, xy, zz;
+};
+
+/// @brief Antiplane Stress of Screw Lines, One Entry per Field Point
+struct zscrew_stress {
+  std::span<double> xz, yz;
+};
+
+namespace zdetail {
+
+/// @brief Field Points per Tile: the Tile Accumulators Stay in L1
+inline constexpr std::size_t k_field_tile = 256;
+
+/// @brief |2 k Im(z)| Beyond which a Row Field is Constant to Double Precision
+inline constexpr double k_row_cap = 40.;
+
+/// @brief T1 = sum 1/z and T2 = sum Im(z) / z^2 (Real and Imaginary Parts)
+struct zimage_sum {
+  double t1r{0.}, t1i{0.}, t2r{0.}, t2i{0.};
+};
+
+/// @brief Single Line; z = 0 Contributes Nothing (Branch-Free Mask)
+[[nodiscard]] inline auto zline_sum(double i_x, double i_y) -> zimage_sum {
+  auto const r2    = i_x * i_x + i_y * i_y;
+  auto const w     = r2 > 0. ? 1. : 0.;
+  auto const inv   = w / (r2 + (1. - w));
+  auto const scale = i_y * inv * inv;
+  return {i_x * inv, -i_y * inv, (i_x * i_x - i_y * i_y) * scale,
+          -2. * i_x * i_y * scale};
+}
+
+/// @brief  Rows of Images along x, Rows at y + m length_y for |m| <= shells
+/// @note   With u = 2 k x, v = 2 k y: cot(k z) = (sin u - i sinh v) / d and
+///         1 / sin^2(k z) = 2 (1 - cos u cosh v - i sin u sinh v) / d^2,
+///         d = cosh v - cos u, which vanishes only on an image itself
+[[nodiscard]] inline auto zrow_sum(double i_x, double i_y,
+                                   zperiodic_cell const& i_cell)
+    -> zimage_sum {
+  auto const k = std::numbers::pi / i_cell.length_x;
+  auto const x = i_x - i_cell.length_x * std::nearbyint(i_x / i_cell.length_x);
+  auto const sin_u = std::sin(2. * k * x);
+  auto const cos_u = std::cos(2. * k * x);
+
+  auto y      = i_y;
+  auto shells = std::ptrdiff_t{0};
+  if (i_cell.length_y > 0.) {
+    y -= i_cell.length_y * std::nearbyint(y / i_cell.length_y);
+    shells = static_cast<std::ptrdiff_t>(i_cell.shells);
+  }
+
+  zimage_sum t;
+  for (auto m = -shells; m <= shells; ++m) {
+    auto const ym    = y - static_cast<double>(m) * i_cell.length_y;
+    auto const v     = std::clamp(2. * k * ym, -k_row_cap, k_row_cap);
+    auto const ch    = std::cosh(v);
+    auto const sh    = std::sinh(v);
+    auto const d     = ch - cos_u;
+    auto const w     = d > 0. ? 1. : 0.;
+    auto const inv   = w / (d + (1. - w));
+    auto const scale = 2. * k * k * ym * inv * inv;
+    t.t1r += k * sin_u * inv;
+    t.t1i -= k * sh * inv;
+    t.t2r += scale * (1. - cos_u * ch);
+    t.t2i -= scale * sin_u * sh;
+  }
+  return t;
+}
+
+/// @brief Structure-of-Arrays Copy of Line Positions
+template <zspatial LineT>
+[[nodiscard]] auto zgather(std::span<LineT const> i_line, std::size_t i_axis)
+    -> std::vector<double> {
+  std::vector<double> c(i_line.size());
+  for (std::size_t j = 0; j < i_line.size(); ++j)
+    c[j] = static_cast<double>(zcoordinate(i_line[j], i_axis));
+  return c;
+}
+
+/// @brief  Superpose ChannelN Accumulators over all Lines at every Point
+/// @param  i_combine: f(line, zimage_sum, tile, lane) adds one line
+/// @param  i_store: f(point, tile, lane) writes the finished sums
+template <std::size_t ChannelN, zspatial PointT, typename CombineF,
+          typename StoreF>
+auto zsuperpose(std::span<double const> i_x, std::span<double const> i_y,
+                std::span<PointT const> i_point, zperiodic_cell const& i_cell,
+                std::size_t i_threads, CombineF&& i_combine, StoreF&& i_store)
+    -> void {
+  using tile_type = std::array<std::array<double, k_field_tile>, ChannelN>;
+  bool const periodic = i_cell.length_x > 0.;
+  assert(periodic || i_cell.length_y == 0.);
+
+  zparallel_for(
+      i_point.size(), i_threads,
+      [&](std::size_t, std::size_t begin, std::size_t end) {
+        std::array<double, k_field_tile> px, py;
+        tile_type                        tile;
+
+        for (auto first = begin; first < end; first += k_field_tile) {
+          auto const width = std::min(k_field_tile, end - first);
+          for (std::size_t i = 0; i < width; ++i) {
+            px[i] = static_cast<double>(zcoordinate(i_point[first + i], 0));
+            py[i] = static_cast<double>(zcoordinate(i_point[first + i], 1));
+          }
+          for (auto& channel : tile)
+            channel.fill(0.);
+
+          for (std::size_t j = 0; j < i_x.size(); ++j) {
+            auto const x = i_x[j], y = i_y[j];
+            if (periodic)
+              for (std::size_t i = 0; i < width; ++i)
+                i_combine(j, zrow_sum(px[i] - x, py[i] - y, i_cell), tile, i);
+            else
+              for (std::size_t i = 0; i < width; ++i)
+                i_combine(j, zline_sum(px[i] - x, py[i] - y), tile, i);
+          }
+
+          for (std::size_t i = 0; i < width; ++i)
+            i_store(first + i, tile, i);
+        }
+      });
+}
+
+} // namespace zdetail
+
+// =============================================================================
+/// zedge_field
+// =============================================================================
+
+/// @brief  Superposed Stress of Edge Lines (Burgers Vector (bx, by) in Plane)
+/// @param  i_line: line positions (first two coordinates)
+/// @param  i_burgers: Burgers vector of each line
+/// @param  i_point: field points (first two coordinates)
+/// @param  o_stress: sigma_xx, sigma_yy, sigma_xy and sigma_zz = nu (xx + yy)
+/// @param  i_threads: worker count (0 selects the hardware concurrency)
+/// @note   In the complex form A = mu (by - i bx) / (4 pi (1 - nu)) and
+///         xx + yy = 4 Re(A T1), yy - xx + 2i xy = 4 (i A T2 - i Im(A) T1)
+template <zdetail::zspatial LineT, zdetail::zspatial PointT>
+auto zedge_field(std::span<LineT const>                  i_line,
+                 std::span<std::array<double, 2> const>  i_burgers,
+                 std::span<PointT const>                 i_point,
+                 zedge_stress const&                     o_stress,
+                 zisotropic const&                       i_medium,
+                 zperiodic_cell const&                   i_cell    = {},
+                 std::size_t                             i_threads = 0)
+    -> void {
+  assert(i_burgers.size() == i_line.size());
+  assert(o_stress.xx.size() >= i_point.size() &&
+         o_stress.yy.size() >= i_point.size() &&
+         o_stress.xy.size() >= i_point.size() &&
+         o_stress.zz.size() >= i_point.size());
+
+  auto const x = zdetail::zgather(i_line, 0);
+  auto const y = zdetail::zgather(i_line, 1);
+  auto const a = i_medium.shear_modulus /
+                 (4. * std::numbers::pi * (1. - i_medium.poisson_ratio));
+  std::vector<double> ar(i_line.size()), ai(i_line.size());
+  for (std::size_t j = 0; j < i_line.size(); ++j) {
+    ar[j] = a * i_burgers[j][1];
+    ai[j] = -a * i_burgers[j][0];
+  }
+
+  // channels: xx + yy, yy - xx, xy
+  zdetail::zsuperpose<3>(
+      x, y, i_point, i_cell, i_threads,
+      [&](std::size_t j, zdetail::zimage_sum const& t, auto& tile,
+          std::size_t i) {
+        tile[0][i] += 4. * (ar[j] * t.t1r - ai[j] * t.t1i);
+        tile[1][i] += 4. * (ai[j] * t.t1i - ar[j] * t.t2i - ai[j] * t.t2r);
+        tile[2][i] += 2. * (ar[j] * t.t2r - ai[j] * t.t2i - ai[j] * t.t1r);
+      },
+      [&](std::size_t p, auto const& tile, std::size_t i) {
+        o_stress.xx[p] = .5 * (tile[0][i] - tile[1][i]);
+        o_stress.yy[p] = .5 * (tile[0][i] + tile[1][i]);
+        o_stress.xy[p] = tile[2][i];
+        o_stress.zz[p] = i_medium.poisson_ratio * tile[0][i];
+      });
+}
+
+// =============================================================================
+/// zscrew_field
+// =============================================================================
+
+/// @brief  Superposed Stress of Screw Lines (Burgers Vector bz along the Line)
+/// @param  o_stress: sigma_xz and sigma_yz; yz + i xz = mu bz T1 / (2 pi)
+/// @note   A mixed line is the sum of its edge and screw parts
+template <zdetail::zspatial LineT, zdetail::zspatial PointT>
+auto zscrew_field(std::span<LineT const> i_line,
+                  std::span<double const> i_burgers,
+                  std::span<PointT const> i_point,
+                  zscrew_stress const&    o_stress,
+                  zisotropic const&       i_medium,
+                  zperiodic_cell const&   i_cell    = {},
+                  std::size_t             i_threads = 0) -> void {
+  assert(i_burgers.size() == i_line.size());
+  assert(o_stress.xz.size() >= i_point.size() &&
+         o_stress.yz.size() >= i_point.size());
+
+  auto const x = zdetail::zgather(i_line, 0);
+  auto const y = zdetail::zgather(i_line, 1);
+  std::vector<double> s(i_line.size());
+  for (std::size_t j = 0; j < i_line.size(); ++j)
+    s[j] = i_medium.shear_modulus * i_burgers[j] / (2. * std::numbers::pi);
+
+  zdetail::zsuperpose<2>(
+      x, y, i_point, i_cell, i_threads,
+      [&](std::size_t j, zdetail::zimage_sum const& t, auto& tile,
+          std::size_t i) {
+        tile[0][i] += s[j] * t.t1i;
+        tile[1][i] += s[j] * t.t1r;
+      },
+      [&](std::size_t p, auto const& tile, std::size_t i) {
+        o_stress.xz[p] = tile[0][i];
+        o_stress.yz[p] = tile[1][i];
+      });
+}
+
+// =============================================================================
+/// Interaction Fields
+// =============================================================================
+
+/// @brief Evaluators of the Cauchy Sums at their own Defects (zfmm and
+///        zbarnes_hut)
+/// @note  evaluate(q, f, f', threads): f = sum q / (z - z_j), f' = d f / dz
+template <typename EvaluatorT>
+concept zcauchy_evaluator =
+    requires(EvaluatorT const e, std::span<std::complex<double> const> q,
+             std::span<std::complex<double>> f, std::size_t t) {
+      { e.size() } -> std::convertible_to<std::size_t>;
+      {
+        e.location()
+      } -> std::convertible_to<std::span<std::complex<double> const>>;
+      e.evaluate(q, f, f, t);
+    };
+
+/// @brief  Stress at every Edge Line from all the Others (zedge_field at the
+///         Lines Themselves, Infinite Medium) through a Fast Evaluator
+/// @note   With A_j = mu (by - i bx) / (4 pi (1 - nu)) three charge sets
+///         give xx + yy = 4 Re f[A] and
+///         yy - xx + 2i xy = -4i (y f'[A] - f'[A y] + f[Im A])
+template <zcauchy_evaluator EvaluatorT>
+auto zedge_field(EvaluatorT const&                      i_evaluator,
+                 std::span<std::array<double, 2> const> i_burgers,
+                 zedge_stress const& o_stress, zisotropic const& i_medium,
+                 std::size_t i_threads = 0) -> void {
+  using complex_type = std::complex<double>;
+  auto const n       = i_evaluator.size();
+  auto const z       = std::span<complex_type const>{i_evaluator.location()};
+  assert(i_burgers.size() == n);
+
+  auto const a = i_medium.shear_modulus /
+                 (4. * std::numbers::pi * (1. - i_medium.poisson_ratio));
+  std::vector<complex_type> charge(n), imaginary(n), moment(n);
+  for (std::size_t j = 0; j < n; ++j) {
+    charge[j]    = a * complex_type{i_burgers[j][1], -i_burgers[j][0]};
+    imaginary[j] = charge[j].imag();
+    moment[j]    = charge[j] * z[j].imag();
+  }
+
+  std::vector<complex_type> f(n), g(n), h(n), k(n), unused(n);
+  i_evaluator.evaluate(charge, f, g, i_threads);
+  i_evaluator.evaluate(imaginary, h, {}, i_threads);
+  i_evaluator.evaluate(moment, unused, k, i_threads);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    auto const trace = 4. * f[i].real();
+    auto const q =
+        complex_type{0., -4.} * (z[i].imag() * g[i] - k[i] + h[i]);
+    o_stress.xx[i] = .5 * (trace - q.real());
+    o_stress.yy[i] = .5 * (trace + q.real());
+    o_stress.xy[i] = .5 * q.imag();
+    o_stress.zz[i] = i_medium.poisson_ratio * trace;
+  }
+}
+
+/// @brief Stress at every Screw Line from all the Others: yz + i xz = f[S]
+template <zcauchy_evaluator EvaluatorT>
+auto zscrew_field(EvaluatorT const& i_evaluator,
+                  std::span<double const> i_burgers,
+                  zscrew_stress const& o_stress, zisotropic const& i_medium,
+                  std::size_t i_threads = 0) -> void {
+  using complex_type = std::complex<double>;
+  auto const n       = i_evaluator.size();
+  assert(i_burgers.size() == n);
+
+  std::vector<complex_type> charge(n), f(n);
+  for (std::size_t j = 0; j < n; ++j)
+    charge[j] = i_medium.shear_modulus * i_burgers[j] / (2. * std::numbers::pi);
+  i_evaluator.evaluate(charge, f, {}, i_threads);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    o_stress.xz[i] = f[i].imag();
+    o_stress.yz[i] = f[i].real();
+  }
+}
+
+/// @brief  Stress at every Point Defect from all the Others
+/// @param  i_strength: dilatation centre strength C (displacement C r / r^2)
+/// @note   xx + yy = 0 and yy - xx + 2i xy = -4 mu f'[C] in plane strain;
+///         o_stress.zz is written as zero
+template <zcauchy_evaluator EvaluatorT>
+auto zdilatation_field(EvaluatorT const&       i_evaluator,
+                       std::span<double const> i_strength,
+                       zedge_stress const& o_stress, zisotropic const& i_medium,
+                       std::size_t i_threads = 0) -> void {
+  using complex_type = std::complex<double>;
+  auto const n       = i_evaluator.size();
+  assert(i_strength.size() == n);
+
+  std::vector<complex_type> charge(i_strength.begin(), i_strength.end()), f(n),
+      g(n);
+  i_evaluator.evaluate(charge, f, g, i_threads);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    auto const q   = -4. * i_medium.shear_modulus * g[i];
+    o_stress.xx[i] = -.5 * q.real();
+    o_stress.yy[i] = .5 * q.real();
+    o_stress.xy[i] = .5 * q.imag();
+    o_stress.zz[i] = 0.;
+  }
+}
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_DISLOCATION_NAMESPACE(END)
+// =============================================================================
+// =============================================================================
+
+#endif // !__Z_MICROSTRUCTURE_Z_DISLOCATION_HPP__
@@ -0,0 +1,430 @@
+/*******************************************************************************
+ * ZKDTREE
+ * -----------------------------------------------------------------------------
+ *
+ * \file       zkdtree.hpp
+ * \brief      Static Implicit k-d Tree for Nearest, Radius and Box Queries
+ *
+ * \code       HTTPS://GITHUB.COM/M1TE5H/MICROSTRUCTURE
+ *
+ * \author     M1TE5H
+ * \date       2022-12-31
+ * \copyright  COPYRIGHT (C) 2022--PRESENT BY M1TE5H
+ * \link       HTTPS://WWW.M1TE5H.COM
+ *
+ * \version    0.0.0
+ *
+ * =============================================================================
+ * @details Design Rationale
+ *
+ * Post-processing asks for the nearest grain seed or precipitate of millions
+ * of sample points. The \b zkdtree is built once over the reference locations
+ * and then answers queries in O(log n) instead of a linear scan.
+ *
+ * - Implicit Layout: no node objects; the subtree over [lo, hi) is split at
+ *   mid = (lo + hi) / 2 so the tree is the permuted coordinate array itself
+ * - Split Axis: largest spread of the range, kept in one byte per node
+ * - Leaves: ranges of at most k_leaf locations are scanned linearly
+ * - Batches: query spans are split in contiguous blocks across threads
+ *
+ * =============================================================================
+ * @example User Guide
+ *
+ * std::vector<point> seed { ... };
+ * std::vector<point> sample { ... };
+ *
+ * zkdtree<point> tree { seed };
+ *
+ * // nearest seed of every sample on all cores
+ * std::vector<zneighbour<float>> grain(sample.size());
+ * tree.nearest(std::span{sample}, std::span{grain}, 1);
+ *
+ ******************************************************************************/
+
+#ifndef __Z_MICROSTRUCTURE_Z_KDTREE_HPP__
+#define __Z_MICROSTRUCTURE_Z_KDTREE_HPP__
+
+#pragma once
+
+// =============================================================================
+
+/// @note not standard/common use but convenient in this isolation code
+#ifdef Z_MICROSTRUCTURE_NAMESPACE
+
+#define Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE(TOGGLE)                            \
+  Z_MICROSTRUCTURE_NAMESPACE(TOGGLE)
+
+#else
+
+#define Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE_NAME() zmicrostructure
+#define Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE_BEGIN()                            \
+  namespace Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE_NAME() {
+#define Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE_END() }
+#define Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE(TOGGLE)                            \
+  Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE_##TOGGLE()
+
+#endif
+
+// =============================================================================
+
+// C Headers
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// C++98/03/11/14/17 Headers
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+// C++20/23 Headers
+#include <concepts>
+#include <span>
+
+#include "zparallel.hpp"
+#include "zspatial.hpp"
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE(BEGIN)
+// =============================================================================
+// =============================================================================
+
+// =============================================================================
+/// zkdtree
+// =============================================================================
+
+/// @class  zkdtree
+/// @brief  Static Array-Embedded k-d Tree
+/// @tparam LocationT: zspatial location (zlocation, vlocation, std::array)
+/// @tparam DimensionN: number of coordinates (deduced where possible)
+/// @note   Indices returned by queries refer to the span given on build
+template <zdetail::zspatial LocationT,
+          std::size_t      DimensionN = zdetail::zdimension_v<LocationT>>
+class zkdtree {
+public:
+  using location_type  = LocationT;
+  using value_type     = zdetail::zcoordinate_t<LocationT>;
+  using size_type      = std::size_t;
+  using index_type     = std::uint32_t;
+  using point_type     = std::array<value_type, DimensionN>;
+  using neighbour_type = zneighbour<value_type>;
+
+  static constexpr size_type k_leaf = 8;
+
+public:
+  zkdtree() = default;
+
+  explicit zkdtree(std::span<LocationT const> i_location) { build(i_location); }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief (Re)Build over a Span of Locations in O(n log n)
+  auto build(std::span<LocationT const> i_location) -> void {
+    assert(i_location.size() < std::numeric_limits<index_type>::max());
+
+    auto const n = i_location.size();
+
+    std::vector<point_type> source(n);
+    for (size_type i = 0; i < n; ++i)
+      source[i] = point_of(i_location[i]);
+
+    m_index.resize(n);
+    std::iota(m_index.begin(), m_index.end(), index_type{0});
+    m_axis.assign(n, 0);
+
+    partition(source, 0, n);
+
+    m_point.resize(n);
+    for (size_type i = 0; i < n; ++i)
+      m_point[i] = source[m_index[i]];
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Nearest Location
+  template <zdetail::zspatial QueryT>
+  [[nodiscard]] auto nearest(QueryT const& i_query) const -> neighbour_type {
+    neighbour_type best;
+    nearest(i_query, std::span<neighbour_type>{&best, 1});
+    return best;
+  }
+
+  /// @brief  k Nearest Locations, k = o_neighbour.size()
+  /// @return number of neighbours written (sorted by ascending distance)
+  template <zdetail::zspatial QueryT>
+  auto nearest(QueryT const& i_query, std::span<neighbour_type> o_neighbour)
+      const -> size_type {
+    if (o_neighbour.empty() || m_point.empty())
+      return 0;
+
+    auto const q = point_of(i_query);
+
+    size_type found{0};
+    nearest_range(0, m_point.size(), q, o_neighbour, found);
+    std::sort_heap(o_neighbour.begin(), o_neighbour.begin() + found);
+
+    return found;
+  }
+
+  /// @brief Visit each Location within a Radius: f(index, distance_squared)
+  template <zdetail::zspatial QueryT,
+            std::invocable<index_type, value_type> FunctionF>
+  auto radius(QueryT const& i_query, value_type i_radius,
+              FunctionF&& i_function) const -> void {
+    radius_range(0, m_point.size(), point_of(i_query), i_radius * i_radius,
+                 i_function);
+  }
+
+  /// @brief Indices of the Locations within a Radius
+  template <zdetail::zspatial QueryT>
+  [[nodiscard]] auto radius(QueryT const& i_query, value_type i_radius) const
+      -> std::vector<index_type> {
+    std::vector<index_type> found;
+    radius(i_query, i_radius,
+           [&](index_type j, value_type) { found.push_back(j); });
+    return found;
+  }
+
+  /// @brief Visit each Location in the Closed Box [lower, upper]: f(index)
+  template <std::invocable<index_type> FunctionF>
+  auto box(point_type const& i_lower, point_type const& i_upper,
+           FunctionF&& i_function) const -> void {
+    box_range(0, m_point.size(), i_lower, i_upper, i_function);
+  }
+
+  /// @brief Indices of the Locations in the Closed Box [lower, upper]
+  [[nodiscard]] auto box(point_type const& i_lower,
+                         point_type const& i_upper) const
+      -> std::vector<index_type> {
+    std::vector<index_type> found;
+    box(i_lower, i_upper, [&](index_type j) { found.push_back(j); });
+    return found;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Batched k Nearest: row q of o_neighbour (k entries) for query q
+  /// @param i_threads: worker count (0 selects the hardware concurrency)
+  /// @note  Rows of queries with fewer than k candidates are padded with
+  ///        default (invalid index, infinite distance) entries
+  template <zdetail::zspatial QueryT>
+  auto nearest(std::span<QueryT const> i_query,
+               std::span<neighbour_type> o_neighbour, size_type i_k,
+               size_type i_threads = 0) const -> void {
+    assert(o_neighbour.size() >= i_query.size() * i_k);
+
+    zdetail::zparallel_for(
+        i_query.size(), i_threads,
+        [&](size_type, size_type begin, size_type end) {
+          for (size_type q = begin; q < end; ++q) {
+            auto row = o_neighbour.subspan(q * i_k, i_k);
+            std::fill(row.begin(), row.end(), neighbour_type{});
+            nearest(i_query[q], row);
+          }
+        });
+  }
+
+  /// @brief Batched Radius Query in Compressed Sparse Row Form
+  /// @param o_offset: query q owns o_index[o_offset[q]] to o_index[o_offset[q+1]]
+  /// @param o_index: indices within the radius, ascending per query
+  template <zdetail::zspatial QueryT>
+  auto radius(std::span<QueryT const> i_query, value_type i_radius,
+              std::vector<size_type>& o_offset,
+              std::vector<index_type>& o_index, size_type i_threads = 0) const
+      -> void {
+    auto const blocks = zdetail::zblocks(i_query.size(), i_threads);
+
+    std::vector<std::vector<index_type>> index(blocks);
+    o_offset.assign(i_query.size() + 1, 0);
+
+    zdetail::zparallel_for(
+        i_query.size(), i_threads,
+        [&](size_type b, size_type begin, size_type end) {
+          for (size_type q = begin; q < end; ++q) {
+            auto const first = index[b].size();
+            radius(i_query[q], i_radius,
+                   [&](index_type j, value_type) { index[b].push_back(j); });
+            std::sort(index[b].begin() + first, index[b].end());
+            o_offset[q + 1] = index[b].size() - first;
+          }
+        });
+
+    std::partial_sum(o_offset.begin(), o_offset.end(), o_offset.begin());
+
+    o_index.clear();
+    o_index.reserve(o_offset.back());
+    for (auto const& block : index)
+      o_index.insert(o_index.end(), block.begin(), block.end());
+  }
+
+  // ---------------------------------------------------------------------------
+
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_point.size();
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool { return m_point.empty(); }
+
+private:
+  template <zdetail::zspatial QueryT>
+  [[nodiscard]] static auto point_of(QueryT const& i_query) -> point_type {
+    point_type q;
+    for (size_type d = 0; d < DimensionN; ++d)
+      q[d] = static_cast<value_type>(zdetail::zcoordinate(i_query, d));
+    return q;
+  }
+
+  [[nodiscard]] static auto distance_squared(point_type const& a,
+                                             point_type const& b)
+      -> value_type {
+    value_type r2{0};
+    for (size_type d = 0; d < DimensionN; ++d)
+      r2 += (a[d] - b[d]) * (a[d] - b[d]);
+    return r2;
+  }
+
+  /// @brief Median Split along the Axis of Largest Spread
+  /// @note  Only the index array is permuted; coordinates are gathered once
+  auto partition(std::vector<point_type> const& i_source, size_type lo,
+                 size_type hi) -> void {
+    if (hi - lo <= k_leaf)
+      return;
+
+    point_type minimum, maximum;
+    minimum.fill(std::numeric_limits<value_type>::max());
+    maximum.fill(std::numeric_limits<value_type>::lowest());
+
+    for (size_type i = lo; i < hi; ++i) {
+      for (size_type d = 0; d < DimensionN; ++d) {
+        minimum[d] = std::min(minimum[d], i_source[m_index[i]][d]);
+        maximum[d] = std::max(maximum[d], i_source[m_index[i]][d]);
+      }
+    }
+
+    size_type axis{0};
+    for (size_type d = 1; d < DimensionN; ++d)
+      if (maximum[d] - minimum[d] > maximum[axis] - minimum[axis])
+        axis = d;
+
+    auto const mid = lo + (hi - lo) / 2;
+
+    std::nth_element(m_index.begin() + lo, m_index.begin() + mid,
+                     m_index.begin() + hi, [&](index_type a, index_type b) {
+                       return i_source[a][axis] < i_source[b][axis];
+                     });
+
+    m_axis[mid] = static_cast<std::uint8_t>(axis);
+
+    partition(i_source, lo, mid);
+    partition(i_source, mid + 1, hi);
+  }
+
+  auto offer(neighbour_type const& i_candidate,
+             std::span<neighbour_type> io_heap, size_type& io_found) const
+      -> void {
+    if (io_found < io_heap.size()) {
+      io_heap[io_found++] = i_candidate;
+      std::push_heap(io_heap.begin(), io_heap.begin() + io_found);
+    } else if (i_candidate < io_heap.front()) {
+      std::pop_heap(io_heap.begin(), io_heap.end());
+      io_heap.back() = i_candidate;
+      std::push_heap(io_heap.begin(), io_heap.end());
+    }
+  }
+
+  auto nearest_range(size_type lo, size_type hi, point_type const& q,
+                     std::span<neighbour_type> io_heap,
+                     size_type&                io_found) const -> void {
+    if (hi - lo <= k_leaf) {
+      for (size_type i = lo; i < hi; ++i)
+        offer({m_index[i], distance_squared(q, m_point[i])}, io_heap,
+              io_found);
+      return;
+    }
+
+    auto const mid  = lo + (hi - lo) / 2;
+    auto const axis = m_axis[mid];
+    auto const diff = q[axis] - m_point[mid][axis];
+
+    offer({m_index[mid], distance_squared(q, m_point[mid])}, io_heap,
+          io_found);
+
+    bool const left = diff < value_type{0};
+    nearest_range(left ? lo : mid + 1, left ? mid : hi, q, io_heap, io_found);
+
+    if (io_found < io_heap.size() ||
+        diff * diff < io_heap.front().distance_squared)
+      nearest_range(left ? mid + 1 : lo, left ? hi : mid, q, io_heap,
+                    io_found);
+  }
+
+  template <typename FunctionF>
+  auto radius_range(size_type lo, size_type hi, point_type const& q,
+                    value_type r2, FunctionF& i_function) const -> void {
+    if (hi - lo <= k_leaf) {
+      for (size_type i = lo; i < hi; ++i)
+        if (auto const d2 = distance_squared(q, m_point[i]); d2 <= r2)
+          i_function(m_index[i], d2);
+      return;
+    }
+
+    auto const mid  = lo + (hi - lo) / 2;
+    auto const axis = m_axis[mid];
+    auto const diff = q[axis] - m_point[mid][axis];
+
+    if (auto const d2 = distance_squared(q, m_point[mid]); d2 <= r2)
+      i_function(m_index[mid], d2);
+
+    if (diff <= value_type{0} || diff * diff <= r2)
+      radius_range(lo, mid, q, r2, i_function);
+    if (diff >= value_type{0} || diff * diff <= r2)
+      radius_range(mid + 1, hi, q, r2, i_function);
+  }
+
+  template <typename FunctionF>
+  auto box_range(size_type lo, size_type hi, point_type const& i_lower,
+                 point_type const& i_upper, FunctionF& i_function) const
+      -> void {
+    auto const inside = [&](point_type const& p) {
+      for (size_type d = 0; d < DimensionN; ++d)
+        if (p[d] < i_lower[d] || p[d] > i_upper[d])
+          return false;
+      return true;
+    };
+
+    if (hi - lo <= k_leaf) {
+      for (size_type i = lo; i < hi; ++i)
+        if (inside(m_point[i]))
+          i_function(m_index[i]);
+      return;
+    }
+
+    auto const mid  = lo + (hi - lo) / 2;
+    auto const axis = m_axis[mid];
+    auto const cut  = m_point[mid][axis];
+
+    if (inside(m_point[mid]))
+      i_function(m_index[mid]);
+
+    if (i_lower[axis] <= cut)
+      box_range(lo, mid, i_lower, i_upper, i_function);
+    if (i_upper[axis] >= cut)
+      box_range(mid + 1, hi, i_lower, i_upper, i_function);
+  }
+
+private:
+  std::vector<point_type>   m_point;
+  std::vector<index_type>   m_index;
+  std::vector<std::uint8_t> m_axis;
+};
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_KDTREE_NAMESPACE(END)
+// =============================================================================
+// =============================================================================
+
+#endif // !__Z_MICROSTRUCTURE_Z_KDTREE_HPP__
@@ -128,6 +128,13 @@
 
 // Local Headers
 #include "zlocation.hpp"
+#include "zspatial.hpp"
+#include "zparallel.hpp"
+#include "zkdtree.hpp"
+#include "zbvh.hpp"
+#include "zdislocation.hpp"
+#include "zfmm.hpp"
+#include "zbarnes_hut.hpp"
 
 /*******************************************************************************
  * \subsection MACROS
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * ZPARALLEL
+ * -----------------------------------------------------------------------------
+ *
+ * \file       zparallel.hpp
+ * \brief      Static Block Partitioning of Index Ranges across Threads
+ *
+ * \code       HTTPS://GITHUB.COM/M1TE5H/MICROSTRUCTURE
+ *
+ * \author     M1TE5H
+ * \date       2022-12-31
+ * \copyright  COPYRIGHT (C) 2022--PRESENT BY M1TE5H
+ * \link       HTTPS://WWW.M1TE5H.COM
+ *
+ * \version    0.0.0
+ *
+ * =============================================================================
+ * @details Design Rationale
+ *
+ * Batched kernels (queries, field evaluations) split [0, n) into contiguous
+ * blocks, one per thread, so that each thread streams through its own slice
+ * of the input and output. The calling thread processes the first block.
+ * Sorting (Morton keys of rebuilt trees) uses the same blocks: each block is
+ * sorted by its thread, then neighbouring blocks are merged in rounds.
+ *
+ * @todo Work stealing for irregular per-item costs
+ *
+ ******************************************************************************/
+
+#ifndef __Z_MICROSTRUCTURE_Z_PARALLEL_HPP__
+#define __Z_MICROSTRUCTURE_Z_PARALLEL_HPP__
+
+#pragma once
+
+// =============================================================================
+
+/// @note not standard/common use but convenient in this isolation code
+#ifdef Z_MICROSTRUCTURE_NAMESPACE
+
+#define Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE(TOGGLE)                          \
+  Z_MICROSTRUCTURE_NAMESPACE(TOGGLE)
+
+#else
+
+#define Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE_NAME() zmicrostructure
+#define Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE_BEGIN()                          \
+  namespace Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE_NAME() {
+#define Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE_END() }
+#define Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE(TOGGLE)                          \
+  Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE_##TOGGLE()
+
+#endif
+
+// =============================================================================
+
+// C Headers
+#include <cstddef>
+
+// C++98/03/11/14/17 Headers
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+// C++20/23 Headers
+#include <concepts>
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE(BEGIN)
+// =============================================================================
+// =============================================================================
+
+namespace zdetail {
+
+/// @brief Requested Thread Count (0 selects the hardware concurrency)
+[[nodiscard]] inline auto zconcurrency(std::size_t i_threads) -> std::size_t {
+  if (i_threads > 0)
+    return i_threads;
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+/// @brief Number of Blocks zparallel_for will use for a Range
+[[nodiscard]] inline auto zblocks(std::size_t i_count, std::size_t i_threads)
+    -> std::size_t {
+  return std::max<std::size_t>(1,
+                               std::min(zconcurrency(i_threads), i_count));
+}
+
+/// @brief  Invoke f(block, begin, end) on Contiguous Blocks of [0, count)
+/// @note   Blocks are numbered 0 to zblocks(count, threads) - 1 so callers
+///         may keep one scratch buffer per block
+template <std::invocable<std::size_t, std::size_t, std::size_t> FunctionF>
+auto zparallel_for(std::size_t i_count, std::size_t i_threads,
+                   FunctionF&& i_function) -> void {
+  auto const blocks = zblocks(i_count, i_threads);
+
+  if (blocks == 1) {
+    i_function(std::size_t{0}, std::size_t{0}, i_count);
+    return;
+  }
+
+  auto const chunk = (i_count + blocks - 1) / blocks;
+
+  std::vector<std::jthread> worker;
+  worker.reserve(blocks - 1);
+
+  for (std::size_t b = 1; b < blocks; ++b) {
+    auto const begin = std::min(b * chunk, i_count);
+    auto const end   = std::min(begin + chunk, i_count);
+    worker.emplace_back([&i_function, b, begin, end] {
+      i_function(b, begin, end);
+    });
+  }
+
+  i_function(std::size_t{0}, std::size_t{0}, std::min(chunk, i_count));
+}
+
+/// @brief  Sort [first, last): Blocks are Sorted Concurrently, then Merged
+///         Pairwise in log2(blocks) Rounds of Concurrent Merges
+template <std::random_access_iterator IteratorT,
+          typename CompareF = std::ranges::less>
+auto zparallel_sort(IteratorT i_first, IteratorT i_last,
+                    std::size_t i_threads, CompareF i_compare = {}) -> void {
+  auto const count  = static_cast<std::size_t>(i_last - i_first);
+  auto const blocks = zblocks(count, i_threads);
+  auto const chunk  = (count + blocks - 1) / blocks;
+  auto const at     = [&](std::size_t b) {
+    return i_first + static_cast<std::iter_difference_t<IteratorT>>(
+                         std::min(b * chunk, count));
+  };
+
+  zparallel_for(blocks, blocks,
+                [&](std::size_t, std::size_t begin, std::size_t end) {
+                  for (auto b = begin; b < end; ++b)
+                    std::sort(at(b), at(b + 1), i_compare);
+                });
+
+  for (std::size_t width = 1; width < blocks; width *= 2) {
+    auto const pairs = (blocks + 2 * width - 1) / (2 * width);
+    zparallel_for(pairs, pairs,
+                  [&](std::size_t, std::size_t begin, std::size_t end) {
+                    for (auto k = begin; k < end; ++k) {
+                      auto const lo = 2 * k * width;
+                      std::inplace_merge(at(lo),
+                                         at(std::min(lo + width, blocks)),
+                                         at(std::min(lo + 2 * width, blocks)),
+                                         i_compare);
+                    }
+                  });
+  }
+}
+
+} // namespace zdetail
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_PARALLEL_NAMESPACE(END)
+// =============================================================================
+// =============================================================================
+
+#endif // !__Z_MICROSTRUCTURE_Z_PARALLEL_HPP__
@@ -0,0 +1,607 @@
+/*******************************************************************************
+ * ZSPATIAL
+ * -----------------------------------------------------------------------------
+ *
+ * \file       zspatial.hpp
+ * \brief      Spatial Indices: Cell Lists and Verlet Neighbour Lists
+ *
+ * \code       HTTPS://GITHUB.COM/M1TE5H/MICROSTRUCTURE
+ *
+ * \author     M1TE5H
+ * \date       2022-12-31
+ * \copyright  COPYRIGHT (C) 2022--PRESENT BY M1TE5H
+ * \link       HTTPS://WWW.M1TE5H.COM
+ *
+ * \version    0.0.0
+ *
+ * =============================================================================
+ * @details Design Rationale
+ *
+ * Defects (dislocation nodes, vacancies, solutes, precipitates) only interact
+ * within a finite cutoff so the pairwise search is restricted to a uniform
+ * \b zcell_list and, on top of it, a \b zverlet_list that caches the
+ * neighbourhood of every defect within cutoff plus skin.
+ *
+ * - Generalisability: any location with horizontal()/vertical() accessors
+ *   (zlocation) or with subscripts (vlocation, std::array)
+ * - Lazy Rebuild: lists are only rebuilt once the maximum displacement since
+ *   the last build exceeds half the skin
+ * - Streaming Access: neighbours are stored in compressed sparse row form
+ *   i.e. one offset array and one contiguous index array
+ *
+ * =============================================================================
+ * @example User Guide
+ *
+ * using point = std::array<float, 2>;
+ *
+ * std::vector<point> defect { ... };
+ *
+ * // cutoff 1.0, skin 0.2, periodic in both directions
+ * zverlet_list<point> verlet { {0.f, 0.f}, {64.f, 64.f}, 1.f, .2f,
+ *                              {true, true} };
+ * verlet.build(defect);
+ *
+ * for (;;) {
+ *   // ... move defects ...
+ *   verlet.update(defect); // rebuilds only when needed
+ *   for (auto j : verlet.neighbours(i)) { ... }
+ * }
+ *
+ ******************************************************************************/
+
+#ifndef __Z_MICROSTRUCTURE_Z_SPATIAL_HPP__
+#define __Z_MICROSTRUCTURE_Z_SPATIAL_HPP__
+
+#pragma once
+
+// =============================================================================
+
+/// @note not standard/common use but convenient in this isolation code
+#ifdef Z_MICROSTRUCTURE_NAMESPACE
+
+#define Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE(TOGGLE)                           \
+  Z_MICROSTRUCTURE_NAMESPACE(TOGGLE)
+
+#else
+
+#define Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE_NAME() zmicrostructure
+#define Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE_BEGIN()                           \
+  namespace Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE_NAME() {
+#define Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE_END() }
+#define Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE(TOGGLE)                           \
+  Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE_##TOGGLE()
+
+#endif
+
+// =============================================================================
+
+// C Headers
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// C++98/03/11/14/17 Headers
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// C++20/23 Headers
+#include <concepts>
+#include <span>
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE(BEGIN)
+// =============================================================================
+// =============================================================================
+
+namespace zdetail {
+
+/// @brief Two-Dimensional Locations with Named Accessors (e.g. zlocation)
+template <typename LocationT>
+concept zplanar = requires(LocationT const l) {
+                    { l.horizontal() };
+                    { l.vertical() };
+                  };
+
+/// @brief Locations with Subscripted Coordinates (e.g. vlocation, std::array)
+template <typename LocationT>
+concept zsubscriptable = requires(LocationT const l) {
+                           { l[std::size_t{}] };
+                         };
+
+template <typename LocationT>
+concept zspatial = zplanar<LocationT> || zsubscriptable<LocationT>;
+
+// -----------------------------------------------------------------------------
+
+/// @brief Number of Coordinates of a Location Type
+template <typename LocationT> struct zdimension {};
+
+template <zplanar LocationT>
+struct zdimension<LocationT> : std::integral_constant<std::size_t, 2> {};
+
+/// @note vlocation exposes its backing std::array as container
+template <typename LocationT>
+  requires(!zplanar<LocationT> &&
+           requires { std::tuple_size<typename LocationT::container>::value; })
+struct zdimension<LocationT>
+    : std::integral_constant<
+          std::size_t, std::tuple_size_v<typename LocationT::container>> {};
+
+template <typename LocationT>
+  requires(!zplanar<LocationT> &&
+           !requires { typename LocationT::container; } &&
+           requires { std::tuple_size<LocationT>::value; })
+struct zdimension<LocationT>
+    : std::integral_constant<std::size_t, std::tuple_size_v<LocationT>> {};
+
+template <typename LocationT>
+inline constexpr std::size_t zdimension_v = zdimension<LocationT>::value;
+
+// -----------------------------------------------------------------------------
+
+/// @brief Coordinate Type of a Location Type
+template <typename LocationT> struct zcoordinate_of {
+  using type =
+      std::remove_cvref_t<decltype(std::declval<LocationT const&>()[0])>;
+};
+
+template <zplanar LocationT> struct zcoordinate_of<LocationT> {
+  using type =
+      std::remove_cvref_t<decltype(std::declval<LocationT const&>()
+                                       .horizontal())>;
+};
+
+template <typename LocationT>
+using zcoordinate_t = typename zcoordinate_of<LocationT>::type;
+
+/// @brief Uniform Coordinate Access along an Axis
+template <zspatial LocationT>
+[[nodiscard]] constexpr auto zcoordinate(LocationT const& i_location,
+                                         std::size_t      i_axis)
+    -> zcoordinate_t<LocationT> {
+  if constexpr (zplanar<LocationT>)
+    return i_axis == 0 ? i_location.horizontal() : i_location.vertical();
+  else
+    return i_location[i_axis];
+}
+
+/// @brief Compile-Time Integral Power (stencil sizes)
+[[nodiscard]] constexpr auto zpower(std::size_t i_base, std::size_t i_exponent)
+    -> std::size_t {
+  std::size_t p{1};
+  while (i_exponent-- > 0)
+    p *= i_base;
+  return p;
+}
+
+/// @brief Spread the Bits of a Word to the Even Bits of a Double Word
+[[nodiscard]] constexpr auto zmorton_spread(std::uint32_t i_word)
+    -> std::uint64_t {
+  std::uint64_t m{i_word};
+  m = (m | (m << 16)) & 0x0000ffff0000ffffULL;
+  m = (m | (m << 8)) & 0x00ff00ff00ff00ffULL;
+  m = (m | (m << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  m = (m | (m << 2)) & 0x3333333333333333ULL;
+  m = (m | (m << 1)) & 0x5555555555555555ULL;
+  return m;
+}
+
+/// @brief Inverse of zmorton_spread (the Odd Bits are Ignored)
+[[nodiscard]] constexpr auto zmorton_compact(std::uint64_t i_code)
+    -> std::uint32_t {
+  auto m = i_code & 0x5555555555555555ULL;
+  m      = (m | (m >> 1)) & 0x3333333333333333ULL;
+  m      = (m | (m >> 2)) & 0x0f0f0f0f0f0f0f0fULL;
+  m      = (m | (m >> 4)) & 0x00ff00ff00ff00ffULL;
+  m      = (m | (m >> 8)) & 0x0000ffff0000ffffULL;
+  m      = (m | (m >> 16)) & 0x00000000ffffffffULL;
+  return static_cast<std::uint32_t>(m);
+}
+
+/// @brief  Two-Dimensional Morton (Z-Order) Code: x in the Even Bits
+/// @note   The four children of quadtree cell c are 4c to 4c + 3
+[[nodiscard]] constexpr auto zmorton(std::uint32_t i_x, std::uint32_t i_y)
+    -> std::uint64_t {
+  return zmorton_spread(i_x) | (zmorton_spread(i_y) << 1);
+}
+
+} // namespace zdetail
+
+/// @brief Query Result: Index into the Indexed Span and Squared Distance
+template <typename MeasureT> struct zneighbour {
+  std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+  MeasureT      distance_squared{std::numeric_limits<MeasureT>::max()};
+
+  [[nodiscard]] friend constexpr auto operator<(zneighbour const& a,
+                                                zneighbour const& b) -> bool {
+    return a.distance_squared < b.distance_squared;
+  }
+};
+
+// =============================================================================
+/// zcell_list
+// =============================================================================
+
+/// @class  zcell_list
+/// @brief  Uniform Binning of Locations into Cells no Narrower than a Width
+/// @tparam LocationT: zspatial location (zlocation, vlocation, std::array)
+/// @tparam DimensionN: number of coordinates (deduced where possible)
+/// @note   Members are stored in compressed sparse row form: the locations of
+///         cell c are member[start[c]] to member[start[c + 1]]
+template <zdetail::zspatial LocationT,
+          std::size_t      DimensionN = zdetail::zdimension_v<LocationT>>
+class zcell_list {
+public:
+  using location_type = LocationT;
+  using value_type    = zdetail::zcoordinate_t<LocationT>;
+  using size_type     = std::size_t;
+  using index_type    = std::uint32_t;
+  using bound_type    = std::array<value_type, DimensionN>;
+  using period_type   = std::array<bool, DimensionN>;
+
+  static constexpr size_type k_stencil = zdetail::zpower(3, DimensionN);
+
+public:
+  /// @brief Constructor
+  /// @param i_lower, i_upper: bounding box of the domain
+  /// @param i_width: minimum cell width (usually the interaction cutoff)
+  /// @param i_periodic: periodic boundaries per axis
+  zcell_list(bound_type const& i_lower, bound_type const& i_upper,
+             value_type const& i_width, period_type const& i_periodic = {})
+      : m_lower{i_lower}, m_periodic{i_periodic} {
+    assert(i_width > value_type{0});
+
+    m_cells = 1;
+    for (size_type d = 0; d < DimensionN; ++d) {
+      m_extent[d] = i_upper[d] - i_lower[d];
+      assert(m_extent[d] > value_type{0});
+
+      m_count[d]   = std::max<size_type>(
+          1, static_cast<size_type>(std::floor(m_extent[d] / i_width)));
+      m_inverse[d] = static_cast<value_type>(m_count[d]) / m_extent[d];
+      m_stride[d]  = m_cells;
+      m_cells     *= m_count[d];
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Bin Locations by Counting Sort (two passes, no reallocation)
+  auto build(std::span<LocationT const> i_location) -> void {
+    assert(i_location.size() < std::numeric_limits<index_type>::max());
+
+    m_start.assign(m_cells + 1, 0);
+    m_member.resize(i_location.size());
+    m_home.resize(i_location.size());
+
+    for (size_type i = 0; i < i_location.size(); ++i) {
+      m_home[i] = static_cast<index_type>(cell_of(i_location[i]));
+      ++m_start[m_home[i] + 1];
+    }
+
+    std::partial_sum(m_start.begin(), m_start.end(), m_start.begin());
+
+    std::vector<index_type> cursor(m_start.begin(), m_start.end() - 1);
+    for (size_type i = 0; i < i_location.size(); ++i)
+      m_member[cursor[m_home[i]]++] = static_cast<index_type>(i);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Cell Containing a Location (clamped or wrapped at the boundary)
+  [[nodiscard]] auto cell_of(LocationT const& i_location) const -> size_type {
+    size_type c{0};
+    for (size_type d = 0; d < DimensionN; ++d)
+      c += axis_cell(zdetail::zcoordinate(i_location, d), d) * m_stride[d];
+    return c;
+  }
+
+  /// @brief Cell of the i-th Location of the Last Build
+  [[nodiscard]] auto home(size_type i) const -> size_type { return m_home[i]; }
+
+  /// @brief Indices of the Locations Binned into a Cell
+  [[nodiscard]] auto cell(size_type i_cell) const
+      -> std::span<index_type const> {
+    return {m_member.data() + m_start[i_cell],
+            m_member.data() + m_start[i_cell + 1]};
+  }
+
+  /// @brief Visit each Distinct Cell of the 3^D Stencil around a Cell
+  /// @note  Duplicates (periodic axes with fewer than three cells) are removed
+  template <std::invocable<size_type> FunctionF>
+  auto for_each_adjacent(size_type i_cell, FunctionF&& i_function) const
+      -> void {
+    std::array<size_type, DimensionN> centre;
+    for (size_type d = 0; d < DimensionN; ++d)
+      centre[d] = (i_cell / m_stride[d]) % m_count[d];
+
+    std::array<size_type, k_stencil> adjacent;
+    size_type                        n{0};
+
+    for (size_type s = 0; s < k_stencil; ++s) {
+      size_type code{s}, c{0};
+      bool      inside{true};
+
+      for (size_type d = 0; d < DimensionN && inside; ++d, code /= 3) {
+        auto const count = static_cast<std::int64_t>(m_count[d]);
+        auto       k     = static_cast<std::int64_t>(centre[d]) +
+                 static_cast<std::int64_t>(code % 3) - 1;
+
+        if (k < 0 || k >= count) {
+          if (m_periodic[d])
+            k = (k + count) % count;
+          else
+            inside = false;
+        }
+        c += static_cast<size_type>(k) * m_stride[d];
+      }
+
+      if (inside)
+        adjacent[n++] = c;
+    }
+
+    std::sort(adjacent.begin(), adjacent.begin() + n);
+    auto const last = std::unique(adjacent.begin(), adjacent.begin() + n);
+
+    for (auto it = adjacent.begin(); it != last; ++it)
+      i_function(*it);
+  }
+
+  /// @brief Visit each Binned Index in the Stencil around a Location
+  template <std::invocable<index_type> FunctionF>
+  auto for_each_candidate(LocationT const& i_location,
+                          FunctionF&&      i_function) const -> void {
+    for_each_adjacent(cell_of(i_location), [&](size_type c) {
+      for (auto const j : cell(c))
+        i_function(j);
+    });
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Minimum-Image Separation b - a
+  [[nodiscard]] auto separation(LocationT const& a, LocationT const& b) const
+      -> bound_type {
+    bound_type s;
+    for (size_type d = 0; d < DimensionN; ++d) {
+      s[d] = zdetail::zcoordinate(b, d) - zdetail::zcoordinate(a, d);
+      if (m_periodic[d])
+        s[d] -= m_extent[d] * std::round(s[d] / m_extent[d]);
+    }
+    return s;
+  }
+
+  [[nodiscard]] auto distance_squared(LocationT const& a,
+                                      LocationT const& b) const -> value_type {
+    auto const s = separation(a, b);
+    return std::inner_product(s.begin(), s.end(), s.begin(), value_type{0});
+  }
+
+  // ---------------------------------------------------------------------------
+
+  [[nodiscard]] auto size() const noexcept -> size_type { return m_cells; }
+
+  [[nodiscard]] auto count() const noexcept
+      -> std::array<size_type, DimensionN> const& {
+    return m_count;
+  }
+
+  [[nodiscard]] auto extent() const noexcept -> bound_type const& {
+    return m_extent;
+  }
+
+  [[nodiscard]] auto periodic() const noexcept -> period_type const& {
+    return m_periodic;
+  }
+
+private:
+  [[nodiscard]] auto axis_cell(value_type x, size_type d) const -> size_type {
+    auto const count = static_cast<std::int64_t>(m_count[d]);
+    auto       k =
+        static_cast<std::int64_t>(std::floor((x - m_lower[d]) * m_inverse[d]));
+
+    if (m_periodic[d])
+      k = ((k % count) + count) % count;
+    else
+      k = std::clamp<std::int64_t>(k, 0, count - 1);
+
+    return static_cast<size_type>(k);
+  }
+
+private:
+  bound_type                        m_lower;
+  bound_type                        m_extent;
+  bound_type                        m_inverse;
+  period_type                       m_periodic;
+  std::array<size_type, DimensionN> m_count;
+  std::array<size_type, DimensionN> m_stride;
+  size_type                         m_cells{0};
+
+  std::vector<index_type>           m_start;
+  std::vector<index_type>           m_member;
+  std::vector<index_type>           m_home;
+};
+
+// =============================================================================
+/// zverlet_list
+// =============================================================================
+
+/// @brief Full lists hold j for every i; half lists hold each pair once (j > i)
+enum class zverlet_kind { full, half };
+
+/// @class  zverlet_list
+/// @brief  Verlet Neighbour List with Skin and Lazy Rebuild
+/// @tparam LocationT: zspatial location (zlocation, vlocation, std::array)
+/// @tparam DimensionN: number of coordinates (deduced where possible)
+/// @note   Every pair within cutoff + skin at the last build is listed, so the
+///         list stays valid for the cutoff until some location has moved by
+///         more than half the skin
+template <zdetail::zspatial LocationT,
+          std::size_t      DimensionN = zdetail::zdimension_v<LocationT>>
+class zverlet_list {
+public:
+  using cell_list_type = zcell_list<LocationT, DimensionN>;
+  using location_type  = LocationT;
+  using value_type     = typename cell_list_type::value_type;
+  using size_type      = typename cell_list_type::size_type;
+  using index_type     = typename cell_list_type::index_type;
+  using bound_type     = typename cell_list_type::bound_type;
+  using period_type    = typename cell_list_type::period_type;
+
+public:
+  /// @brief Constructor
+  /// @param i_lower, i_upper: bounding box of the domain
+  /// @param i_cutoff: interaction cutoff
+  /// @param i_skin: extra shell that absorbs motion between rebuilds
+  /// @param i_periodic: periodic boundaries per axis
+  /// @param i_kind: full or half list
+  zverlet_list(bound_type const& i_lower, bound_type const& i_upper,
+               value_type const& i_cutoff, value_type const& i_skin,
+               period_type const& i_periodic = {},
+               zverlet_kind       i_kind     = zverlet_kind::full)
+      : m_cell{i_lower, i_upper, i_cutoff + i_skin, i_periodic},
+        m_cutoff{i_cutoff}, m_skin{i_skin}, m_kind{i_kind} {
+    assert(i_cutoff > value_type{0} && i_skin >= value_type{0});
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Unconditional Rebuild (cell binning and neighbour search)
+  auto build(std::span<LocationT const> i_location) -> void {
+    m_cell.build(i_location);
+
+    auto const reach = (m_cutoff + m_skin) * (m_cutoff + m_skin);
+
+    m_offset.clear();
+    m_offset.reserve(i_location.size() + 1);
+    m_offset.push_back(0);
+    m_neighbour.clear();
+
+    for (size_type i = 0; i < i_location.size(); ++i) {
+      m_cell.for_each_adjacent(m_cell.home(i), [&](size_type c) {
+        for (auto const j : m_cell.cell(c)) {
+          if (j == i || (m_kind == zverlet_kind::half && j < i))
+            continue;
+          if (m_cell.distance_squared(i_location[i], i_location[j]) < reach)
+            m_neighbour.push_back(j);
+        }
+      });
+
+      /// @note ascending rows keep the gather over j monotone in memory
+      std::sort(m_neighbour.begin() + m_offset.back(), m_neighbour.end());
+      m_offset.push_back(m_neighbour.size());
+    }
+
+    m_reference.resize(i_location.size() * DimensionN);
+    for (size_type i = 0; i < i_location.size(); ++i)
+      for (size_type d = 0; d < DimensionN; ++d)
+        m_reference[i * DimensionN + d] =
+            zdetail::zcoordinate(i_location[i], d);
+
+    ++m_builds;
+  }
+
+  /// @brief Rebuild only if some Location has Moved more than Half the Skin
+  /// @return true if the list was rebuilt
+  auto update(std::span<LocationT const> i_location) -> bool {
+    if (i_location.size() * DimensionN != m_reference.size()) {
+      build(i_location);
+      return true;
+    }
+
+    auto const trigger = m_skin * m_skin / value_type{4};
+
+    for (size_type i = 0; i < i_location.size(); ++i) {
+      if (displacement_squared(i, i_location[i]) > trigger) {
+        build(i_location);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /// @brief Neighbours of the i-th Location within Cutoff + Skin
+  [[nodiscard]] auto neighbours(size_type i) const
+      -> std::span<index_type const> {
+    return {m_neighbour.data() + m_offset[i],
+            m_neighbour.data() + m_offset[i + 1]};
+  }
+
+  /// @brief Row Offsets (size + 1 entries)
+  [[nodiscard]] auto offsets() const noexcept -> std::span<size_type const> {
+    return m_offset;
+  }
+
+  /// @brief Column Indices (pairs() entries)
+  [[nodiscard]] auto indices() const noexcept -> std::span<index_type const> {
+    return m_neighbour;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> size_type {
+    return m_offset.empty() ? 0 : m_offset.size() - 1;
+  }
+
+  [[nodiscard]] auto pairs() const noexcept -> size_type {
+    return m_neighbour.size();
+  }
+
+  [[nodiscard]] auto builds() const noexcept -> size_type { return m_builds; }
+
+  [[nodiscard]] auto cutoff() const noexcept -> value_type { return m_cutoff; }
+
+  [[nodiscard]] auto skin() const noexcept -> value_type { return m_skin; }
+
+  [[nodiscard]] auto kind() const noexcept -> zverlet_kind { return m_kind; }
+
+  [[nodiscard]] auto cell_list() const noexcept -> cell_list_type const& {
+    return m_cell;
+  }
+
+private:
+  [[nodiscard]] auto displacement_squared(size_type        i,
+                                          LocationT const& i_location) const
+      -> value_type {
+    auto const& extent   = m_cell.extent();
+    auto const& periodic = m_cell.periodic();
+
+    value_type r2{0};
+    for (size_type d = 0; d < DimensionN; ++d) {
+      auto s = zdetail::zcoordinate(i_location, d) -
+               m_reference[i * DimensionN + d];
+      if (periodic[d])
+        s -= extent[d] * std::round(s / extent[d]);
+      r2 += s * s;
+    }
+    return r2;
+  }
+
+private:
+  cell_list_type          m_cell;
+  value_type              m_cutoff;
+  value_type              m_skin;
+  zverlet_kind            m_kind;
+
+  std::vector<size_type>  m_offset;
+  std::vector<index_type> m_neighbour;
+  std::vector<value_type> m_reference;
+  size_type               m_builds{0};
+};
+
+// =============================================================================
+// =============================================================================
+Z_MICROSTRUCTURE_Z_SPATIAL_NAMESPACE(END)
+// =============================================================================
+// =============================================================================
+
+#endif // !__Z_MICROSTRUCTURE_Z_SPATIAL_HPP__
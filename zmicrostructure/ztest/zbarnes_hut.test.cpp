@@ -0,0 +1,164 @@
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include <zmicrostructure/zbarnes_hut.hpp>
+#include <zmicrostructure/zdislocation.hpp>
+
+/// @note pollution for convenience
+using namespace zmicrostructure;
+
+using point   = std::array<double, 2>;
+using complex = std::complex<double>;
+
+/// @brief Direct Sums, Coincident Defects Omitted as by the Tree
+auto zdirect(std::vector<point> const& location,
+             std::vector<complex> const& charge, std::vector<complex>& field,
+             std::vector<complex>& gradient) -> void {
+  auto const n = location.size();
+  field.assign(n, {});
+  gradient.assign(n, {});
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j) {
+      auto const d = complex{location[i][0] - location[j][0],
+                             location[i][1] - location[j][1]};
+      if (d != complex{}) {
+        field[i] += charge[j] / d;
+        gradient[i] -= charge[j] / (d * d);
+      }
+    }
+}
+
+auto zerror(std::vector<complex> const& a, std::vector<complex> const& b)
+    -> double {
+  double error{0.}, scale{0.};
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    error = std::max(error, std::abs(a[i] - b[i]));
+    scale = std::max(scale, std::abs(b[i]));
+  }
+  return error / scale;
+}
+
+auto ztest_sort() -> void {
+  std::mt19937                                engine{21};
+  std::uniform_int_distribution<std::uint64_t> uniform{0, 1000};
+
+  for (std::size_t const n : {0, 1, 7, 1000, 4099})
+    for (std::size_t threads = 1; threads <= 7; ++threads) {
+      std::vector<std::uint64_t> key(n);
+      for (auto& k : key)
+        k = uniform(engine);
+      auto expected = key;
+      std::sort(expected.begin(), expected.end());
+      zdetail::zparallel_sort(key.begin(), key.end(), threads);
+      assert(key == expected);
+    }
+}
+
+auto ztest_tree() -> void {
+  std::mt19937                           engine{22};
+  std::uniform_real_distribution<double> uniform{0., 1.};
+  std::normal_distribution<double>       normal{0., .02};
+
+  // a uniform background, a tight cluster and a stack of coincident defects
+  std::vector<point>   location(3000);
+  std::vector<complex> charge(location.size());
+  for (std::size_t i = 0; i < location.size(); ++i) {
+    location[i] = i % 4 == 0   ? point{.6 + normal(engine), .2 + normal(engine)}
+                  : i % 50 == 1 ? point{.25, .75}
+                                : point{uniform(engine), uniform(engine)};
+    charge[i]   = {uniform(engine) - .5, uniform(engine) - .5};
+  }
+  std::vector<complex> field, gradient;
+  zdirect(location, charge, field, gradient);
+
+  // leaves partition the defects; quadrants are at most a quarter in size
+  zbarnes_hut tree{.5, 6, 16};
+  tree.build(std::span<point const>{location}, 3);
+  assert(tree.size() == location.size());
+  std::size_t covered{0};
+  for (auto const& cell : tree.nodes()) {
+    if (cell.children == 0)
+      covered += cell.end - cell.begin;
+    for (auto c = cell.child; c < cell.child + cell.children; ++c) {
+      auto const& child = tree.nodes()[c];
+      assert(child.level == cell.level + 1 && child.width == .5 * cell.width);
+      assert(child.begin >= cell.begin && child.end <= cell.end);
+    }
+  }
+  assert(covered == location.size());
+
+  // the error falls with the opening angle; angle zero is direct summation
+  double previous{1.};
+  for (double const angle : {.9, .6, .4, .2}) {
+    tree.angle(angle);
+    std::vector<complex> f(location.size()), g(location.size());
+    tree.evaluate(charge, f, g, 4);
+    auto const error = std::max(zerror(f, field), zerror(g, gradient));
+    assert(error < previous);
+    previous = error;
+  }
+  assert(previous < 1e-5);
+
+  tree.angle(0.);
+  std::vector<complex> f(location.size()), g(location.size());
+  tree.evaluate(charge, f, g);
+  assert(zerror(f, field) < 1e-13 && zerror(g, gradient) < 1e-13);
+
+  // a rebuild with any thread count gives the same tree and the same sums
+  tree.angle(.5);
+  tree.evaluate(charge, f, {}, 2);
+  zbarnes_hut serial{.5, 6, 16};
+  serial.build(std::span<point const>{location}, 1);
+  assert(serial.nodes().size() == tree.nodes().size());
+  std::vector<complex> h(location.size());
+  serial.evaluate(charge, h, {}, 1);
+  assert(h == f);
+}
+
+auto ztest_interaction() -> void {
+  std::mt19937                           engine{23};
+  std::uniform_real_distribution<double> uniform{-1., 1.};
+  zisotropic const                       medium{1., .34};
+
+  std::vector<point>                 line(2500);
+  std::vector<std::array<double, 2>> burgers(line.size());
+  for (std::size_t j = 0; j < line.size(); ++j) {
+    line[j]    = {uniform(engine), uniform(engine)};
+    burgers[j] = {j % 2 == 0 ? 1. : -1., 0.};
+  }
+  auto const n = line.size();
+
+  // edge stress through the tree agrees with the direct kernel
+  zbarnes_hut tree{.3, 12};
+  tree.build(std::span<point const>{line});
+  std::vector<double> xx(n), yy(n), xy(n), zz(n);
+  std::vector<double> dxx(n), dyy(n), dxy(n), dzz(n);
+  zedge_field(tree, std::span<std::array<double, 2> const>{burgers},
+              zedge_stress{xx, yy, xy, zz}, medium);
+  zedge_field(std::span<point const>{line},
+              std::span<std::array<double, 2> const>{burgers},
+              std::span<point const>{line}, zedge_stress{dxx, dyy, dxy, dzz},
+              medium);
+
+  double error{0.}, scale{0.};
+  for (std::size_t i = 0; i < n; ++i) {
+    error = std::max({error, std::abs(xx[i] - dxx[i]), std::abs(yy[i] - dyy[i]),
+                      std::abs(xy[i] - dxy[i])});
+    scale = std::max({scale, std::abs(dxx[i]), std::abs(dyy[i]),
+                      std::abs(dxy[i])});
+  }
+  assert(error < 1e-6 * scale);
+}
+
+int main() {
+  ztest_sort();
+  ztest_tree();
+  ztest_interaction();
+  return 0;
+}
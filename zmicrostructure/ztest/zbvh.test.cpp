@@ -0,0 +1,112 @@
+#include <cassert>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <zmicrostructure/zbvh.hpp>
+
+/// @note pollution for convenience
+using namespace zmicrostructure;
+
+using point = std::array<double, 2>;
+
+auto ztest_planar() -> void {
+  std::mt19937                           engine{3};
+  std::uniform_real_distribution<double> uniform{0., 1.};
+  std::uniform_real_distribution<double> jitter{-.04, .04};
+
+  std::vector<std::pair<point, point>> segment(800);
+  for (auto& [a, b] : segment) {
+    a = {uniform(engine), uniform(engine)};
+    b = {a[0] + jitter(engine), a[1] + jitter(engine)};
+  }
+
+  zbvh<point> bvh;
+  bvh.build(segment);
+  assert(bvh.size() == segment.size());
+
+  // intersections agree with an all-pairs check
+  auto const crossing = [](auto const& s, auto const& t) {
+    auto const o = [](point const& a, point const& b, point const& c) {
+      return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+    };
+    return o(s.first, s.second, t.first) * o(s.first, s.second, t.second) <
+               0. &&
+           o(t.first, t.second, s.first) * o(t.first, t.second, s.second) < 0.;
+  };
+
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> scan;
+  for (std::uint32_t i = 0; i < segment.size(); ++i)
+    for (std::uint32_t j = i + 1; j < segment.size(); ++j)
+      if (crossing(segment[i], segment[j]))
+        scan.emplace_back(i, j);
+
+  assert(!scan.empty());
+  assert(bvh.intersections(0., 4) == scan);
+
+  // nearest segment and ray casting agree with linear scans
+  auto const distance_squared = [](point const& q, auto const& s) {
+    auto const ab = point{s.second[0] - s.first[0], s.second[1] - s.first[1]};
+    auto const aq = point{q[0] - s.first[0], q[1] - s.first[1]};
+    auto const t  = std::clamp(
+        (aq[0] * ab[0] + aq[1] * ab[1]) / (ab[0] * ab[0] + ab[1] * ab[1]), 0.,
+        1.);
+    auto const ex = aq[0] - t * ab[0], ey = aq[1] - t * ab[1];
+    return ex * ex + ey * ey;
+  };
+
+  for (int k = 0; k < 200; ++k) {
+    point const q{uniform(engine), uniform(engine)};
+
+    double best = 1e300;
+    for (auto const& s : segment)
+      best = std::min(best, distance_squared(q, s));
+    assert(bvh.nearest(q).distance_squared == best);
+
+    point const direction{uniform(engine) - .5, uniform(engine) - .5};
+    auto const  hit = bvh.raycast(q, direction);
+
+    double first = 1e300;
+    for (auto const& s : segment) {
+      auto const e     = point{s.second[0] - s.first[0], s.second[1] - s.first[1]};
+      auto const w     = point{s.first[0] - q[0], s.first[1] - q[1]};
+      auto const cross = direction[0] * e[1] - direction[1] * e[0];
+      auto const t     = (w[0] * e[1] - w[1] * e[0]) / cross;
+      auto const u     = (w[0] * direction[1] - w[1] * direction[0]) / cross;
+      if (u >= 0. && u <= 1. && t >= 0.)
+        first = std::min(first, t);
+    }
+    assert(hit.valid() == (first < 1e300));
+    assert(!hit.valid() || hit.parameter == first);
+  }
+}
+
+auto ztest_polyline() -> void {
+  // two closed squares and a segment joining them at a shared vertex
+  std::vector<point> vertex{{0., 0.}, {1., 0.}, {1., 1.}, {0., 1.}, {0., 0.},
+                            {2., 0.}, {3., 0.}, {3., 1.}, {2., 1.}, {2., 0.},
+                            {1., 1.}, {2., 1.}};
+  std::vector<std::size_t> offset{0, 5, 10, 12};
+
+  zbvh<point> bvh;
+  bvh.build(vertex, offset);
+  assert(bvh.size() == 9);
+  assert(bvh.polyline(8) == 2);
+
+  // the joining segment touches one corner of each square (two edges each)
+  auto const junction = bvh.intersections();
+  assert(junction.size() == 4);
+  for (auto const& [i, j] : junction)
+    assert(j == 8 && i < 8);
+}
+
+auto ztest() -> int {
+  ztest_planar();
+  ztest_polyline();
+  return EXIT_SUCCESS;
+}
+
+int main() { return ztest(); }
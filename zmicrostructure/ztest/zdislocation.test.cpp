@@ -0,0 +1,180 @@
+#include <cassert>
+#include <cmath>
+
+#include <array>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include <zmicrostructure/zdislocation.hpp>
+
+/// @note pollution for convenience
+using namespace zmicrostructure;
+
+using point = std::array<double, 2>;
+
+/// @brief Textbook Edge Field (Hirth & Lothe) of One Line at the Origin
+auto zedge_reference(point const& p, std::array<double, 2> const& b,
+                     zisotropic const& medium) -> std::array<double, 4> {
+  auto const d = medium.shear_modulus /
+                 (2. * std::numbers::pi * (1. - medium.poisson_ratio));
+  auto const x = p[0], y = p[1], r4 = (x * x + y * y) * (x * x + y * y);
+  auto const xx = d * (-b[0] * y * (3. * x * x + y * y) +
+                       b[1] * x * (x * x - y * y)) / r4;
+  auto const yy = d * (b[0] * y * (x * x - y * y) +
+                       b[1] * x * (x * x + 3. * y * y)) / r4;
+  auto const xy = d * (b[0] * x * (x * x - y * y) +
+                       b[1] * y * (x * x - y * y)) / r4;
+  return {xx, yy, xy, medium.poisson_ratio * (xx + yy)};
+}
+
+auto zclose(double a, double b, double tolerance) -> bool {
+  return std::abs(a - b) <= tolerance * (1. + std::abs(b));
+}
+
+auto ztest_infinite() -> void {
+  std::mt19937                           engine{5};
+  std::uniform_real_distribution<double> uniform{-1., 1.};
+  zisotropic const                       medium{2., .25};
+
+  std::vector<point>                 line(37);
+  std::vector<std::array<double, 2>> burgers(line.size());
+  std::vector<double>                screw(line.size());
+  for (std::size_t j = 0; j < line.size(); ++j) {
+    line[j]    = {uniform(engine), uniform(engine)};
+    burgers[j] = {uniform(engine), uniform(engine)};
+    screw[j]   = uniform(engine);
+  }
+  std::vector<point> sample(1000);
+  for (auto& p : sample)
+    p = {3. * uniform(engine), 3. * uniform(engine)};
+  auto const n = sample.size();
+
+  // superposition of the textbook fields, one and four threads
+  std::vector<double> xx(n), yy(n), xy(n), zz(n), xz(n), yz(n);
+  zedge_field(std::span<point const>{line},
+              std::span<std::array<double, 2> const>{burgers},
+              std::span<point const>{sample}, zedge_stress{xx, yy, xy, zz},
+              medium, {}, 4);
+  zscrew_field(std::span<point const>{line},
+               std::span<double const>{screw},
+               std::span<point const>{sample}, zscrew_stress{xz, yz}, medium,
+               {}, 4);
+
+  auto const s = medium.shear_modulus / (2. * std::numbers::pi);
+  for (std::size_t i = 0; i < n; ++i) {
+    std::array<double, 4> edge{};
+    double                sxz{0.}, syz{0.};
+    for (std::size_t j = 0; j < line.size(); ++j) {
+      point const r{sample[i][0] - line[j][0], sample[i][1] - line[j][1]};
+      auto const  e = zedge_reference(r, burgers[j], medium);
+      for (std::size_t c = 0; c < 4; ++c)
+        edge[c] += e[c];
+      auto const r2 = r[0] * r[0] + r[1] * r[1];
+      sxz -= s * screw[j] * r[1] / r2;
+      syz += s * screw[j] * r[0] / r2;
+    }
+    assert(zclose(xx[i], edge[0], 1e-10) && zclose(yy[i], edge[1], 1e-10));
+    assert(zclose(xy[i], edge[2], 1e-10) && zclose(zz[i], edge[3], 1e-10));
+    assert(zclose(xz[i], sxz, 1e-10) && zclose(yz[i], syz, 1e-10));
+  }
+
+  // the thread count does not change a single bit
+  std::vector<double> serial(n), unused(n);
+  zedge_field(std::span<point const>{line},
+              std::span<std::array<double, 2> const>{burgers},
+              std::span<point const>{sample},
+              zedge_stress{serial, unused, unused, unused}, medium, {}, 1);
+  assert(serial == xx);
+
+  // a point on a line feels the others only
+  std::vector<double> on(1), off(1), zero(1);
+  std::vector<point>  alone{line[0]};
+  zedge_field(std::span<point const>{line},
+              std::span<std::array<double, 2> const>{burgers},
+              std::span<point const>{alone}, zedge_stress{on, zero, zero, zero},
+              medium);
+  zedge_field(std::span<point const>{line}.subspan(1),
+              std::span<std::array<double, 2> const>{burgers}.subspan(1),
+              std::span<point const>{alone},
+              zedge_stress{off, zero, zero, zero}, medium);
+  assert(zclose(on[0], off[0], 1e-12));
+}
+
+auto ztest_periodic() -> void {
+  zisotropic const                         medium{1., .3};
+  std::vector<point> const                 line{{.3, .2}, {.6, .7}};
+  std::vector<std::array<double, 2>> const burgers{{1., 0.}, {-1., 0.}};
+  std::vector<double> const                screw{1., -1.};
+  std::vector<point> const                 sample{{.7, .55}, {.05, .9}};
+  auto const                               n = sample.size();
+
+  std::vector<double> xx(n), yy(n), xy(n), zz(n), xz(n), yz(n);
+
+  // a single row: closed form against a long symmetric sum of images
+  zperiodic_cell const row{1., 0.};
+  zedge_field(std::span<point const>{line}.first(1),
+              std::span<std::array<double, 2> const>{burgers}.first(1),
+              std::span<point const>{sample}, zedge_stress{xx, yy, xy, zz},
+              medium, row);
+  for (std::size_t i = 0; i < n; ++i) {
+    std::array<double, 4> sum{};
+    for (int k = -200000; k <= 200000; ++k) {
+      point const r{sample[i][0] - line[0][0] - k, sample[i][1] - line[0][1]};
+      auto const  e = zedge_reference(r, burgers[0], medium);
+      for (std::size_t c = 0; c < 4; ++c)
+        sum[c] += e[c];
+    }
+    assert(zclose(xx[i], sum[0], 1e-5) && zclose(yy[i], sum[1], 1e-5));
+    assert(zclose(xy[i], sum[2], 1e-5));
+  }
+
+  // a doubly periodic dipole: shells converge exponentially
+  zperiodic_cell const cell{1., 1.3, 4}, wide{1., 1.3, 8};
+  zedge_field(std::span<point const>{line},
+              std::span<std::array<double, 2> const>{burgers},
+              std::span<point const>{sample}, zedge_stress{xx, yy, xy, zz},
+              medium, cell);
+  zscrew_field(std::span<point const>{line}, std::span<double const>{screw},
+               std::span<point const>{sample}, zscrew_stress{xz, yz}, medium,
+               wide);
+  std::vector<double> wxx(n), wyy(n), wxy(n), wzz(n);
+  zedge_field(std::span<point const>{line},
+              std::span<std::array<double, 2> const>{burgers},
+              std::span<point const>{sample}, zedge_stress{wxx, wyy, wxy, wzz},
+              medium, wide);
+  for (std::size_t i = 0; i < n; ++i)
+    assert(zclose(xx[i], wxx[i], 1e-9) && zclose(xy[i], wxy[i], 1e-9));
+
+  // translating a field point by a period leaves the field unchanged
+  std::vector<point> const shifted{{sample[0][0] + 3., sample[0][1] - 1.3},
+                                   {sample[1][0] - 1., sample[1][1] + 2.6}};
+  std::vector<double>      txz(n), tyz(n);
+  zscrew_field(std::span<point const>{line}, std::span<double const>{screw},
+               std::span<point const>{shifted}, zscrew_stress{txz, tyz},
+               medium, wide);
+  for (std::size_t i = 0; i < n; ++i)
+    assert(zclose(txz[i], xz[i], 1e-9) && zclose(tyz[i], yz[i], 1e-9));
+
+  // equilibrium: d xx / dx + d xy / dy = 0 and d xy / dx + d yy / dy = 0
+  auto const h = 1e-4;
+  for (auto const& p : sample) {
+    std::vector<point> const probe{{p[0] + h, p[1]},
+                                   {p[0] - h, p[1]},
+                                   {p[0], p[1] + h},
+                                   {p[0], p[1] - h}};
+    std::array<double, 4> pxx, pyy, pxy, pzz;
+    zedge_field(std::span<point const>{line},
+                std::span<std::array<double, 2> const>{burgers},
+                std::span<point const>{probe},
+                zedge_stress{pxx, pyy, pxy, pzz}, medium, cell);
+    assert(std::abs(pxx[0] - pxx[1] + pxy[2] - pxy[3]) / (2. * h) < 1e-5);
+    assert(std::abs(pxy[0] - pxy[1] + pyy[2] - pyy[3]) / (2. * h) < 1e-5);
+  }
+}
+
+int main() {
+  ztest_infinite();
+  ztest_periodic();
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include <cassert>
+#include <cmath>
+
+#include <array>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include <zmicrostructure/zdislocation.hpp>
+#include <zmicrostructure/zfmm.hpp>
+
+/// @note pollution for convenience
+using namespace zmicrostructure;
+
+using point   = std::array<double, 2>;
+using complex = std::complex<double>;
+
+/// @brief Direct Sums f = sum q / (z - z_j) and f' = -sum q / (z - z_j)^2
+auto zdirect(std::vector<point> const& location,
+             std::vector<complex> const& charge, std::vector<complex>& field,
+             std::vector<complex>& gradient) -> void {
+  auto const n = location.size();
+  field.assign(n, {});
+  gradient.assign(n, {});
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      if (j != i) {
+        auto const d = complex{location[i][0] - location[j][0],
+                               location[i][1] - location[j][1]};
+        field[i] += charge[j] / d;
+        gradient[i] -= charge[j] / (d * d);
+      }
+}
+
+/// @brief Largest Error Relative to the Largest Magnitude
+auto zerror(std::vector<complex> const& a, std::vector<complex> const& b)
+    -> double {
+  double error{0.}, scale{0.};
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    error = std::max(error, std::abs(a[i] - b[i]));
+    scale = std::max(scale, std::abs(b[i]));
+  }
+  return error / scale;
+}
+
+auto ztest_expansion() -> void {
+  std::mt19937                           engine{11};
+  std::uniform_real_distribution<double> uniform{0., 1.};
+  std::normal_distribution<double>       normal{0., .05};
+
+  // a uniform background plus a dense cluster (a pile-up)
+  std::vector<point>   location(3000);
+  std::vector<complex> charge(location.size());
+  for (std::size_t i = 0; i < location.size(); ++i) {
+    location[i] = i % 3 == 0 ? point{.3 + normal(engine), .7 + normal(engine)}
+                             : point{uniform(engine), 2. * uniform(engine)};
+    charge[i]   = {uniform(engine) - .5, uniform(engine) - .5};
+  }
+
+  std::vector<complex> field, gradient;
+  zdirect(location, charge, field, gradient);
+
+  double previous{1.};
+  for (std::size_t const order : {6, 12, 24, 36}) {
+    zfmm fmm{order, 8};
+    fmm.build(std::span<point const>{location});
+    assert(fmm.levels() >= 3 && fmm.size() == location.size());
+
+    std::vector<complex> f(location.size()), g(location.size());
+    fmm.evaluate(charge, f, g, 4);
+    auto const error = std::max(zerror(f, field), zerror(g, gradient));
+    assert(error < previous);
+    previous = error;
+
+    // the thread count does not change a single bit
+    std::vector<complex> serial(location.size());
+    fmm.evaluate(charge, serial, {}, 1);
+    assert(serial == f);
+  }
+  assert(previous < 1e-10);
+
+  // below two levels everything is near field, exact to rounding
+  std::vector<point> const   few(location.begin(), location.begin() + 40);
+  std::vector<complex> const q(charge.begin(), charge.begin() + 40);
+  zdirect(few, q, field, gradient);
+  zfmm fmm;
+  fmm.build(std::span<point const>{few});
+  std::vector<complex> f(few.size()), g(few.size());
+  fmm.evaluate(q, f, g);
+  assert(fmm.levels() < 2);
+  assert(zerror(f, field) < 1e-13 && zerror(g, gradient) < 1e-13);
+}
+
+auto ztest_interaction() -> void {
+  std::mt19937                           engine{12};
+  std::uniform_real_distribution<double> uniform{-1., 1.};
+  zisotropic const                       medium{1.5, .3};
+
+  std::vector<point>                 line(4000);
+  std::vector<std::array<double, 2>> burgers(line.size());
+  std::vector<double>                screw(line.size()), strength(line.size());
+  for (std::size_t j = 0; j < line.size(); ++j) {
+    line[j]     = {uniform(engine), uniform(engine)};
+    burgers[j]  = {uniform(engine), uniform(engine)};
+    screw[j]    = uniform(engine);
+    strength[j] = uniform(engine);
+  }
+  auto const n = line.size();
+
+  zfmm fmm{30, 16};
+  fmm.build(std::span<point const>{line});
+
+  // edge and screw stress at the lines agree with the direct kernels
+  std::vector<double> xx(n), yy(n), xy(n), zz(n), xz(n), yz(n);
+  std::vector<double> dxx(n), dyy(n), dxy(n), dzz(n), dxz(n), dyz(n);
+  zedge_field(fmm, std::span<std::array<double, 2> const>{burgers},
+              zedge_stress{xx, yy, xy, zz}, medium);
+  zedge_field(std::span<point const>{line},
+              std::span<std::array<double, 2> const>{burgers},
+              std::span<point const>{line}, zedge_stress{dxx, dyy, dxy, dzz},
+              medium);
+  zscrew_field(fmm, std::span<double const>{screw}, zscrew_stress{xz, yz},
+               medium);
+  zscrew_field(std::span<point const>{line}, std::span<double const>{screw},
+               std::span<point const>{line}, zscrew_stress{dxz, dyz}, medium);
+
+  auto const compare = [](std::vector<double> const& a,
+                          std::vector<double> const& b) {
+    double error{0.}, scale{0.};
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      error = std::max(error, std::abs(a[i] - b[i]));
+      scale = std::max(scale, std::abs(b[i]));
+    }
+    return error / scale;
+  };
+  assert(compare(xx, dxx) < 1e-8 && compare(yy, dyy) < 1e-8);
+  assert(compare(xy, dxy) < 1e-8 && compare(zz, dzz) < 1e-8);
+  assert(compare(xz, dxz) < 1e-8 && compare(yz, dyz) < 1e-8);
+
+  // centres of dilatation: sigma_rr = -sigma_tt = -2 mu C / r^2
+  zdilatation_field(fmm, std::span<double const>{strength},
+                    zedge_stress{xx, yy, xy, zz}, medium);
+  for (std::size_t i = 0; i < n; i += 97) {
+    double sxx{0.}, syy{0.}, sxy{0.};
+    for (std::size_t j = 0; j < n; ++j) {
+      if (j == i)
+        continue;
+      auto const dx = line[i][0] - line[j][0], dy = line[i][1] - line[j][1];
+      auto const r2 = dx * dx + dy * dy;
+      auto const c  = 2. * medium.shear_modulus * strength[j] / (r2 * r2);
+      sxx -= c * (dx * dx - dy * dy);
+      syy += c * (dx * dx - dy * dy);
+      sxy -= c * 2. * dx * dy;
+    }
+    auto const scale = std::abs(sxx) + std::abs(syy) + std::abs(sxy) + 1.;
+    assert(std::abs(xx[i] - sxx) < 1e-7 * scale);
+    assert(std::abs(yy[i] - syy) < 1e-7 * scale);
+    assert(std::abs(xy[i] - sxy) < 1e-7 * scale);
+    assert(zz[i] == 0.);
+  }
+}
+
+int main() {
+  ztest_expansion();
+  ztest_interaction();
+  return 0;
+}
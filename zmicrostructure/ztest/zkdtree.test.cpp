@@ -0,0 +1,91 @@
+#include <cassert>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <zmicrostructure/zkdtree.hpp>
+
+/// @note pollution for convenience
+using namespace zmicrostructure;
+
+using point = std::array<double, 3>;
+
+auto zscatter(std::size_t n, unsigned seed) -> std::vector<point> {
+  std::mt19937                           engine{seed};
+  std::uniform_real_distribution<double> uniform{0., 1.};
+
+  std::vector<point> location(n);
+  for (auto& l : location)
+    for (auto& x : l)
+      x = uniform(engine);
+  return location;
+}
+
+auto zdistance_squared(point const& a, point const& b) -> double {
+  return (a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) +
+         (a[2] - b[2]) * (a[2] - b[2]);
+}
+
+auto ztest() -> int {
+  auto const seed   = zscatter(5000, 1);
+  auto const sample = zscatter(500, 2);
+
+  zkdtree<point> tree{seed};
+  assert(tree.size() == seed.size());
+
+  // k nearest agree with a linear scan
+  constexpr std::size_t k = 5;
+  std::vector<zneighbour<double>> batch(sample.size() * k);
+  tree.nearest(std::span{sample}, std::span{batch}, k, 4);
+
+  for (std::size_t q = 0; q < sample.size(); ++q) {
+    std::vector<double> scan(seed.size());
+    for (std::size_t i = 0; i < seed.size(); ++i)
+      scan[i] = zdistance_squared(sample[q], seed[i]);
+    std::ranges::sort(scan);
+
+    for (std::size_t j = 0; j < k; ++j) {
+      auto const& found = batch[q * k + j];
+      assert(found.distance_squared == scan[j]);
+      assert(zdistance_squared(sample[q], seed[found.index]) == scan[j]);
+    }
+    assert(tree.nearest(sample[q]).distance_squared == scan[0]);
+  }
+
+  // batched radius agrees with single queries and a linear scan
+  std::vector<std::size_t>   offset;
+  std::vector<std::uint32_t> index;
+  tree.radius(std::span{sample}, .05, offset, index, 3);
+  assert(offset.size() == sample.size() + 1);
+
+  for (std::size_t q = 0; q < sample.size(); ++q) {
+    std::vector<std::uint32_t> scan;
+    for (std::size_t i = 0; i < seed.size(); ++i)
+      if (zdistance_squared(sample[q], seed[i]) <= .05 * .05)
+        scan.push_back(static_cast<std::uint32_t>(i));
+
+    assert(std::ranges::equal(
+        scan, std::span{index}.subspan(offset[q], offset[q + 1] - offset[q])));
+  }
+
+  // box
+  point const lower{.2, .3, .4}, upper{.4, .5, .9};
+  auto        inside = tree.box(lower, upper);
+  std::ranges::sort(inside);
+
+  std::vector<std::uint32_t> scan;
+  for (std::size_t i = 0; i < seed.size(); ++i) {
+    bool in{true};
+    for (std::size_t d = 0; d < 3; ++d)
+      in = in && seed[i][d] >= lower[d] && seed[i][d] <= upper[d];
+    if (in)
+      scan.push_back(static_cast<std::uint32_t>(i));
+  }
+  assert(inside == scan);
+
+  return EXIT_SUCCESS;
+}
+
+int main() { return ztest(); }
@@ -0,0 +1,99 @@
+#include <cassert>
+
+#include <array>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <zmicrostructure/zspatial.hpp>
+
+/// @note pollution for convenience
+using namespace zmicrostructure;
+
+template <std::size_t DimensionN>
+auto zscatter(std::size_t n, float extent, unsigned seed)
+    -> std::vector<std::array<float, DimensionN>> {
+  std::mt19937                          engine{seed};
+  std::uniform_real_distribution<float> uniform{0.f, extent};
+
+  std::vector<std::array<float, DimensionN>> location(n);
+  for (auto& l : location)
+    for (auto& x : l)
+      x = uniform(engine);
+  return location;
+}
+
+/// @brief every pair within the cutoff must be listed (brute-force reference)
+template <typename VerletT, typename LocationT>
+auto zcomplete(VerletT const& verlet, std::vector<LocationT> const& location)
+    -> bool {
+  auto const& cell = verlet.cell_list();
+  auto const  rc2  = verlet.cutoff() * verlet.cutoff();
+
+  for (std::size_t i = 0; i < location.size(); ++i) {
+    std::set<std::uint32_t> listed(verlet.neighbours(i).begin(),
+                                   verlet.neighbours(i).end());
+    for (std::size_t j = 0; j < location.size(); ++j) {
+      if (j == i || (verlet.kind() == zverlet_kind::half && j < i))
+        continue;
+      if (cell.distance_squared(location[i], location[j]) < rc2 &&
+          !listed.contains(static_cast<std::uint32_t>(j)))
+        return false;
+    }
+  }
+  return true;
+}
+
+auto ztest_periodic() -> void {
+  using point = std::array<float, 2>;
+
+  auto location = zscatter<2>(2000, 32.f, 42);
+
+  zverlet_list<point> verlet{{0.f, 0.f}, {32.f, 32.f}, 1.f, .3f, {true, true}};
+  verlet.build(location);
+
+  assert(verlet.size() == location.size());
+  assert(verlet.offsets().size() == location.size() + 1);
+  assert(zcomplete(verlet, location));
+
+  // small motion: the list is reused
+  for (auto& l : location)
+    l[0] += .1f;
+  assert(!verlet.update(location));
+  assert(verlet.builds() == 1);
+  assert(zcomplete(verlet, location));
+
+  // motion beyond half the skin: the list is rebuilt
+  location[7][1] += .2f;
+  assert(verlet.update(location));
+  assert(verlet.builds() == 2);
+  assert(zcomplete(verlet, location));
+}
+
+auto ztest_half() -> void {
+  using point   = std::array<double, 3>;
+
+  auto scatter  = zscatter<3>(1500, 10.f, 7);
+  auto location = std::vector<point>(scatter.size());
+  for (std::size_t i = 0; i < scatter.size(); ++i)
+    for (std::size_t d = 0; d < 3; ++d)
+      location[i][d] = scatter[i][d];
+
+  zverlet_list<point> full{{0., 0., 0.}, {10., 10., 10.}, .9, .1};
+  zverlet_list<point> half{{0., 0., 0.}, {10., 10., 10.}, .9, .1,
+                           {},           zverlet_kind::half};
+  full.build(location);
+  half.build(location);
+
+  assert(full.pairs() == 2 * half.pairs());
+  assert(zcomplete(full, location));
+  assert(zcomplete(half, location));
+}
+
+auto ztest() -> int {
+  ztest_periodic();
+  ztest_half();
+  return EXIT_SUCCESS;
+}
+
+int main() { return ztest(); }